@@ -4,7 +4,25 @@
 #include "task.h"
 #include "spi.h"
 #include "can.h"
+#include "config_store.h"
+#include "raw_stream.h"
+#include "flight_recorder.h"
+#include "gyro_pipeline.h"
+#include "xvlog.h"
+#include "cycle_bench.h"
+#include "sys_monitor.h"
+#include "trace.h"
+#include "deadline_monitor.h"
+#include "latency_hist.h"
+#include "power_mgr.h"
+#include "boot_seq.h"
+#include "angle_retain.h"
+#include "ramfunc.h"
+#include "rate_filter.h"
+#include "acq_sched.h"
+#include "gyro_fusion.h"
 #include "xv7001bb.h"
+#include "timestamp.h"
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
@@ -22,13 +40,13 @@ void vApplicationTickHook(void)
 /*============================================================================
  * 常量定义
  *============================================================================*/
-#define TASK_MAIN_PERIOD_MS         10      // 主任务周期 10ms
-#define TASK_MAIN_DT                0.01f   // 积分时间步长 (秒)
+#define TASK_MAIN_PERIOD_MS         10      // 主任务周期 10ms (与GYRO_PIPELINE_RATE_HZ一致)
 
-// 零偏校准参数
-#define GYRO_BIAS_SAMPLE_COUNT      200     // 校准采样数 (2秒@10ms)
-#define GYRO_STILL_THRESHOLD_DPS    0.5f    // 静止判断阈值 (°/s)
-#define GYRO_BIAS_EMA_ALPHA         0.01f   // 动态校准EMA系数
+// 任务栈大小 (字), 静态分配
+// 调整依据: 系统监视0x328页n的栈历史最小剩余, 缩减后剩余不低于SYS_MONITOR_STACK_WARN
+#define TASK_MAIN_STACK             512
+#define TASK_CAN_STACK              256     // CAN_TX与CAN_RX各一份
+#define TASK_LED_STACK              128
 
 // CAN发送条件
 #define ANGLE_CHANGE_THRESHOLD      0.01f   // 角度变化阈值 (°)
@@ -36,6 +54,38 @@ void vApplicationTickHook(void)
 #define TEMP_SEND_INTERVAL_MS       1000    // 温度发送间隔
 #define RATE_CHANGE_THRESHOLD       0.5f    // 角速度变化阈值 (°/s)
 #define RATE_SEND_INTERVAL_MS       100     // 角速度强制发送间隔
+#define HEALTH_SEND_INTERVAL_MS     1000    // CAN健康诊断发送间隔
+#define DEADLINE_SEND_INTERVAL_MS   1000    // 截止时间监视发送间隔
+#define POWER_SEND_INTERVAL_MS      1000    // 功耗管理状态发送间隔
+
+// 飞行记录仪
+#define RECORDER_SPIKE_DPS          50.0f   // 相邻采样角速度跳变触发阈值 (°/s)
+#define RECORDER_DUMP_BURST         2       // 每次发送任务循环最多导出帧数
+
+// 系统监视
+#define SYS_MONITOR_TX_BURST        2       // 每次发送任务循环最多发送页数
+
+// 事件跟踪
+#define TRACE_DUMP_BURST            4       // 每次发送任务循环最多导出帧数
+
+// 分段延迟直方图
+#define LATENCY_DUMP_BURST          2       // 每次发送任务循环最多导出帧数
+
+// 角速度输出滤波
+#define FILTER_REPORT_BURST         2       // 每次发送任务循环最多应答帧数
+
+// 多速率采集调度
+#define ACQ_REPORT_BURST            3       // 每次发送任务循环最多应答帧数 (每通道一帧)
+
+// 多陀螺仪融合
+#define FUSION_REPORT_BURST         2       // 每次发送任务循环最多应答帧数
+#define FAULT_REPORT_BURST          3       // 每次发送任务循环最多应答帧数 (每传感器3帧)
+#ifdef HOST_BUILD
+extern "C" uint8_t Xv7Model_FittedMask(void);
+#define GYRO_SENSORS_FITTED         Xv7Model_FittedMask()   // 仿真: 装配情况由设备模型给出
+#else
+#define GYRO_SENSORS_FITTED         GYRO_FUSION_SENSOR_MASK
+#endif
 
 /*============================================================================
  * 调试变量 (放在extern "C"块内，确保调试器可见)
@@ -55,14 +105,50 @@ volatile float g_gyro_dps = 0.0f;
 volatile float g_temp_celsius = 25.0f;
 volatile float g_gyro_bias_dps = 0.0f;
 
+// 采样时刻 (DWT周期计数, 随遥测帧发送以计算数据龄)
+volatile uint32_t g_sample_cycles = 0;      // 最新角速度采样时刻
+volatile uint32_t g_temp_cycles = 0;        // 最新温度采样时刻
+volatile uint32_t g_integrate_cycles = 0;   // 最新角速度样本处理完成时刻
+
 // 命令标志
 volatile bool g_cmd_reset_angle = false;    // 角度清零命令
+volatile uint32_t g_cmd_reset_cycles = 0;   // 角度清零命令的接收时刻
 volatile bool g_cmd_calibrate = false;      // 重新校准命令
+volatile bool g_cmd_zero_cal = false;       // 硬件零点校准命令
+volatile bool g_cmd_set_bias = false;       // 设置软件零偏命令
+volatile float g_cmd_bias_dps = 0.0f;       // 设置软件零偏命令的参数
+volatile bool g_cmd_sensor_cfg = false;     // 传感器DSP/输出格式配置命令
+volatile bool g_cmd_sensor_query = false;   // 传感器配置查询命令
+XV7_Config g_cmd_sensor_cfg_value;          // 配置命令的参数 (置标志前写入)
+
+// 传感器配置应答 (Task_Main执行后置位, CAN发送任务发送)
+volatile bool g_sensor_cfg_reply = false;
+volatile uint8_t g_sensor_cfg_result = XV7_OK;
+XV7_Config g_sensor_cfg;                    // 回读的配置
+
+// 运行中自动波特率检测期间为true (检测过程读取接收FIFO, CAN接收任务暂停)
+volatile bool g_can_autobaud = false;
+
+#if CYCLE_BENCH
+char g_cycle_bench_json[CYCLE_BENCH_JSON_SIZE]; // 热路径基准测试结果 (JSON)
+#endif
 
 #ifdef __cplusplus
 }
 #endif
 
+/*============================================================================
+ * 任务静态内存 (不使用FreeRTOS堆, 链接后RAM占用即为全部占用)
+ *============================================================================*/
+static StackType_t s_stack_main[TASK_MAIN_STACK];
+static StackType_t s_stack_can_tx[TASK_CAN_STACK];
+static StackType_t s_stack_can_rx[TASK_CAN_STACK];
+static StackType_t s_stack_led[TASK_LED_STACK];
+static StaticTask_t s_tcb_main;
+static StaticTask_t s_tcb_can_tx;
+static StaticTask_t s_tcb_can_rx;
+static StaticTask_t s_tcb_led;
+
 // 系统时钟配置: 72MHz (HSE 8MHz × PLL 9)
 static void SystemClock_Config(void)
 {
@@ -125,70 +211,31 @@ static void Task_LED(void *argument)
 	}
 }
 
-/*============================================================================
- * 零偏校准函数
- * 在静止状态下采集数据计算零偏
- *============================================================================*/
-static bool CalibrateGyroBias(float *bias_out)
-{
-	float sum = 0.0f;
-	float last_dps = 0.0f;
-	int valid_count = 0;
-	XV7_GyroData gyroData;
-	
-	for (int i = 0; i < GYRO_BIAS_SAMPLE_COUNT; i++)
-	{
-		if (XV7001bb_ReadAngle(&gyroData) == XV7_OK)
-		{
-			// 检测是否静止 (与上次读数差值小于阈值)
-			if (i > 0 && fabsf(gyroData.dps - last_dps) > GYRO_STILL_THRESHOLD_DPS)
-			{
-				// 检测到运动，重新开始
-				sum = 0.0f;
-				valid_count = 0;
-				i = -1;  // 重新开始
-			}
-			else
-			{
-				sum += gyroData.dps;
-				valid_count++;
-			}
-			last_dps = gyroData.dps;
-		}
-		vTaskDelay(pdMS_TO_TICKS(TASK_MAIN_PERIOD_MS));
-	}
-	
-	if (valid_count > 0)
-	{
-		*bias_out = sum / valid_count;
-		return true;
-	}
-	return false;
-}
-
 /*============================================================================
  * 主任务 - 角度计算和零偏校准 (10ms周期)
+ * 算法在GyroPipeline中实现, 本任务负责读传感器、发布结果,
+ * 并将每周期的读数和生效的命令写入采集流 (供主机回放)
  *============================================================================*/
 static void Task_Main(void *argument)
 {
 	(void)argument;
 	
 	XV7_Status status;
-	XV7_StatusReg statusReg;
+	XV7_StatusReg statusReg = {0};
 	XV7_GyroData gyroData;
 	XV7_TempData tempData;
+	GyroPipeline pipe;
+	GyroPipeline_Sample sample;
+	uint8_t record[XVLOG_RECORD_SIZE];
 	
-	float angle = 0.0f;
-	float gyro_bias = 0.0f;
-	float last_dps = 0.0f;
-	
-	// 等待系统稳定
-	vTaskDelay(pdMS_TO_TICKS(100));
+	bool have_last_dps = false;
+	bool status_valid = false;          // 最近一次状态读取成功 (statusReg有效)
+	uint16_t temp_raw = 0;
 	
 	//--------------------------------------------------
-	// 1. 初始化XV7001BB
+	// 1. 等待XV7001BB就绪 (唤醒命令已在main中发出, 与CAN初始化并行)
 	//--------------------------------------------------
-	status = XV7001bb_Init();
+	status = BootSeq_WaitSensor();
 	if (status != XV7_OK)
 	{
 		g_sensor_ready = false;
@@ -196,102 +243,236 @@ static void Task_Main(void *argument)
 	}
 	g_sensor_ready = true;
 	
+#if CYCLE_BENCH
+	// 热路径基准测试 (结果见g_cycle_bench_json), 完成后正常运行
+	static CycleBench_Report benchReport;
+	CycleBench_RunAll(&benchReport, CYCLE_BENCH_RUNS);
+	CycleBench_FormatJson(&benchReport, g_cycle_bench_json, sizeof(g_cycle_bench_json));
+#endif
+	
 	//--------------------------------------------------
-	// 2. 零偏校准 (启动时静止2秒)
+	// 2. 零偏校准 (启动时静止2秒, 由主循环逐周期完成)
+	//    热复位且备份寄存器有有效检查点时直接恢复角度与零偏
 	//--------------------------------------------------
-	g_bias_ready = false;
-	if (CalibrateGyroBias(&gyro_bias))
+	GyroPipeline_Init(&pipe);
+	float retained_angle, retained_bias;
+	if (AngleRetain_Restore(&retained_angle, &retained_bias))
 	{
-		g_gyro_bias_dps = gyro_bias;
-		debug_gyro_bias = gyro_bias;
-		g_bias_ready = true;
+		GyroPipeline_Restore(&pipe, retained_angle, retained_bias);
 	}
+	g_bias_ready = false;
 	
 	//--------------------------------------------------
 	// 3. 主循环 - 角度积分计算 (10ms周期)
 	//--------------------------------------------------
 	TickType_t xLastWakeTime = xTaskGetTickCount();
+	DeadlineMonitor_Init(TASK_MAIN_PERIOD_MS);
 	
 	for (;;)
 	{
-		// 检查命令
+		TRACE_MARK(TRACE_MARK_MAIN_BEGIN, 0);
+		DeadlineMonitor_Begin(xLastWakeTime);
+		
+		// 采集开始: 先输出流水线状态, 回放从该状态继续
+		if (RawStream_TakeCaptureStart())
+		{
+			uint32_t state[GYRO_PIPELINE_STATE_WORDS];
+			GyroPipeline_SaveState(&pipe, state);
+			for (uint8_t i = 0; i < GYRO_PIPELINE_STATE_WORDS; i++)
+			{
+				XvLog_EncodeState(record, i, state[i]);
+				RawStream_PushRecord(record);
+			}
+		}
+		
+		// 检查命令 (在本周期采样之前生效, 回放时按相同顺序处理)
 		if (g_cmd_reset_angle)
 		{
-			angle = 0.0f;
+			// 以命令到达时刻为零点, 补偿命令排队期间转过的角度
+			uint32_t pending_us = Timestamp_CyclesToUs(Timestamp_Now() - g_cmd_reset_cycles);
+			if (pending_us > 0xFFFF)
+			{
+				pending_us = 0xFFFF;  // 与采集记录字段宽度一致
+			}
+			GyroPipeline_ResetAngle(&pipe, pending_us);
+			XvLog_EncodeCommand(record, 0x01, 0, (uint16_t)pending_us);
+			RawStream_PushRecord(record);
 			g_cmd_reset_angle = false;
 		}
+		if (g_cmd_set_bias)
+		{
+			float bias = g_cmd_bias_dps;
+			uint32_t bias_bits;
+			memcpy(&bias_bits, &bias, sizeof(float));
+			GyroPipeline_SetBias(&pipe, bias);
+			XvLog_EncodeCommand(record, 0x03, bias_bits, 0);
+			RawStream_PushRecord(record);
+			g_cmd_set_bias = false;
+		}
 		if (g_cmd_calibrate)
 		{
-			g_bias_ready = false;
-			if (CalibrateGyroBias(&gyro_bias))
+			GyroPipeline_StartCalibration(&pipe);
+			XvLog_EncodeCommand(record, 0x04, 0, 0);
+			RawStream_PushRecord(record);
+			g_cmd_calibrate = false;
+		}
+		
+		// 传感器待机/唤醒中: 不采样, 保持周期 (看门狗照常喂)
+		if (!PowerMgr_Step())
+		{
+			TRACE_MARK(TRACE_MARK_MAIN_END, 0);
+			DeadlineMonitor_End();
+			vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(TASK_MAIN_PERIOD_MS));
+			continue;
+		}
+		
+		// 硬件零点校准 (SPI只在本任务访问, 之后融合重新学习)
+		if (g_cmd_zero_cal)
+		{
+			GyroSensors_ZeroCalibrate();
+			g_cmd_zero_cal = false;
+		}
+		
+		// 传感器DSP/输出格式配置 (SPI只在本任务访问; 16-bit输出已换算为24-bit LSB, 流水线无需重新校准)
+		if (g_cmd_sensor_cfg || g_cmd_sensor_query)
+		{
+			XV7_Status result = XV7_OK;
+			XV7_Config cfg;
+			if (g_cmd_sensor_cfg)
 			{
-				g_gyro_bias_dps = gyro_bias;
-				debug_gyro_bias = gyro_bias;
-				g_bias_ready = true;
+				cfg = g_cmd_sensor_cfg_value;
+				result = GyroSensors_Configure(&cfg);
 			}
-			g_cmd_calibrate = false;
+			XV7_Status readback = XV7001bb_ReadConfig(GyroSensors_Device(0), &cfg);
+			taskENTER_CRITICAL();
+			g_sensor_cfg = cfg;
+			g_sensor_cfg_result = (uint8_t)((result != XV7_OK) ? result : readback);
+			taskEXIT_CRITICAL();
+			g_cmd_sensor_cfg = false;
+			g_cmd_sensor_query = false;
+			g_sensor_cfg_reply = true;
 		}
 		
-		// 读取状态
-		status = XV7001bb_ReadStatus(&statusReg);
-		if (status == XV7_OK)
+		// 读取传感器 (各传感器轮转读取并融合, 见gyro_fusion.h; 校准阶段只读角速度;
+		// 之后按采集调度表读取, 未读状态的周期沿用最近状态; 读数故障在本周期内有限重试)
+		GyroSensors_BeginCycle();
+		uint32_t sample_cycles = 0;
+		uint32_t temp_cycles = 0;
+		memset(&sample, 0, sizeof(sample));
+		if (GyroPipeline_WantsStatus(&pipe))
 		{
-			debug_status_raw = statusReg.raw;
+			uint8_t due = AcqSched_Next(!(status_valid && GyroPipeline_StatusReady(statusReg.raw)));
+			if (due & ACQ_DUE_STATUS)
+			{
+				status_valid = (GyroSensors_ReadStatus(&statusReg) == XV7_OK);
+			}
+			sample.status_ok = status_valid;
+			sample.status_raw = statusReg.raw;
 			
-			if (statusReg.proc_ok && statusReg.state == XV7_STATE_SLEEP_OUT)
+			if (sample.status_ok && GyroPipeline_StatusReady(statusReg.raw))
 			{
-				g_sensor_ready = true;
-				
-				// 读取角速度
-				if (XV7001bb_ReadAngle(&gyroData) == XV7_OK)
+				if (due & ACQ_DUE_RATE)
 				{
-					float raw_dps = gyroData.dps;
-					debug_gyro_dps = raw_dps;
-					
-					// 零偏校正
-					float corrected_dps = raw_dps - gyro_bias;
-					debug_corrected_dps = corrected_dps;
-					g_gyro_dps = corrected_dps;
-					
-					// 梯形积分法计算角度
-					if (g_bias_ready)
-					{
-						float avg_dps = (corrected_dps + last_dps) * 0.5f;
-						angle += avg_dps * TASK_MAIN_DT;
-					}
-					last_dps = corrected_dps;
-					
-					// 动态零偏校准 (静止时缓慢调整)
-					if (g_bias_ready && fabsf(corrected_dps) < GYRO_STILL_THRESHOLD_DPS)
-					{
-						gyro_bias += raw_dps * GYRO_BIAS_EMA_ALPHA;
-						g_gyro_bias_dps = gyro_bias;
-						debug_gyro_bias = gyro_bias;
-					}
+					sample.gyro_ok = (GyroSensors_ReadRate(&gyroData) == XV7_OK);
+					sample_cycles = Timestamp_Now();
 				}
-				
-				// 读取温度
-				if (XV7001bb_ReadTmp(&tempData) == XV7_OK)
+				if (due & ACQ_DUE_TEMP)
 				{
-					debug_temp_celsius = tempData.celsius;
-					g_temp_celsius = tempData.celsius;
+					sample.temp_ok = (GyroSensors_ReadTemp(&tempData) == XV7_OK);
+					temp_cycles = Timestamp_Now();
 				}
-				
-				// 更新全局角度
-				g_angle_deg = angle;
-				debug_angle_deg = angle;
 			}
-			else
+		}
+		else
+		{
+			sample.gyro_ok = (GyroSensors_ReadRate(&gyroData) == XV7_OK);
+		}
+		if (sample.gyro_ok)
+		{
+			sample.gyro_raw = gyroData.raw;
+		}
+		if (sample.temp_ok)
+		{
+			sample.temp_raw = tempData.raw;
+		}
+		
+		// 算法处理并写入采集流
+		float prev_dps = pipe.last_dps;
+		GyroPipeline_Step(&pipe, &sample);
+		uint32_t integrate_cycles = Timestamp_Now();
+		XvLog_EncodeSample(record, &sample);
+		RawStream_PushRecord(record);
+		
+		// 发布结果
+		if (sample.status_ok)
+		{
+			debug_status_raw = statusReg.raw;
+		}
+		
+		if (pipe.rate_valid)
+		{
+			debug_gyro_dps = pipe.raw_dps;
+			debug_corrected_dps = pipe.corrected_dps;
+			g_gyro_dps = RateFilter_Process(pipe.corrected_dps);   // 只滤波发布值, 积分使用未滤波角速度
+			
+			// 飞行记录仪 (角速度跳变时触发)
+			FlightRecorder_Record(gyroData.raw, temp_raw, statusReg.raw);
+			if (have_last_dps && fabsf(pipe.corrected_dps - prev_dps) > RECORDER_SPIKE_DPS)
+			{
+				FlightRecorder_Trigger(FR_TRIGGER_RATE_SPIKE);
+			}
+			have_last_dps = true;
+			g_sample_cycles = sample_cycles;
+			g_integrate_cycles = integrate_cycles;
+			if (sample_cycles != 0)
+			{
+				Latency_Record(LATENCY_CAPTURE_TO_INTEGRATE, integrate_cycles - sample_cycles);
+			}
+			
+			// 角度检查点 (备份寄存器, 热复位后恢复)
+			if (pipe.bias_ready)
 			{
-				g_sensor_ready = false;
+				AngleRetain_Checkpoint(pipe.angle, pipe.gyro_bias);
 			}
+			
+			// 原始采样流 (诊断模式, 不阻塞)
+			RawStream_Push(gyroData.raw);
 		}
-		else
+		
+		if (sample.temp_ok)
 		{
-			g_sensor_ready = false;
+			debug_temp_celsius = tempData.celsius;
+			g_temp_celsius = tempData.celsius;
+			g_temp_cycles = temp_cycles;
+			temp_raw = tempData.raw;
+		}
+		
+		g_gyro_bias_dps = pipe.gyro_bias;
+		debug_gyro_bias = pipe.gyro_bias;
+		g_bias_ready = pipe.bias_ready;
+		if (pipe.bias_ready)
+		{
+			BootSeq_Mark(BOOT_MARK_BIAS_READY);
+		}
+		
+		if (pipe.phase == GYRO_PHASE_RUNNING)
+		{
+			g_sensor_ready = pipe.sensor_ready;
+			if (pipe.sensor_ready)
+			{
+				// 更新全局角度
+				g_angle_deg = pipe.angle;
+				debug_angle_deg = pipe.angle;
+			}
+			else
+			{
+				FlightRecorder_Trigger(FR_TRIGGER_NOT_READY);
+			}
 		}
 		
 		// 精确10ms周期
+		TRACE_MARK(TRACE_MARK_MAIN_END, 0);
+		DeadlineMonitor_End();      // 按时完成才喂看门狗
 		vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(TASK_MAIN_PERIOD_MS));
 	}
 }
@@ -299,6 +480,26 @@ static void Task_Main(void *argument)
 /*============================================================================
  * CAN发送任务 - 发送角度、温度、角速度数据
  *============================================================================*/
+
+// 自动波特率检测: 检测到速率且与保存值不同 (或从未保存) 时写入Flash
+static void CanTx_AutoBaud(void)
+{
+	g_can_autobaud = true;
+	uint32_t detected = CAN_AutoDetectBitrate(CAN_AUTOBAUD_LISTEN_MS);
+	g_can_autobaud = false;
+	if (detected != 0)
+	{
+		BootSeq_SetFlags(BOOT_FLAG_AUTOBAUD);
+		if (detected != ConfigStore_Get()->can_bitrate || !ConfigStore_Stored())
+		{
+			// 擦写Flash期间禁止其他任务运行
+			vTaskSuspendAll();
+			ConfigStore_SetCanBitrate(detected);
+			xTaskResumeAll();
+		}
+	}
+}
+
 static void Task_Can_Tx(void *argument)
 {
 	(void)argument;
@@ -308,26 +509,180 @@ static void Task_Can_Tx(void *argument)
 	uint32_t last_angle_tick = 0;
 	uint32_t last_temp_tick = 0;
 	uint32_t last_rate_tick = 0;
+	uint32_t last_health_tick = 0;
+	uint32_t last_deadline_tick = 0;
+	uint32_t last_power_tick = 0;
+	uint32_t last_boot_tick = 0;
+	uint8_t last_boot_phase = 0xFF;
+	uint32_t last_autobaud_tick = 0;
 	uint8_t data[8];
+	CAN_Health health;
 	
-	vTaskDelay(pdMS_TO_TICKS(500));  // 等待传感器初始化
+	// 有保存的位速率时立即以该速率发送; 从未保存过 (首次上电) 才先检测总线速率
+	// (与传感器唤醒、零偏校准并行). 此后bus-off或持续发送错误时重新检测
+	if (!ConfigStore_Stored())
+	{
+		CanTx_AutoBaud();
+		last_autobaud_tick = HAL_GetTick();
+	}
+	BootSeq_Mark(BOOT_MARK_CAN_READY);
+	CAN_GetHealth(&health);
+	uint32_t autobaud_bus_off = health.bus_off_count;
+	uint32_t autobaud_tx_errors = health.tx_errors;
 	
 	for (;;)
 	{
 		uint32_t now = HAL_GetTick();
 		
-		if (g_sensor_ready && g_bias_ready)
+		// 启动状态 (CAN就绪后立即发送, 此后阶段变化或启动期间定时发送)
+		uint8_t boot_phase = BootSeq_Phase();
+		if (boot_phase != last_boot_phase ||
+		    (boot_phase != BOOT_PHASE_RUNNING && (now - last_boot_tick) >= BOOT_STATUS_INTERVAL_MS))
+		{
+			BootSeq_Encode(data);
+			CAN_TransmitWithId(CAN_ID_BOOT, data, 8);
+			AngleRetain_Encode(data);
+			CAN_TransmitWithId(CAN_ID_RETAIN, data, 8);
+			last_boot_phase = boot_phase;
+			last_boot_tick = now;
+		}
+		
+		// 总线健康维护 (bus-off恢复、负载统计)
+		CAN_Health_Update(now);
+		
+		// bus-off或错误被动下持续发送错误: 可能是总线速率与保存值不同, 重新检测 (限频)
+		CAN_GetHealth(&health);
+		if ((now - last_autobaud_tick) >= CAN_AUTOBAUD_RETRY_MS &&
+		    (health.bus_off_count != autobaud_bus_off ||
+		     (health.error_passive && (health.tx_errors - autobaud_tx_errors) >= CAN_AUTOBAUD_TX_ERRORS)))
+		{
+			CanTx_AutoBaud();
+			last_autobaud_tick = HAL_GetTick();
+			CAN_GetHealth(&health);
+			autobaud_bus_off = health.bus_off_count;
+			autobaud_tx_errors = health.tx_errors;
+		}
+		
+		// 发送CAN健康诊断 (与传感器状态无关)
+		if ((now - last_health_tick) >= HEALTH_SEND_INTERVAL_MS)
+		{
+			CAN_GetHealth(&health);
+			CAN_Health_Encode(&health, data);
+			CAN_TransmitWithId(CAN_ID_CAN_HEALTH, data, 8);
+			CAN_Health_Encode2(&health, data);
+			CAN_TransmitWithId(CAN_ID_CAN_HEALTH2, data, 8);
+			last_health_tick = now;
+		}
+		
+		// 发送控制循环截止时间统计
+		if ((now - last_deadline_tick) >= DEADLINE_SEND_INTERVAL_MS)
 		{
+			DeadlineMonitor_Encode(data);
+			CAN_TransmitWithId(CAN_ID_DEADLINE, data, 8);
+			last_deadline_tick = now;
+		}
+		
+		// 发送功耗管理状态
+		if ((now - last_power_tick) >= POWER_SEND_INTERVAL_MS)
+		{
+			PowerMgr_Encode(data);
+			CAN_TransmitWithId(CAN_ID_POWER, data, 8);
+			last_power_tick = now;
+		}
+		
+		// 原始采样流 (诊断模式)
+		RawStream_Drain(RAW_STREAM_TX_BURST);
+		
+		// 系统监视 (周期统计或收到查询命令后分页发送)
+		SysMonitor_Update(now);
+		for (int i = 0; i < SYS_MONITOR_TX_BURST && SysMonitor_NextFrame(data); i++)
+		{
+			CAN_TransmitWithId(CAN_ID_SYS_MONITOR, data, 8);
+		}
+		
+		// 事件跟踪导出 (冻结期间不记录, 导出帧本身不进入跟踪)
+		for (int i = 0; i < TRACE_DUMP_BURST && Trace_NextDumpFrame(data); i++)
+		{
+			CAN_TransmitWithId(CAN_ID_TRACE, data, 8);
+		}
+		
+		// 分段延迟直方图导出
+		for (int i = 0; i < LATENCY_DUMP_BURST && Latency_NextDumpFrame(data); i++)
+		{
+			CAN_TransmitWithId(CAN_ID_LATENCY, data, 8);
+		}
+		
+		// 角速度输出滤波配置应答
+		for (int i = 0; i < FILTER_REPORT_BURST && RateFilter_NextReportFrame(data); i++)
+		{
+			CAN_TransmitWithId(CAN_ID_FILTER, data, 8);
+		}
+		
+		// 采集调度应答
+		for (int i = 0; i < ACQ_REPORT_BURST && AcqSched_NextReportFrame(data); i++)
+		{
+			CAN_TransmitWithId(CAN_ID_ACQ_SCHED, data, 8);
+		}
+		
+		// 多陀螺仪状态应答 (状态变化时及查询时)
+		for (int i = 0; i < FUSION_REPORT_BURST && GyroSensors_NextReportFrame(data); i++)
+		{
+			CAN_TransmitWithId(CAN_ID_FUSION, data, 8);
+		}
+		
+		// 传感器故障计数应答
+		for (int i = 0; i < FAULT_REPORT_BURST && GyroSensors_NextFaultFrame(data); i++)
+		{
+			CAN_TransmitWithId(CAN_ID_SENSOR_FAULT, data, 8);
+		}
+		
+		// 传感器配置应答: [0]=结果 [1-3]=DSP_CTL1~3 [4]=输出位数 (回读) [5]=解码位数
+		if (g_sensor_cfg_reply)
+		{
+			g_sensor_cfg_reply = false;
+			taskENTER_CRITICAL();
+			XV7_Config cfg = g_sensor_cfg;
+			data[0] = g_sensor_cfg_result;
+			taskEXIT_CRITICAL();
+			data[1] = cfg.dsp_ctl1;
+			data[2] = cfg.dsp_ctl2;
+			data[3] = cfg.dsp_ctl3;
+			data[4] = cfg.rate_bits;
+			data[5] = XV7001bb_GetRateBits(GyroSensors_Device(0));
+			data[6] = 0;
+			data[7] = 0;
+			CAN_TransmitWithId(CAN_ID_SENSOR_CFG, data, 8);
+		}
+		
+		// 飞行记录仪导出 (最低优先级ID, 限速)
+		for (int i = 0; i < RECORDER_DUMP_BURST && FlightRecorder_NextDumpFrame(data); i++)
+		{
+			CAN_TransmitWithId(CAN_ID_RECORDER, data, 8);
+		}
+		
+		if (g_sensor_ready && g_bias_ready && PowerMgr_IsActive())
+		{
+			// 数据与采样时刻需成对读取 (Task_Main优先级更高, 可能中途更新)
+			taskENTER_CRITICAL();
 			float angle = g_angle_deg;
 			float temp = g_temp_celsius;
 			float rate = g_gyro_dps;
+			uint32_t sample_cycles = g_sample_cycles;
+			uint32_t temp_cycles = g_temp_cycles;
+			uint32_t integrate_cycles = g_integrate_cycles;
+			taskEXIT_CRITICAL();
 			
 			// 发送角度 (变化>0.01°或超过200ms)
 			if (fabsf(angle - last_angle) >= ANGLE_CHANGE_THRESHOLD ||
 			    (now - last_angle_tick) >= ANGLE_SEND_INTERVAL_MS)
 			{
 				memcpy(data, &angle, sizeof(float));
-				CAN_TransmitWithId(CAN_ID_ANGLE, data, 4);
+				if (integrate_cycles != 0)
+				{
+					Latency_Record(LATENCY_INTEGRATE_TO_PUBLISH, Timestamp_Now() - integrate_cycles);
+				}
+				CAN_TransmitStamped(CAN_ID_ANGLE, data, 4, sample_cycles, true);
+				BootSeq_Mark(BOOT_MARK_FIRST_FRAME);
 				last_angle = angle;
 				last_angle_tick = now;
 			}
@@ -336,7 +691,7 @@ static void Task_Can_Tx(void *argument)
 			if ((now - last_temp_tick) >= TEMP_SEND_INTERVAL_MS)
 			{
 				memcpy(data, &temp, sizeof(float));
-				CAN_TransmitWithId(CAN_ID_TEMP, data, 4);
+				CAN_TransmitStamped(CAN_ID_TEMP, data, 4, temp_cycles, false);
 				last_temp_tick = now;
 			}
 			
@@ -345,7 +700,7 @@ static void Task_Can_Tx(void *argument)
 			    (now - last_rate_tick) >= RATE_SEND_INTERVAL_MS)
 			{
 				memcpy(data, &rate, sizeof(float));
-				CAN_TransmitWithId(CAN_ID_GYRO_RATE, data, 4);
+				CAN_TransmitStamped(CAN_ID_GYRO_RATE, data, 4, sample_cycles, true);
 				last_rate = rate;
 				last_rate_tick = now;
 			}
@@ -365,16 +720,39 @@ static void Task_Can_Rx(void *argument)
 	CAN_RxHeaderTypeDef rxHeader;
 	uint8_t rxData[8];
 	
+	// 等待自动波特率检测完成 (检测期间FIFO由检测过程读取)
+	while (!BootSeq_Reached(BOOT_MARK_CAN_READY))
+	{
+		vTaskDelay(pdMS_TO_TICKS(5));
+	}
+	
 	// 启用CAN接收中断 (FIFO0)
 	HAL_CAN_ActivateNotification(&hcan, CAN_IT_RX_FIFO0_MSG_PENDING);
 	
 	for (;;)
 	{
+		// 运行中重新检测位速率期间不读FIFO (检测到的帧不作为命令处理)
+		if (g_can_autobaud)
+		{
+			vTaskDelay(pdMS_TO_TICKS(5));
+			continue;
+		}
+		
 		// 轮询检查是否有消息
 		if (HAL_CAN_GetRxFifoFillLevel(&hcan, CAN_RX_FIFO0) > 0)
 		{
-			if (HAL_CAN_GetRxMessage(&hcan, CAN_RX_FIFO0, &rxHeader, rxData) == HAL_OK)
+			if (CAN_Receive(&rxHeader, rxData) == HAL_OK)
 			{
+				// 命令接收时刻: TTCM下取硬件SOF时间戳, 否则取轮询读出时刻
+#if CAN_USE_TTCM
+				uint32_t rx_cycles = CAN_BusTimeToLocal((uint16_t)rxHeader.Timestamp);
+#else
+				uint32_t rx_cycles = Timestamp_Now();
+#endif
+
+				// 总线活动 (无活动超时自动待机, 待机中收到任意帧唤醒)
+				PowerMgr_NotifyActivity();
+				
 				// 解析命令
 				if (rxHeader.DLC >= 1)
 				{
@@ -384,11 +762,12 @@ static void Task_Can_Rx(void *argument)
 					{
 					case 0x01:  // 角度清零
 					case 0x7B:  // 角度清零 (兼容)
+						g_cmd_reset_cycles = rx_cycles;
 						g_cmd_reset_angle = true;
 						break;
 						
-					case 0x02:  // 硬件零点校准
-						XV7001bb_ZeroCalibrate();
+					case 0x02:  // 硬件零点校准 (全部传感器), 由Task_Main执行
+						g_cmd_zero_cal = true;
 						break;
 						
 					case 0x03:  // 设置软件零偏
@@ -396,14 +775,178 @@ static void Task_Can_Rx(void *argument)
 						{
 							float bias;
 							memcpy(&bias, &rxData[1], sizeof(float));
-							g_gyro_bias_dps = bias;
-							debug_gyro_bias = bias;
+							g_cmd_bias_dps = bias;
+							g_cmd_set_bias = true;
 						}
 						break;
 						
 					case 0x04:  // 重新校准
 						g_cmd_calibrate = true;
 						break;
+						
+					case 0x10:  // 设置CAN位速率并保存 (uint32小端)
+						if (rxHeader.DLC >= 5)
+						{
+							uint32_t bitrate;
+							memcpy(&bitrate, &rxData[1], sizeof(uint32_t));
+							// 重新初始化控制器与擦写Flash期间禁止其他任务访问CAN
+							vTaskSuspendAll();
+							if (CAN_SetBitrate(bitrate) == HAL_OK)
+							{
+								ConfigStore_SetCanBitrate(bitrate);
+							}
+							xTaskResumeAll();
+						}
+						break;
+						
+					case 0x20:  // 开始原始采样流 (uint16持续时间ms, 小端, 0=默认)
+					{
+						uint32_t duration_ms = 0;
+						if (rxHeader.DLC >= 3)
+						{
+							duration_ms = (uint32_t)rxData[1] | ((uint32_t)rxData[2] << 8);
+						}
+						RawStream_Start(duration_ms);
+						break;
+					}
+						
+					case 0x21:  // 停止原始采样流/采集流
+						RawStream_Stop();
+						break;
+						
+					case 0x22:  // 开始采集流 (uint16持续时间s, 小端, 0=直到0x21)
+					{
+						uint32_t duration_s = 0;
+						if (rxHeader.DLC >= 3)
+						{
+							duration_s = (uint32_t)rxData[1] | ((uint32_t)rxData[2] << 8);
+						}
+						RawStream_StartCapture(duration_s);
+						break;
+					}
+						
+					case 0x30:  // 飞行记录仪手动触发
+						FlightRecorder_Trigger(FR_TRIGGER_COMMAND);
+						break;
+						
+					case 0x31:  // 导出飞行记录 (冻结后有效)
+						FlightRecorder_StartDump();
+						break;
+						
+					case 0x32:  // 清空飞行记录并重新开始
+						FlightRecorder_Rearm();
+						break;
+						
+					case 0x40:  // 查询系统监视 (可选uint16周期ms, 小端, 0=仅查询时发送)
+						if (rxHeader.DLC >= 3)
+						{
+							SysMonitor_SetPeriod((uint32_t)rxData[1] | ((uint32_t)rxData[2] << 8));
+						}
+						SysMonitor_Request();
+						break;
+						
+					case 0x41:  // 事件跟踪 (0/省略=冻结并导出, 1=清空并重新记录)
+						if (rxHeader.DLC >= 2 && rxData[1] == 0x01)
+						{
+							Trace_Rearm();
+						}
+						else
+						{
+							Trace_StartDump();
+						}
+						break;
+						
+					case 0x42:  // 清除截止时间统计 (超时/丢周期计数与最长执行时间)
+						DeadlineMonitor_Clear();
+						break;
+						
+					case 0x43:  // 分段延迟直方图 (0/省略=导出, 1=清除)
+						if (rxHeader.DLC >= 2 && rxData[1] == 0x01)
+						{
+							Latency_Reset();
+						}
+						else
+						{
+							Latency_StartDump();
+						}
+						break;
+						
+					case 0x50:  // 功耗管理 (0=唤醒, 1=传感器待机, 2=传感器睡眠, 3=设置无活动待机时间)
+						if (rxHeader.DLC >= 2 && rxData[1] <= POWER_STATE_SLEEP)
+						{
+							PowerMgr_Request(rxData[1]);
+						}
+						else if (rxHeader.DLC >= 4 && rxData[1] == 0x03)
+						{
+							PowerMgr_SetInactivityTimeout((uint32_t)rxData[2] | ((uint32_t)rxData[3] << 8));
+						}
+						break;
+						
+					case 0x60:  // 角速度输出滤波 (0=全部关闭, 1=设计一节, 2=暂存系数, 3=启用暂存系数, 4=查询)
+						if (rxHeader.DLC >= 8 && rxData[1] == 0x01)
+						{
+							RateFilter_Configure(rxData[2], rxData[3],
+							                     (uint16_t)(rxData[4] | (rxData[5] << 8)),
+							                     (uint16_t)(rxData[6] | (rxData[7] << 8)));
+						}
+						else if (rxHeader.DLC >= 8 && rxData[1] == 0x02)
+						{
+							int32_t coef;
+							memcpy(&coef, &rxData[4], sizeof(int32_t));
+							RateFilter_StageCoef(rxData[2], rxData[3], coef);
+						}
+						else if (rxHeader.DLC >= 3 && rxData[1] == 0x03)
+						{
+							RateFilter_ApplyStaged(rxData[2]);
+						}
+						else if (rxHeader.DLC >= 2 && rxData[1] == 0x00)
+						{
+							RateFilter_Bypass();
+						}
+						// 写入暂存系数不应答, 其余命令 (含查询与格式错误) 应答当前配置
+						if (!(rxHeader.DLC >= 2 && rxData[1] == 0x02))
+						{
+							RateFilter_StartReport();
+						}
+						break;
+						
+					case 0x61:  // 传感器DSP/输出格式 (0=查询, 1=配置: DSP_CTL1~3, 输出位数16/24), 由Task_Main执行
+						if (rxHeader.DLC >= 6 && rxData[1] == 0x01)
+						{
+							g_cmd_sensor_cfg_value.dsp_ctl1 = rxData[2];
+							g_cmd_sensor_cfg_value.dsp_ctl2 = rxData[3];
+							g_cmd_sensor_cfg_value.dsp_ctl3 = rxData[4];
+							g_cmd_sensor_cfg_value.rate_bits = rxData[5];
+							g_cmd_sensor_cfg = true;
+						}
+						else
+						{
+							g_cmd_sensor_query = true;
+						}
+						break;
+						
+					case 0x62:  // 采集调度 (0=查询, 1=设置: 通道, 周期, 相位 (0xFF=自动)), 均应答全部通道
+						if (rxHeader.DLC >= 5 && rxData[1] == 0x01)
+						{
+							AcqSched_Set(rxData[2], rxData[3], rxData[4]);
+						}
+						AcqSched_StartReport();
+						break;
+						
+					case 0x63:  // 查询多陀螺仪状态
+						GyroSensors_StartReport();
+						break;
+						
+					case 0x64:  // 传感器故障计数 (0/省略=查询, 1=清零)
+						if (rxHeader.DLC >= 2 && rxData[1] == 0x01)
+						{
+							GyroSensors_ClearFaults();
+						}
+						else
+						{
+							GyroSensors_StartFaultReport();
+						}
+						break;
 					}
 				}
 			}
@@ -415,28 +958,64 @@ static void Task_Can_Rx(void *argument)
 
 int main(void)
 {
+	RamFunc_Init();                     // 复制SRAM常驻热路径, 须在调用任何RAMFUNC之前
 	HAL_Init();
+	AngleRetain_Init();                 // 读取复位原因, 须在清除复位标志之前
+	DeadlineMonitor_CheckResetCause();
 	SystemClock_Config();
+	Timestamp_Init();
+	BootSeq_Init();
 	LED_Init();
 	
-	// 初始化SPI2 (XV7001BB陀螺仪)
+	// 初始化SPI2 (XV7001BB陀螺仪), 立即向各传感器发送唤醒命令: 传感器唤醒与后续初始化并行,
+	// Task_Main查询就绪 (命令未生效时重发)
 	MX_SPI2_Init();
+	GyroSensors_Init(GYRO_SENSORS_FITTED);
+	GyroSensors_Wake();
+	
+	// 加载Flash中保存的参数 (CAN位速率等)
+	ConfigStore_Load();
 	
 	// 初始化CAN1
 	MX_CAN_Init();
-	CAN_Driver_Init();
+	CAN_Driver_Init();     // 自动波特率检测在CAN发送任务中进行
+
+	// 原始采样流队列
+	RawStream_Init();
+	
+	// 分段延迟直方图
+	Latency_Init();
+	
+	// 功耗管理
+	PowerMgr_Init();
+	
+	// 角速度输出滤波 (默认全部节关闭)
+	RateFilter_Init();
+	
+	// 多速率采集调度 (默认表)
+	AcqSched_Init();
 
 	// 创建LED状态指示任务
-	xTaskCreate(Task_LED, "LED", 128, NULL, tskIDLE_PRIORITY + 1, NULL);
+	TaskHandle_t task_led = xTaskCreateStatic(Task_LED, "LED", TASK_LED_STACK, NULL, tskIDLE_PRIORITY + 1,
+	                                          s_stack_led, &s_tcb_led);
 	
 	// 创建主任务 (角度计算, 10ms周期)
-	xTaskCreate(Task_Main, "Main", 512, NULL, tskIDLE_PRIORITY + 3, NULL);
+	TaskHandle_t task_main = xTaskCreateStatic(Task_Main, "Main", TASK_MAIN_STACK, NULL, tskIDLE_PRIORITY + 3,
+	                                           s_stack_main, &s_tcb_main);
 	
 	// 创建CAN发送任务
-	xTaskCreate(Task_Can_Tx, "CAN_TX", 256, NULL, tskIDLE_PRIORITY + 2, NULL);
+	TaskHandle_t task_can_tx = xTaskCreateStatic(Task_Can_Tx, "CAN_TX", TASK_CAN_STACK, NULL, tskIDLE_PRIORITY + 2,
+	                                             s_stack_can_tx, &s_tcb_can_tx);
 	
 	// 创建CAN接收任务
-	xTaskCreate(Task_Can_Rx, "CAN_RX", 256, NULL, tskIDLE_PRIORITY + 2, NULL);
+	TaskHandle_t task_can_rx = xTaskCreateStatic(Task_Can_Rx, "CAN_RX", TASK_CAN_STACK, NULL, tskIDLE_PRIORITY + 2,
+	                                             s_stack_can_rx, &s_tcb_can_rx);
+	
+	// 登记到系统监视 (登记顺序即诊断帧页号1~4, 页5为空闲任务)
+	SysMonitor_RegisterTask(task_main, TASK_MAIN_STACK);
+	SysMonitor_RegisterTask(task_can_tx, TASK_CAN_STACK);
+	SysMonitor_RegisterTask(task_can_rx, TASK_CAN_STACK);
+	SysMonitor_RegisterTask(task_led, TASK_LED_STACK);
 	
 	// 启动FreeRTOS调度器
 	vTaskStartScheduler();
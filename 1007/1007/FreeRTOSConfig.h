@@ -44,6 +44,16 @@
 #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
  #include <stdint.h>
  extern uint32_t SystemCoreClock;
+ /* 运行时间统计时基 (TIM2, sys_monitor.c) */
+ void SysMonitor_TimerInit(void);
+ uint32_t SysMonitor_TimerCount(void);
+ /* 任务切换跟踪 (trace.c) */
+ void Trace_TaskSwitchedIn(void *tcb);
+ void Trace_TaskSwitchedOut(void *tcb);
+ /* tickless睡眠钩子 (power_mgr.c) */
+ void PowerMgr_PreSleep(uint32_t *idle_ticks);
+ void PowerMgr_PostSleep(uint32_t expected_ticks);
+ void PowerMgr_StepTick(uint32_t ticks);
 #endif
 
 /*  CMSIS-RTOSv2 defines 56 levels of priorities. To be able to use them
@@ -57,23 +67,39 @@
 #define configUSE_IDLE_HOOK               0
 #define configUSE_TICK_HOOK               1
 #define configMAX_PRIORITIES              (7)
-#define configSUPPORT_STATIC_ALLOCATION   0
+#define configSUPPORT_STATIC_ALLOCATION   1
+#define configSUPPORT_DYNAMIC_ALLOCATION  0   /* 任务与队列全部静态分配, 不链接heap_x.c */
 #define configCPU_CLOCK_HZ                (SystemCoreClock)
 #define configTICK_RATE_HZ                ((TickType_t)1000)
 #define configMINIMAL_STACK_SIZE          ((uint16_t)128)
-#define configTOTAL_HEAP_SIZE             ((size_t)(15 * 1024))
 #define configMAX_TASK_NAME_LEN           (16)
 #define configUSE_TRACE_FACILITY          1
 #define configUSE_16_BIT_TICKS            0
 #define configIDLE_SHOULD_YIELD           1
 #define configUSE_MUTEXES                 1
 #define configQUEUE_REGISTRY_SIZE         8
-#define configCHECK_FOR_STACK_OVERFLOW    0
+#define configCHECK_FOR_STACK_OVERFLOW    2
 #define configUSE_RECURSIVE_MUTEXES       1
 #define configUSE_MALLOC_FAILED_HOOK      0
 #define configUSE_APPLICATION_TASK_TAG    0
 #define configUSE_COUNTING_SEMAPHORES     1
-#define configGENERATE_RUN_TIME_STATS     0
+#define configGENERATE_RUN_TIME_STATS     1
+
+/* Run time stats: TIM2 at 10x the tick rate (sys_monitor.c). */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()  SysMonitor_TimerInit()
+#define portGET_RUN_TIME_COUNTER_VALUE()          SysMonitor_TimerCount()
+
+/* Tickless idle: the idle task stops the tick and sleeps (WFI) until the next
+wake time; the hooks keep DWT and the HAL tick (uwTick) in step (power_mgr.c).
+vTaskStepTick reports the skipped ticks through traceINCREASE_TICK_COUNT. */
+#define configUSE_TICKLESS_IDLE                   1
+#define configPRE_SLEEP_PROCESSING(x)             PowerMgr_PreSleep(&(x))
+#define configPOST_SLEEP_PROCESSING(x)            PowerMgr_PostSleep(x)
+#define traceINCREASE_TICK_COUNT(x)               PowerMgr_StepTick(x)
+
+/* Trace hooks: task switches go to the event trace buffer (trace.c). */
+#define traceTASK_SWITCHED_IN()                   Trace_TaskSwitchedIn(pxCurrentTCB)
+#define traceTASK_SWITCHED_OUT()                  Trace_TaskSwitchedOut(pxCurrentTCB)
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES           0
@@ -92,9 +118,11 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelete            1
 #define INCLUDE_vTaskCleanUpResources  0
 #define INCLUDE_vTaskSuspend           1
-#define INCLUDE_vTaskDelayUntil        0
+#define INCLUDE_vTaskDelayUntil        1
 #define INCLUDE_vTaskDelay             1
 #define INCLUDE_xTaskGetSchedulerState 1
+#define INCLUDE_xTaskGetIdleTaskHandle 1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
 
 /*------------- CMSIS-RTOS V2 specific defines -----------*/
 /* When using CMSIS-RTOSv2 set configSUPPORT_STATIC_ALLOCATION to 1
@@ -0,0 +1,156 @@
+#include "acq_sched.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+typedef struct {
+    uint8_t period;
+    uint8_t phase;
+} AcqSched_Entry;
+
+static AcqSched_Entry s_table[ACQ_CH_COUNT];   /* 由Task_Can_Rx修改, Task_Main读取 */
+static uint32_t s_cycle;                        /* 仅由Task_Main访问 */
+static volatile uint32_t s_reads[ACQ_CH_COUNT]; /* Task_Main累计, 应答时读取 */
+static volatile uint8_t s_result;
+static volatile int s_report_channel = -1;     /* -1=未在应答 */
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+static uint8_t AcqSched_Gcd(uint8_t a, uint8_t b)
+{
+    while (b != 0)
+    {
+        uint8_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief 不与其他慢通道同周期的最小相位
+ * 通道A、B同周期当且仅当 phaseA ≡ phaseB (mod gcd(periodA, periodB))
+ */
+static uint8_t AcqSched_AutoPhase(uint8_t channel, uint8_t period)
+{
+    for (uint8_t phase = 0; phase < period; phase++)
+    {
+        bool clash = false;
+        for (uint8_t i = ACQ_CH_RATE + 1; i < ACQ_CH_COUNT && !clash; i++)
+        {
+            if (i == channel)
+            {
+                continue;
+            }
+            uint8_t g = AcqSched_Gcd(period, s_table[i].period);
+            clash = (phase % g) == (s_table[i].phase % g);
+        }
+        if (!clash)
+        {
+            return phase;
+        }
+    }
+    return 0;
+}
+
+/*============================================================================
+ * 公共函数
+ *============================================================================*/
+
+void AcqSched_Init(void)
+{
+    s_table[ACQ_CH_RATE].period = 1;
+    s_table[ACQ_CH_RATE].phase = 0;
+    s_table[ACQ_CH_STATUS].period = ACQ_STATUS_PERIOD;
+    s_table[ACQ_CH_STATUS].phase = ACQ_STATUS_PHASE;
+    s_table[ACQ_CH_TEMP].period = ACQ_TEMP_PERIOD;
+    s_table[ACQ_CH_TEMP].phase = ACQ_TEMP_PHASE;
+    s_cycle = 0;
+    memset((void *)s_reads, 0, sizeof(s_reads));
+    s_result = ACQ_OK;
+}
+
+uint8_t AcqSched_DueAt(uint32_t cycle)
+{
+    uint8_t due = 0;
+
+    for (uint8_t i = 0; i < ACQ_CH_COUNT; i++)
+    {
+        if (cycle % s_table[i].period == s_table[i].phase)
+        {
+            due |= (uint8_t)(1U << i);
+        }
+    }
+    return due;
+}
+
+uint8_t AcqSched_Next(bool force_status)
+{
+    uint8_t due = AcqSched_DueAt(s_cycle++);
+
+    if (force_status)
+    {
+        due |= ACQ_DUE_STATUS;
+    }
+    for (uint8_t i = 0; i < ACQ_CH_COUNT; i++)
+    {
+        if (due & (1U << i))
+        {
+            s_reads[i]++;
+        }
+    }
+    return due;
+}
+
+uint8_t AcqSched_Set(uint8_t channel, uint8_t period, uint8_t phase)
+{
+    uint8_t result = ACQ_ERR_PARAM;
+
+    if (channel < ACQ_CH_COUNT && period > 0 &&
+        (channel != ACQ_CH_RATE || period == 1) &&
+        (phase < period || phase == ACQ_PHASE_AUTO))
+    {
+        if (phase == ACQ_PHASE_AUTO)
+        {
+            phase = (channel == ACQ_CH_RATE) ? 0 : AcqSched_AutoPhase(channel, period);
+        }
+        taskENTER_CRITICAL();
+        s_table[channel].period = period;
+        s_table[channel].phase = phase;
+        taskEXIT_CRITICAL();
+        result = ACQ_OK;
+    }
+    s_result = result;
+    return result;
+}
+
+void AcqSched_StartReport(void)
+{
+    s_report_channel = 0;
+}
+
+bool AcqSched_NextReportFrame(uint8_t *data)
+{
+    int channel = s_report_channel;
+    uint32_t reads;
+
+    if (channel < 0)
+    {
+        return false;
+    }
+
+    reads = s_reads[channel];
+    data[0] = (uint8_t)channel;
+    data[1] = s_table[channel].period;
+    data[2] = s_table[channel].phase;
+    data[3] = s_result;
+    memcpy(&data[4], &reads, sizeof(uint32_t));
+
+    s_report_channel = (channel + 1 < ACQ_CH_COUNT) ? channel + 1 : -1;
+    return true;
+}
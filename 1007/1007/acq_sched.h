@@ -0,0 +1,93 @@
+#ifndef __ACQ_SCHED_H
+#define __ACQ_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================
+ * 多速率采集调度 (Task_Main每周期读哪些传感器通道)
+ *
+ * 每个通道有周期与相位 (单位: 主任务周期), 第n个采样周期读取满足
+ *   n % period == phase
+ * 的通道. 默认表:
+ *   角速度  每周期            (积分步长按GYRO_PIPELINE_RATE_HZ固定, 周期只能为1)
+ *   状态    10周期 (100ms), 相位5
+ *   温度    50周期 (500ms), 相位0  (CAN每1000ms发送一次温度)
+ * 状态与温度的相位错开, 同一周期最多读角速度 + 一个慢通道, 最坏周期耗时
+ * 从 状态+角速度+温度 降为 角速度+状态.
+ *
+ * 未读状态的周期沿用最近一次状态 (采集记录中即为该值, 回放结果不变);
+ * 最近状态不是正常工作时每周期读状态, 传感器恢复后立即继续积分.
+ * 零偏校准阶段只读角速度 (不经调度).
+ *
+ * 表可经CAN命令0x62在运行时修改 (Task_Can_Rx调用, 周期与相位在临界区内成对写入),
+ * 相位为ACQ_PHASE_AUTO时选择不与其他慢通道同周期的最小相位 (无解时取0).
+ *
+ * 配置经CAN_ID_ACQ_SCHED应答 (修改后及查询时, 每通道一帧):
+ *   [0]=通道 [1]=周期 [2]=相位 [3]=最近命令结果 [4-7]=累计读取次数 (uint32)
+ *============================================================================*/
+#define ACQ_CH_RATE             0
+#define ACQ_CH_STATUS           1
+#define ACQ_CH_TEMP             2
+#define ACQ_CH_COUNT            3
+
+#define ACQ_DUE_RATE            (1U << ACQ_CH_RATE)
+#define ACQ_DUE_STATUS          (1U << ACQ_CH_STATUS)
+#define ACQ_DUE_TEMP            (1U << ACQ_CH_TEMP)
+
+#define ACQ_PHASE_AUTO          0xFF    /* 自动选择相位 */
+
+/* 默认表 (主任务周期数) */
+#define ACQ_STATUS_PERIOD       10
+#define ACQ_STATUS_PHASE        5
+#define ACQ_TEMP_PERIOD         50
+#define ACQ_TEMP_PHASE          0
+
+/* 配置结果 */
+#define ACQ_OK                  0
+#define ACQ_ERR_PARAM           1       /* 通道/周期/相位超出范围, 或角速度周期不为1 */
+
+/**
+ * @brief 恢复默认表并清零计数
+ */
+void AcqSched_Init(void);
+
+/**
+ * @brief 进入下一个采样周期, 返回本周期应读取的通道 (ACQ_DUE_*) 并累计读取次数
+ * @param force_status true=最近状态不是正常工作, 本周期必须读状态
+ */
+uint8_t AcqSched_Next(bool force_status);
+
+/**
+ * @brief 第cycle个采样周期按当前表应读取的通道 (不改变状态, 基准测试用)
+ */
+uint8_t AcqSched_DueAt(uint32_t cycle);
+
+/**
+ * @brief 修改一个通道 (任意任务调用)
+ * @param period 1~255
+ * @param phase 小于period, 或ACQ_PHASE_AUTO
+ * @return ACQ_OK或ACQ_ERR_PARAM
+ */
+uint8_t AcqSched_Set(uint8_t channel, uint8_t period, uint8_t phase);
+
+/**
+ * @brief 开始发送配置应答
+ */
+void AcqSched_StartReport(void);
+
+/**
+ * @brief 取下一应答帧
+ * @return true=data有效
+ */
+bool AcqSched_NextReportFrame(uint8_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ACQ_SCHED_H */
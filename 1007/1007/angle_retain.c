@@ -0,0 +1,190 @@
+#include "angle_retain.h"
+#include "stm32f1xx_hal.h"
+#include "timestamp.h"
+#include <string.h>
+#include <math.h>
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+#define ANGLE_RETAIN_SLOT_REGS      5
+#define ANGLE_RETAIN_CRC_INIT       0xA5    /* 非零初值: 全零寄存器 (备份域复位后) 不构成有效槽 */
+
+static uint8_t s_result = ANGLE_RETAIN_COLD;
+static uint8_t s_reset_cause;
+static bool s_pending;                          /* 有待Task_Main取出的检查点 */
+static float s_angle;
+static float s_bias;
+static uint32_t s_gap_us;                      /* 0=尚未恢复积分 */
+
+/* 以下仅由Task_Main访问 */
+static uint8_t s_next_slot;
+static uint8_t s_seq;
+
+/* CRC-8 (多项式0x07) 半字节表 */
+static const uint8_t s_crc_table[16] = {
+    0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15,
+    0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+};
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+static uint8_t AngleRetain_Crc8(uint8_t crc, uint8_t byte)
+{
+    crc ^= byte;
+    crc = (uint8_t)(crc << 4) ^ s_crc_table[crc >> 4];
+    return (uint8_t)(crc << 4) ^ s_crc_table[crc >> 4];
+}
+
+/**
+ * @brief 槽的CRC (角度、零偏4个半字与序号, 共9字节)
+ */
+static uint8_t AngleRetain_SlotCrc(const uint16_t *words, uint8_t seq)
+{
+    uint8_t crc = ANGLE_RETAIN_CRC_INIT;
+
+    for (int i = 0; i < ANGLE_RETAIN_SLOT_REGS - 1; i++)
+    {
+        crc = AngleRetain_Crc8(crc, (uint8_t)words[i]);
+        crc = AngleRetain_Crc8(crc, (uint8_t)(words[i] >> 8));
+    }
+    return AngleRetain_Crc8(crc, seq);
+}
+
+/**
+ * @brief 槽的第一个寄存器 (BKP_DR1~DR10地址连续, 间隔4字节)
+ */
+static volatile uint32_t *AngleRetain_Slot(uint8_t slot)
+{
+    return &BKP->DR1 + slot * ANGLE_RETAIN_SLOT_REGS;
+}
+
+/**
+ * @brief 读取并校验一个槽
+ * @return true=有效
+ */
+static bool AngleRetain_ReadSlot(uint8_t slot, float *angle, float *bias, uint8_t *seq)
+{
+    volatile uint32_t *regs = AngleRetain_Slot(slot);
+    uint16_t words[ANGLE_RETAIN_SLOT_REGS];
+    uint32_t bits;
+
+    for (int i = 0; i < ANGLE_RETAIN_SLOT_REGS; i++)
+    {
+        words[i] = (uint16_t)regs[i];
+    }
+    *seq = (uint8_t)(words[4] >> 8);
+    if ((uint8_t)words[4] != AngleRetain_SlotCrc(words, *seq))
+    {
+        return false;
+    }
+
+    bits = (uint32_t)words[0] | ((uint32_t)words[1] << 16);
+    memcpy(angle, &bits, sizeof(float));
+    bits = (uint32_t)words[2] | ((uint32_t)words[3] << 16);
+    memcpy(bias, &bits, sizeof(float));
+    return isfinite(*angle) && isfinite(*bias);
+}
+
+/*============================================================================
+ * 公共函数
+ *============================================================================*/
+
+void AngleRetain_Init(void)
+{
+    float angle[2], bias[2];
+    uint8_t seq[2];
+    bool valid[2];
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    __HAL_RCC_BKP_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    s_reset_cause = (__HAL_RCC_GET_FLAG(RCC_FLAG_PORRST) ? ANGLE_RETAIN_RST_POR : 0) |
+                    (__HAL_RCC_GET_FLAG(RCC_FLAG_PINRST) ? ANGLE_RETAIN_RST_PIN : 0) |
+                    (__HAL_RCC_GET_FLAG(RCC_FLAG_SFTRST) ? ANGLE_RETAIN_RST_SOFTWARE : 0) |
+                    (__HAL_RCC_GET_FLAG(RCC_FLAG_IWDGRST) ? ANGLE_RETAIN_RST_IWDG : 0) |
+                    (__HAL_RCC_GET_FLAG(RCC_FLAG_WWDGRST) ? ANGLE_RETAIN_RST_WWDG : 0) |
+                    (__HAL_RCC_GET_FLAG(RCC_FLAG_LPWRRST) ? ANGLE_RETAIN_RST_LOW_POWER : 0);
+
+    valid[0] = AngleRetain_ReadSlot(0, &angle[0], &bias[0], &seq[0]);
+    valid[1] = AngleRetain_ReadSlot(1, &angle[1], &bias[1], &seq[1]);
+    if (!valid[0] && !valid[1])
+    {
+        return;
+    }
+
+    // 两槽都有效时取序号较新者 (序号回绕按差值判断); 丢弃时同样接续序号,
+    // 使新检查点总比旧槽新
+    uint8_t slot = (!valid[0] || (valid[1] && (int8_t)(seq[1] - seq[0]) > 0)) ? 1 : 0;
+    s_angle = angle[slot];
+    s_bias = bias[slot];
+    s_seq = seq[slot];
+    s_next_slot = slot ^ 1;
+
+    if ((s_reset_cause & ANGLE_RETAIN_RST_POR) && !ANGLE_RETAIN_ON_POR)
+    {
+        s_result = ANGLE_RETAIN_DISCARDED_POR;
+        return;
+    }
+
+    s_pending = true;
+    s_result = ANGLE_RETAIN_RESTORED;
+}
+
+bool AngleRetain_Restore(float *angle, float *bias)
+{
+    if (!s_pending)
+    {
+        return false;
+    }
+    *angle = s_angle;
+    *bias = s_bias;
+    s_pending = false;
+    return true;
+}
+
+void AngleRetain_Checkpoint(float angle, float bias)
+{
+    volatile uint32_t *regs = AngleRetain_Slot(s_next_slot);
+    uint16_t words[ANGLE_RETAIN_SLOT_REGS - 1];
+    uint32_t bits;
+
+    if (s_result == ANGLE_RETAIN_RESTORED && s_gap_us == 0)
+    {
+        // 时间戳自Timestamp_Init起 (CYCCNT清零)
+        s_gap_us = Timestamp_CyclesToUs(Timestamp_Now()) + ANGLE_RETAIN_PERIOD_MS * 1000U;
+    }
+
+    memcpy(&bits, &angle, sizeof(float));
+    words[0] = (uint16_t)bits;
+    words[1] = (uint16_t)(bits >> 16);
+    memcpy(&bits, &bias, sizeof(float));
+    words[2] = (uint16_t)bits;
+    words[3] = (uint16_t)(bits >> 16);
+    s_seq++;
+
+    regs[0] = words[0];
+    regs[1] = words[1];
+    regs[2] = words[2];
+    regs[3] = words[3];
+    regs[4] = ((uint32_t)s_seq << 8) | AngleRetain_SlotCrc(words, s_seq);
+    s_next_slot ^= 1;
+}
+
+void AngleRetain_Encode(uint8_t *data)
+{
+    uint32_t gap = s_gap_us / 100U;
+
+    if (gap > 0xFFFF)
+    {
+        gap = 0xFFFF;
+    }
+    data[0] = s_result;
+    data[1] = s_reset_cause;
+    data[2] = (uint8_t)(gap & 0xFF);
+    data[3] = (uint8_t)(gap >> 8);
+    memcpy(&data[4], &s_angle, sizeof(float));
+}
@@ -0,0 +1,76 @@
+#ifndef __ANGLE_RETAIN_H
+#define __ANGLE_RETAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================
+ * 角度保持 (备份寄存器检查点, 热复位后恢复角度与零偏)
+ *
+ * 看门狗/软件/复位引脚复位不清除备份域: Task_Main每次积分后把角度与零偏
+ * 写入BKP_DR1~DR10, 复位后直接恢复, 跳过2秒静止零偏校准.
+ *
+ * 两个槽交替写入, 每槽5个16位寄存器:
+ *   [0-1]=角度float [2-3]=零偏float (°/s) [4]=序号<<8 | CRC-8
+ * 序号与CRC最后写入, 写到一半时复位只使该槽无效, 另一槽仍为上一检查点.
+ * 每次检查点为5次寄存器写与9字节查表CRC, 约百余周期.
+ *
+ * 上电/掉电复位 (PORRST) 时备份域只有接VBAT电池才保持, 而断电时长未知,
+ * 默认丢弃检查点重新校准; ANGLE_RETAIN_ON_POR=1时同样恢复 (VBAT供电的掉电复位).
+ *
+ * 结果经CAN_ID_RETAIN随启动状态帧发送:
+ *   [0]=结果 [1]=复位原因 [2-3]=保持间隙 (0.1ms) [4-7]=检查点角度float (恢复或丢弃的)
+ * 保持间隙 = 检查点周期 (复位前最后一次检查点的最大滞后) + 启动到恢复后第一次
+ * 积分, 不含复位脉冲与HSE起振 (约1~2ms); 此间转过的角度未计入.
+ *============================================================================*/
+#ifndef ANGLE_RETAIN_ON_POR
+#define ANGLE_RETAIN_ON_POR         0       /* 1=上电复位后也恢复 (备份域由VBAT供电时) */
+#endif
+
+#define ANGLE_RETAIN_PERIOD_MS      10      /* 检查点周期 (每次积分, 与主任务周期一致) */
+
+/* 结果 */
+#define ANGLE_RETAIN_COLD           0       /* 无有效检查点, 重新校准 */
+#define ANGLE_RETAIN_RESTORED       1       /* 已恢复角度与零偏 */
+#define ANGLE_RETAIN_DISCARDED_POR  2       /* 上电复位, 丢弃检查点 */
+
+/* 复位原因 (RCC_CSR) */
+#define ANGLE_RETAIN_RST_POR        0x01
+#define ANGLE_RETAIN_RST_PIN        0x02
+#define ANGLE_RETAIN_RST_SOFTWARE   0x04
+#define ANGLE_RETAIN_RST_IWDG       0x08
+#define ANGLE_RETAIN_RST_WWDG       0x10
+#define ANGLE_RETAIN_RST_LOW_POWER  0x20
+
+/**
+ * @brief 使能备份域访问, 读取复位原因并查找有效检查点
+ * 须在DeadlineMonitor_CheckResetCause (清除复位标志) 之前调用
+ */
+void AngleRetain_Init(void);
+
+/**
+ * @brief 取出可恢复的检查点 (Task_Main初始化流水线后调用一次)
+ * @return true=angle/bias有效, 应跳过零偏校准
+ */
+bool AngleRetain_Restore(float *angle, float *bias);
+
+/**
+ * @brief 写入检查点 (Task_Main每次积分后调用)
+ * 恢复后的第一次调用同时记录保持间隙
+ */
+void AngleRetain_Checkpoint(float angle, float bias);
+
+/**
+ * @brief 打包8字节状态帧
+ */
+void AngleRetain_Encode(uint8_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ANGLE_RETAIN_H */
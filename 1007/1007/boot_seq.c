@@ -0,0 +1,121 @@
+#include "boot_seq.h"
+#include "gyro_fusion.h"
+#include "timestamp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+static uint32_t s_boot_cycles;                         /* 启动起点 */
+static volatile uint32_t s_mark_us[BOOT_MARK_COUNT];   /* 0=未到达 */
+static volatile uint8_t s_flags;
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+static void BootSeq_Put16(uint8_t *dst, uint32_t value)
+{
+    if (value > 0xFFFF)
+    {
+        value = 0xFFFF;
+    }
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief 时刻点 (ms, 向上取整, 未到达为0)
+ */
+static uint32_t BootSeq_MarkMs(uint8_t mark)
+{
+    return (s_mark_us[mark] + 999U) / 1000U;
+}
+
+/*============================================================================
+ * 公共函数
+ *============================================================================*/
+
+void BootSeq_Init(void)
+{
+    s_boot_cycles = Timestamp_Now();
+}
+
+void BootSeq_Mark(uint8_t mark)
+{
+    if (mark >= BOOT_MARK_COUNT || s_mark_us[mark] != 0)
+    {
+        return;
+    }
+
+    uint32_t us = Timestamp_CyclesToUs(Timestamp_Now() - s_boot_cycles);
+    s_mark_us[mark] = (us != 0) ? us : 1;
+}
+
+bool BootSeq_Reached(uint8_t mark)
+{
+    return mark < BOOT_MARK_COUNT && s_mark_us[mark] != 0;
+}
+
+void BootSeq_SetFlags(uint8_t flags)
+{
+    taskENTER_CRITICAL();
+    s_flags |= flags;
+    taskEXIT_CRITICAL();
+}
+
+uint8_t BootSeq_Phase(void)
+{
+    if (s_flags & BOOT_FLAG_SENSOR_TIMEOUT)
+    {
+        return BOOT_PHASE_SENSOR_FAIL;
+    }
+    if (BootSeq_Reached(BOOT_MARK_FIRST_FRAME))
+    {
+        return BOOT_PHASE_RUNNING;
+    }
+    if (BootSeq_Reached(BOOT_MARK_SENSOR_READY))
+    {
+        return BOOT_PHASE_CALIBRATING;
+    }
+    return BOOT_PHASE_STARTING;
+}
+
+XV7_Status BootSeq_WaitSensor(void)
+{
+    TickType_t start = xTaskGetTickCount();
+    uint32_t delay = XV7_READY_POLL_MIN_MS;
+
+    for (;;)
+    {
+        if (GyroSensors_PollReady() == XV7_OK)
+        {
+            BootSeq_Mark(BOOT_MARK_SENSOR_READY);
+            return XV7_OK;
+        }
+        if ((xTaskGetTickCount() - start) >= pdMS_TO_TICKS(XV7_READY_TIMEOUT_MS))
+        {
+            // 多传感器: 未就绪的标记为失效, 其余照常启动
+            if (GyroSensors_DropUnready() > 0)
+            {
+                BootSeq_SetFlags(BOOT_FLAG_SENSOR_DEGRADED);
+                BootSeq_Mark(BOOT_MARK_SENSOR_READY);
+                return XV7_OK;
+            }
+            BootSeq_SetFlags(BOOT_FLAG_SENSOR_TIMEOUT);
+            return XV7_ERR_TIMEOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(delay));
+        delay = (delay * 2 > XV7_READY_POLL_MAX_MS) ? XV7_READY_POLL_MAX_MS : delay * 2;
+    }
+}
+
+void BootSeq_Encode(uint8_t *data)
+{
+    data[0] = BootSeq_Phase();
+    data[1] = s_flags;
+    BootSeq_Put16(&data[2], BootSeq_MarkMs(BOOT_MARK_CAN_READY));
+    BootSeq_Put16(&data[4], BootSeq_MarkMs(BOOT_MARK_SENSOR_READY));
+    BootSeq_Put16(&data[6], BootSeq_MarkMs(BOOT_MARK_FIRST_FRAME));
+}
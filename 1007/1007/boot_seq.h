@@ -0,0 +1,92 @@
+#ifndef __BOOT_SEQ_H
+#define __BOOT_SEQ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "xv7001bb.h"
+
+/*============================================================================
+ * 启动时序 (并行初始化 + 启动耗时测量)
+ *
+ * 启动不再使用固定延时, 各部分并行进行:
+ *   main        SPI初始化后立即发送传感器唤醒命令, 随后初始化CAN控制器
+ *   Task_Can_Tx 自动波特率检测, 完成后立即发送启动状态帧
+ *   Task_Main   按退避间隔 (1,2,4,8,8...ms) 查询传感器就绪, 随后零偏校准
+ *   Task_Can_Rx 等待自动波特率检测完成后开始接收 (检测期间帧由检测过程读取)
+ *
+ * 时刻点 (ms, 自Timestamp_Init起, 即时钟配置完成后):
+ *   CAN_READY    自动波特率检测完成, 可以收发
+ *   SENSOR_READY 传感器唤醒就绪
+ *   BIAS_READY   零偏校准完成
+ *   FIRST_FRAME  第一个有效角度帧提交发送
+ *
+ * 启动状态经CAN_ID_BOOT发送: CAN就绪后立即发送, 之后阶段变化时及启动期间
+ * 每BOOT_STATUS_INTERVAL_MS发送, 进入RUNNING后发送最后一帧:
+ *   [0]=阶段 [1]=标志 [2-3]=CAN就绪 [4-5]=传感器就绪 [6-7]=第一个有效帧 (ms, 0=未到达)
+ *============================================================================*/
+#define BOOT_STATUS_INTERVAL_MS     100     /* 启动期间状态帧发送间隔 */
+
+/* 阶段 */
+#define BOOT_PHASE_STARTING         0       /* 传感器唤醒中 */
+#define BOOT_PHASE_CALIBRATING      1       /* 传感器就绪, 零偏校准中 */
+#define BOOT_PHASE_RUNNING          2       /* 已发送有效角度帧 */
+#define BOOT_PHASE_SENSOR_FAIL      3       /* 传感器唤醒超时, 停止 */
+
+/* 时刻点 */
+#define BOOT_MARK_CAN_READY         0
+#define BOOT_MARK_SENSOR_READY      1
+#define BOOT_MARK_BIAS_READY        2
+#define BOOT_MARK_FIRST_FRAME       3
+#define BOOT_MARK_COUNT             4
+
+/* 标志 */
+#define BOOT_FLAG_AUTOBAUD          0x01    /* 自动波特率检测到总线速率 */
+#define BOOT_FLAG_SENSOR_TIMEOUT    0x02    /* 传感器唤醒超时 */
+#define BOOT_FLAG_SENSOR_DEGRADED   0x04    /* 部分传感器唤醒超时, 已标记为失效 */
+
+/**
+ * @brief 记录启动起点 (Timestamp_Init之后立即调用)
+ */
+void BootSeq_Init(void);
+
+/**
+ * @brief 记录时刻点 (只记录第一次, 任意任务调用)
+ */
+void BootSeq_Mark(uint8_t mark);
+
+/**
+ * @brief 时刻点是否已到达
+ */
+bool BootSeq_Reached(uint8_t mark);
+
+/**
+ * @brief 置标志
+ */
+void BootSeq_SetFlags(uint8_t flags);
+
+/**
+ * @brief 当前阶段 (BOOT_PHASE_*)
+ */
+uint8_t BootSeq_Phase(void);
+
+/**
+ * @brief 等待传感器唤醒就绪 (Task_Main调用, 唤醒命令已在main中发出)
+ * 按退避间隔查询XV7_REG_STATUS, 查询间隔内阻塞 (vTaskDelay), 其他任务照常运行
+ * @return XV7_OK=就绪, XV7_ERR_TIMEOUT=XV7_READY_TIMEOUT_MS内未就绪
+ */
+XV7_Status BootSeq_WaitSensor(void);
+
+/**
+ * @brief 打包8字节启动状态帧
+ */
+void BootSeq_Encode(uint8_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOT_SEQ_H */
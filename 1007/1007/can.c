@@ -1,4 +1,10 @@
 #include "can.h"
+#include "config_store.h"
+#include "timestamp.h"
+#include "trace.h"
+#include "latency_hist.h"
+#include "ramfunc.h"
+#include <string.h>
 
 /* CAN句柄 */
 CAN_HandleTypeDef hcan;
@@ -7,25 +13,149 @@ CAN_HandleTypeDef hcan;
 static CAN_TxHeaderTypeDef TxHeader;
 static uint32_t TxMailbox;
 
+/* 当前位速率 (bps) */
+static uint32_t s_bitrate = CAN_DEFAULT_BITRATE;
+
+/* 自动波特率检测候选 (从高到低) */
+static const uint32_t s_autobaud_rates[] = { 1000000, 500000, 250000, 125000 };
+
+/* 8字节数据帧从SOF到发送完成(TXOK)的位数 (不含填充位) */
+#define CAN_FRAME_SOF_TO_TXOK_BITS  108
+
+/* 总线时间与本地DWT周期的对应关系 (在发送完成中断中更新; 重新配置控制器后第一帧发送完成前无效) */
+static volatile uint16_t s_anchor_bus_time = 0;
+static volatile uint32_t s_anchor_cycles = 0;
+static volatile bool s_anchor_valid = false;
+
+/* 遥测帧的提交时刻与采样时刻 (按邮箱号, 发送完成中断中计入延迟统计) */
+typedef struct {
+    uint32_t submit_cycles;
+    uint32_t sample_cycles;
+    bool capture;                                   /* sample_cycles为角速度读出时刻, 计入capture→ack */
+    bool valid;
+} CAN_TxStamp;
+
+static volatile CAN_TxStamp s_tx_stamp[3];
+static bool s_stamp_next = false;                   /* 下一次提交的是遥测帧 */
+static uint32_t s_stamp_sample_cycles;
+static bool s_stamp_capture;
+
+/* 总线健康统计 (中断与任务共同更新) */
+static volatile CAN_Health s_health;
+static volatile uint32_t s_window_bits = 0;         /* 当前统计窗口内的总线位数 */
+static volatile uint8_t s_tx_dlc[3];                /* 各发送邮箱中帧的数据长度 (提交时写入) */
+static uint32_t s_window_start_ms = 0;
+static uint32_t s_busoff_start_ms = 0;
+static bool s_busoff_active = false;
+
+/*
+ * 标准帧位数估算: 固定44位 + 数据 + 3位帧间隔,
+ * 填充位按最坏情况 (34+8*DLC-1)/4 的一半计
+ */
+#define CAN_FRAME_BITS(dlc)     (47U + 8U * (dlc) + (34U + 8U * (dlc) - 1U) / 8U)
+
+/**
+ * @brief 由APB1时钟、目标位速率和采样点计算bxCAN位时序
+ * @param pclk APB1时钟 (Hz)
+ * @param bitrate 目标位速率 (bps)
+ * @param sample_point 目标采样点 (‰, 如875表示87.5%)
+ * @param bt 输出位时序
+ * @return HAL_OK=找到可精确实现的位时序
+ * 
+ * 位时间 = 1(同步段) + BS1 + BS2 个TQ, TQ = Prescaler / pclk
+ * 约束: BS1 1~16, BS2 2~8 (留出SJW余量), Prescaler 1~1024, 总TQ 8~25
+ * 在所有精确整除的组合中选采样点误差最小者, 误差相同时优先TQ数多的 (分辨率高)
+ * 
+ * 例: 36MHz/500kbps -> Prescaler=4, 1+15+2=18TQ, 采样点88.9%
+ */
+HAL_StatusTypeDef CAN_CalcBitTiming(uint32_t pclk, uint32_t bitrate, uint16_t sample_point, CAN_BitTiming *bt)
+{
+    uint32_t best_err = 0xFFFFFFFFU;
+    
+    if (bitrate == 0 || bt == NULL)
+    {
+        return HAL_ERROR;
+    }
+    
+    for (uint32_t tq = 25; tq >= 8; tq--)
+    {
+        if (pclk % (bitrate * tq) != 0)
+        {
+            continue;                               /* 只接受精确位速率 */
+        }
+        
+        uint32_t prescaler = pclk / (bitrate * tq);
+        if (prescaler < 1 || prescaler > 1024)
+        {
+            continue;
+        }
+        
+        /* 采样点位于第 (1+BS1) 个TQ末尾, 四舍五入 */
+        uint32_t bs1 = (sample_point * tq + 500U) / 1000U - 1U;
+        if (bs1 > 16)
+        {
+            bs1 = 16;
+        }
+        uint32_t bs2 = tq - 1U - bs1;
+        if (bs2 < 2)
+        {
+            bs2 = 2;
+            bs1 = tq - 3U;
+        }
+        if (bs1 < 1 || bs1 > 16 || bs2 > 8)
+        {
+            continue;
+        }
+        
+        uint32_t sp = (1U + bs1) * 1000U / tq;
+        uint32_t err = (sp > sample_point) ? (sp - sample_point) : (sample_point - sp);
+        if (err < best_err)
+        {
+            best_err = err;
+            bt->prescaler = (uint16_t)prescaler;
+            bt->bs1 = (uint8_t)bs1;
+            bt->bs2 = (uint8_t)bs2;
+            bt->sjw = (uint8_t)((bs2 > 4) ? 4 : bs2);
+            bt->sample_point = (uint16_t)sp;
+        }
+    }
+    
+    return (best_err == 0xFFFFFFFFU) ? HAL_ERROR : HAL_OK;
+}
+
+/**
+ * @brief 按位速率和工作模式配置控制器 (不启动)
+ */
+static HAL_StatusTypeDef CAN_Configure(uint32_t bitrate, uint32_t mode)
+{
+    CAN_BitTiming bt;
+    
+    if (CAN_CalcBitTiming(HAL_RCC_GetPCLK1Freq(), bitrate, CAN_SAMPLE_POINT_PERMILLE, &bt) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    
+    hcan.Init.Prescaler = bt.prescaler;
+    hcan.Init.Mode = mode;
+    hcan.Init.SyncJumpWidth = (uint32_t)(bt.sjw - 1U) << CAN_BTR_SJW_Pos;
+    hcan.Init.TimeSeg1 = (uint32_t)(bt.bs1 - 1U) << CAN_BTR_TS1_Pos;
+    hcan.Init.TimeSeg2 = (uint32_t)(bt.bs2 - 1U) << CAN_BTR_TS2_Pos;
+    
+    if (HAL_CAN_Init(&hcan) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    
+    s_bitrate = bitrate;
+    s_anchor_valid = false;                         /* 位时间改变, 旧锚点不再适用 */
+    return HAL_OK;
+}
+
 /**
  * @brief CAN1 外设初始化
  * 
- * 配置参数 (根据项目参数手册):
- * - 波特率: 500 kbps
- * - 工作模式: 正常模式 (Normal Mode)
- * - 位时序:
- *   - Prescaler = 2
- *   - SyncJumpWidth = 1 TQ
- *   - TimeSeg1 = 5 TQ
- *   - TimeSeg2 = 2 TQ
- *   - 总共 = 1 + 5 + 2 = 8 TQ
- *   - 波特率 = 36MHz / (2 × 8) = 2.25 MHz ... 实际计算应为 36MHz/(2*9)=2MHz->不对
- *   - 正确: APB1=36MHz, Prescaler=4, TQ=8 -> 36/(4*9)=1Mbps ... 
- *   - 按手册: Prescaler=4, TS1=6, TS2=1, SJW=1 => 36/(4*(1+6+1))=36/32=1.125MHz 不对
- *   - 500kbps: 36MHz / 500kbps = 72 TQ total
- *   - Prescaler=4, 1+TS1+TS2=18 -> 不对
- *   - Prescaler=8, 1+TS1+TS2=9 -> 36/(8*9)=0.5MHz=500kbps ✓
- *   - 实际使用: Prescaler=8, TS1=6, TS2=1, SJW=1
+ * 位速率取自参数存储 (默认500kbps), 位时序由CAN_CalcBitTiming按
+ * APB1=36MHz和CAN_SAMPLE_POINT_PERMILLE计算
  */
 void MX_CAN_Init(void)
 {
@@ -50,21 +180,28 @@ void MX_CAN_Init(void)
     
     /* CAN配置 */
     hcan.Instance = CAN1;
-    hcan.Init.Prescaler = 8;                        /* 36MHz / 8 = 4.5MHz */
-    hcan.Init.Mode = CAN_MODE_LOOPBACK;             /* 环回模式 (测试用，无需外部硬件) */
-    /* 正式使用时改为 CAN_MODE_NORMAL */
-    hcan.Init.SyncJumpWidth = CAN_SJW_1TQ;          /* 1 TQ */
-    hcan.Init.TimeSeg1 = CAN_BS1_6TQ;               /* 6 TQ */
-    hcan.Init.TimeSeg2 = CAN_BS2_2TQ;               /* 2 TQ */
-    /* 波特率 = 36MHz / (8 * (1+6+2)) = 36MHz / 72 = 500kbps */
+#if CAN_USE_TTCM
+    hcan.Init.TimeTriggeredMode = ENABLE;           /* 硬件时间戳 */
+#else
     hcan.Init.TimeTriggeredMode = DISABLE;
-    hcan.Init.AutoBusOff = DISABLE;
+#endif
+    hcan.Init.AutoBusOff = ENABLE;                  /* 硬件自动退出bus-off (128×11个隐性位) */
     hcan.Init.AutoWakeUp = DISABLE;
     hcan.Init.AutoRetransmission = ENABLE;          /* 自动重传 */
     hcan.Init.ReceiveFifoLocked = DISABLE;
     hcan.Init.TransmitFifoPriority = DISABLE;
     
-    HAL_CAN_Init(&hcan);
+    /* 存储的位速率无法实现时回落默认值 */
+    if (CAN_Configure(ConfigStore_Get()->can_bitrate, CAN_OPERATING_MODE) != HAL_OK)
+    {
+        CAN_Configure(CAN_DEFAULT_BITRATE, CAN_OPERATING_MODE);
+    }
+    
+    /* 发送完成/错误中断 (优先级需低于configMAX_SYSCALL) */
+    HAL_NVIC_SetPriority(USB_HP_CAN1_TX_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(USB_HP_CAN1_TX_IRQn);
+    HAL_NVIC_SetPriority(CAN1_SCE_IRQn, 6, 0);
+    HAL_NVIC_EnableIRQ(CAN1_SCE_IRQn);
 }
 
 /**
@@ -105,36 +242,509 @@ HAL_StatusTypeDef CAN_Driver_Init(void)
     TxHeader.DLC = 8;
     TxHeader.TransmitGlobalTime = DISABLE;
     
+    /* 发送完成 + 错误状态变化中断 */
+    if (HAL_CAN_ActivateNotification(&hcan, CAN_IT_TX_MAILBOX_EMPTY |
+                                            CAN_IT_ERROR_WARNING | CAN_IT_ERROR_PASSIVE |
+                                            CAN_IT_BUSOFF | CAN_IT_LAST_ERROR_CODE |
+                                            CAN_IT_ERROR) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    
+    memset((void *)&s_health, 0, sizeof(s_health));
+    s_window_start_ms = HAL_GetTick();
+    
     return HAL_OK;
 }
 
 /**
- * @brief 使用默认ID (0x321) 发送CAN数据
+ * @brief 运行时切换位速率 (控制器重新初始化, 滤波器与中断配置保留)
+ * @return HAL_OK=切换成功; 失败时恢复原位速率
  */
-HAL_StatusTypeDef CAN_Transmit(uint8_t *pData, uint16_t Size)
+HAL_StatusTypeDef CAN_SetBitrate(uint32_t bitrate)
 {
-    return CAN_TransmitWithId(CAN_ID_ANGLE, pData, Size);
+    uint32_t previous = s_bitrate;
+    
+    if (HAL_CAN_GetState(&hcan) == HAL_CAN_STATE_LISTENING)
+    {
+        HAL_CAN_Stop(&hcan);
+    }
+    
+    if (CAN_Configure(bitrate, CAN_OPERATING_MODE) != HAL_OK)
+    {
+        CAN_Configure(previous, CAN_OPERATING_MODE);
+        HAL_CAN_Start(&hcan);
+        return HAL_ERROR;
+    }
+    
+    return HAL_CAN_Start(&hcan);
 }
 
 /**
- * @brief 使用指定ID发送CAN数据
+ * @brief 获取当前位速率 (bps)
+ */
+uint32_t CAN_GetBitrate(void)
+{
+    return s_bitrate;
+}
+
+/**
+ * @brief 静默模式监听总线, 自动检测位速率
+ * @param listen_ms 每个候选速率的监听时间
+ * @return 检测到的位速率, 0=总线无流量或均不匹配 (保持原速率)
+ * 
+ * 静默模式下控制器不发送应答和错误帧, 不会干扰总线.
+ * 候选顺序: 当前速率优先, 其次 1M/500k/250k/125k;
+ * 收到一帧有效帧即判定成功, 出现位/格式错误则提前换下一个速率.
+ * 环回模式下无外部总线, 直接返回0.
+ */
+uint32_t CAN_AutoDetectBitrate(uint32_t listen_ms)
+{
+    uint32_t previous = s_bitrate;
+    uint32_t detected = 0;
+    CAN_RxHeaderTypeDef rxHeader;
+    uint8_t rxData[8];
+    
+    if (CAN_OPERATING_MODE == CAN_MODE_LOOPBACK)
+    {
+        return 0;
+    }
+    
+    for (int i = -1; i < (int)(sizeof(s_autobaud_rates) / sizeof(s_autobaud_rates[0])) && detected == 0; i++)
+    {
+        uint32_t rate = (i < 0) ? previous : s_autobaud_rates[i];
+        if (i >= 0 && rate == previous)
+        {
+            continue;
+        }
+        
+        if (HAL_CAN_GetState(&hcan) == HAL_CAN_STATE_LISTENING)
+        {
+            HAL_CAN_Stop(&hcan);
+        }
+        if (CAN_Configure(rate, CAN_MODE_SILENT) != HAL_OK || HAL_CAN_Start(&hcan) != HAL_OK)
+        {
+            continue;
+        }
+        
+        /* LEC置7: 之后的任何收发都会覆盖该值 */
+        hcan.Instance->ESR |= CAN_ESR_LEC;
+        
+        uint32_t tickstart = HAL_GetTick();
+        while ((HAL_GetTick() - tickstart) < listen_ms)
+        {
+            if (HAL_CAN_GetRxFifoFillLevel(&hcan, CAN_RX_FIFO0) > 0)
+            {
+                detected = rate;
+                break;
+            }
+            
+            uint32_t lec = (hcan.Instance->ESR & CAN_ESR_LEC) >> CAN_ESR_LEC_Pos;
+            if (lec != 0 && lec != 7)
+            {
+                break;                              /* 速率不匹配产生的错误 */
+            }
+        }
+        
+        /* 检测期间收到的帧不作为命令处理 */
+        while (HAL_CAN_GetRxFifoFillLevel(&hcan, CAN_RX_FIFO0) > 0)
+        {
+            HAL_CAN_GetRxMessage(&hcan, CAN_RX_FIFO0, &rxHeader, rxData);
+        }
+    }
+    
+    if (HAL_CAN_GetState(&hcan) == HAL_CAN_STATE_LISTENING)
+    {
+        HAL_CAN_Stop(&hcan);
+    }
+    CAN_Configure((detected != 0) ? detected : previous, CAN_OPERATING_MODE);
+    HAL_CAN_ResetError(&hcan);
+    HAL_CAN_Start(&hcan);
+    
+    return detected;
+}
+
+/**
+ * @brief 等待空闲邮箱并提交发送
  */
-HAL_StatusTypeDef CAN_TransmitWithId(uint32_t StdId, uint8_t *pData, uint16_t Size)
+RAMFUNC static HAL_StatusTypeDef CAN_AddMessage(uint8_t *pData)
 {
+    bool stamped = s_stamp_next;                    /* 由CAN_TransmitStamped设置, 只对本帧有效 */
+    
+    s_stamp_next = false;
+    
+    /* bus-off期间邮箱不会释放, 直接返回避免100ms空等 */
+    if (hcan.Instance->ESR & CAN_ESR_BOFF)
+    {
+        return HAL_ERROR;
+    }
+    
     /* 等待发送邮箱可用 */
     uint32_t tickstart = HAL_GetTick();
     while (HAL_CAN_GetTxMailboxesFreeLevel(&hcan) == 0)
     {
         if ((HAL_GetTick() - tickstart) > 100)      /* 100ms超时 */
         {
+            s_health.tx_timeouts++;
             return HAL_TIMEOUT;
         }
     }
     
+    TRACE_EVENT(TRACE_EV_CAN_TX, TxHeader.DLC, TxHeader.StdId);
+    
+    /* 邮箱空闲时不会有该邮箱的完成中断, 提交前写入时间戳; 邮箱号与HAL的选择方式相同 */
+    uint32_t index = (hcan.Instance->TSR & CAN_TSR_CODE) >> CAN_TSR_CODE_Pos;
+    if (index < 3)
+    {
+        s_tx_dlc[index] = (uint8_t)TxHeader.DLC;
+    }
+    stamped = stamped && index < 3;
+    if (stamped)
+    {
+        s_tx_stamp[index].submit_cycles = Timestamp_Now();
+        s_tx_stamp[index].sample_cycles = s_stamp_sample_cycles;
+        s_tx_stamp[index].capture = s_stamp_capture;
+        s_tx_stamp[index].valid = true;
+    }
+    
+    HAL_StatusTypeDef ret = HAL_CAN_AddTxMessage(&hcan, &TxHeader, pData, &TxMailbox);
+    if (ret != HAL_OK && stamped)
+    {
+        s_tx_stamp[index].valid = false;
+    }
+    return ret;
+}
+
+/**
+ * @brief 使用默认ID (0x321) 发送CAN数据
+ */
+HAL_StatusTypeDef CAN_Transmit(uint8_t *pData, uint16_t Size)
+{
+    return CAN_TransmitWithId(CAN_ID_ANGLE, pData, Size);
+}
+
+/**
+ * @brief 使用指定ID发送CAN数据
+ */
+RAMFUNC HAL_StatusTypeDef CAN_TransmitWithId(uint32_t StdId, uint8_t *pData, uint16_t Size)
+{
     /* 配置发送头 */
     TxHeader.StdId = StdId;
     TxHeader.DLC = (Size > 8) ? 8 : Size;           /* 最大8字节 */
+    TxHeader.TransmitGlobalTime = DISABLE;
     
     /* 发送数据 */
-    return HAL_CAN_AddTxMessage(&hcan, &TxHeader, pData, &TxMailbox);
+    return CAN_AddMessage(pData);
+}
+
+/**
+ * @brief 发送带采样时刻与硬件发送时刻的遥测帧
+ * @param Size 数据长度 (TTCM下最多4字节, 其余字节放时间戳)
+ * @param SampleCycles 数据采样时的DWT周期计数
+ * @param Capture true=SampleCycles为角速度读出时刻, 发送完成时计入capture→ack分段;
+ *                false=其他采样 (如温度, 可早于发送数百ms), 只计入publish→ack
+ * 
+ * TTCM禁用时等同于CAN_TransmitWithId
+ */
+RAMFUNC HAL_StatusTypeDef CAN_TransmitStamped(uint32_t StdId, uint8_t *pData, uint16_t Size, uint32_t SampleCycles,
+                                              bool Capture)
+{
+    s_stamp_next = true;
+    s_stamp_sample_cycles = SampleCycles;
+    s_stamp_capture = Capture;
+    
+#if CAN_USE_TTCM
+    uint8_t frame[8] = {0};
+    uint16_t sample_time = CAN_LocalToBusTime(SampleCycles);
+    
+    memcpy(frame, pData, (Size > 4) ? 4 : Size);
+    frame[4] = (uint8_t)(sample_time & 0xFF);
+    frame[5] = (uint8_t)(sample_time >> 8);
+    /* frame[6..7] 由硬件在SOF时写入总线时间 (TGT要求DLC=8) */
+    
+    TxHeader.StdId = StdId;
+    TxHeader.DLC = 8;
+    TxHeader.TransmitGlobalTime = ENABLE;
+    
+    return CAN_AddMessage(frame);
+#else
+    return CAN_TransmitWithId(StdId, pData, Size);
+#endif
+}
+
+/**
+ * @brief 本地DWT周期计数换算为CAN总线时间 (单位: 位时间)
+ * 
+ * 以最近一次发送完成的SOF时间戳为锚点外推, 误差主要来自填充位与中断延迟
+ * @return 总线时间; 尚无锚点时返回CAN_BUS_TIME_INVALID (有效值0xFFFF记为0xFFFE)
+ */
+RAMFUNC uint16_t CAN_LocalToBusTime(uint32_t Cycles)
+{
+    uint32_t cycles_per_bit = SystemCoreClock / s_bitrate;
+    uint32_t delta = Cycles - s_anchor_cycles;
+    uint16_t bus_time;
+    
+    if (!s_anchor_valid)
+    {
+        return CAN_BUS_TIME_INVALID;
+    }
+    
+    /* 采样早于锚点 (Cycles在锚点之前) 时差值按有符号处理 */
+    if ((int32_t)delta < 0)
+    {
+        bus_time = (uint16_t)(s_anchor_bus_time - (uint16_t)((uint32_t)(-(int32_t)delta) / cycles_per_bit));
+    }
+    else
+    {
+        bus_time = (uint16_t)(s_anchor_bus_time + (uint16_t)(delta / cycles_per_bit));
+    }
+    return (bus_time == CAN_BUS_TIME_INVALID) ? (uint16_t)(bus_time - 1U) : bus_time;
+}
+
+/**
+ * @brief CAN总线时间 (如接收帧时间戳) 换算为本地DWT周期计数
+ * 
+ * 总线时间16-bit回绕, 只适用于距今一个回绕周期内的时间戳 (500kbps约131ms);
+ * 尚无锚点时无法换算, 返回当前时刻
+ */
+uint32_t CAN_BusTimeToLocal(uint16_t BusTime)
+{
+    uint32_t now = Timestamp_Now();
+    if (!s_anchor_valid)
+    {
+        return now;
+    }
+    uint16_t age = (uint16_t)(CAN_LocalToBusTime(now) - BusTime);
+    
+    return now - (uint32_t)age * (SystemCoreClock / s_bitrate);
+}
+
+/**
+ * @brief 读取一帧接收数据 (同时计入总线负载)
+ */
+HAL_StatusTypeDef CAN_Receive(CAN_RxHeaderTypeDef *pHeader, uint8_t *pData)
+{
+    HAL_StatusTypeDef ret = HAL_CAN_GetRxMessage(&hcan, CAN_RX_FIFO0, pHeader, pData);
+    
+    if (ret == HAL_OK)
+    {
+        __disable_irq();                            /* 与发送完成中断互斥 */
+        s_window_bits += CAN_FRAME_BITS(pHeader->DLC);
+        __enable_irq();
+        TRACE_EVENT(TRACE_EV_CAN_RX, pHeader->DLC, pHeader->StdId);
+    }
+    return ret;
+}
+
+/**
+ * @brief 总线健康周期维护 (建议10ms调用一次)
+ * 
+ * - 刷新TEC/REC/LEC与错误状态
+ * - bus-off超过CAN_BUSOFF_RECOVERY_MS仍未退出 (如总线持续显性) 时重启控制器
+ * - 每CAN_LOAD_WINDOW_MS计算一次总线负载
+ */
+void CAN_Health_Update(uint32_t now_ms)
+{
+    uint32_t esr = hcan.Instance->ESR;
+    bool bus_off = (esr & CAN_ESR_BOFF) ? true : false;
+    
+    s_health.tec = (uint8_t)((esr & CAN_ESR_TEC) >> CAN_ESR_TEC_Pos);
+    s_health.rec = (uint8_t)((esr & CAN_ESR_REC) >> CAN_ESR_REC_Pos);
+    s_health.lec = (uint8_t)((esr & CAN_ESR_LEC) >> CAN_ESR_LEC_Pos);
+    s_health.error_warning = (esr & CAN_ESR_EWGF) ? true : false;
+    if ((esr & CAN_ESR_EPVF) && !s_health.error_passive)
+    {
+        s_health.error_passive_count++;             /* 错误回调未先计入的进入 */
+    }
+    s_health.error_passive = (esr & CAN_ESR_EPVF) ? true : false;
+    s_health.bus_off = bus_off;
+    
+    if (bus_off)
+    {
+        if (!s_busoff_active)
+        {
+            s_busoff_active = true;
+            s_busoff_start_ms = now_ms;
+        }
+        else if ((now_ms - s_busoff_start_ms) >= CAN_BUSOFF_RECOVERY_MS)
+        {
+            /* 重新进入初始化模式再启动, 强制清除错误计数 */
+            HAL_CAN_Stop(&hcan);
+            HAL_CAN_Start(&hcan);
+            s_health.forced_restarts++;
+            s_busoff_start_ms = now_ms;
+        }
+    }
+    else if (s_busoff_active)
+    {
+        s_busoff_active = false;
+        s_health.last_recovery_ms = now_ms - s_busoff_start_ms;
+    }
+    
+    if ((now_ms - s_window_start_ms) >= CAN_LOAD_WINDOW_MS)
+    {
+        uint32_t elapsed = now_ms - s_window_start_ms;
+        uint32_t bits;
+        
+        __disable_irq();                            /* 与发送完成中断互斥 */
+        bits = s_window_bits;
+        s_window_bits = 0;
+        __enable_irq();
+        s_window_start_ms = now_ms;
+        
+        /* 负载(‰) = 位数 / (位速率 × 窗口秒数) × 1000 */
+        s_health.bus_load_permille = (uint16_t)(((uint64_t)bits * 1000U * 1000U) /
+                                                ((uint64_t)s_bitrate * elapsed));
+    }
+}
+
+/**
+ * @brief 获取总线健康快照
+ */
+RAMFUNC void CAN_GetHealth(CAN_Health *health)
+{
+    memcpy(health, (const void *)&s_health, sizeof(CAN_Health));
+}
+
+/**
+ * @brief 打包8字节健康诊断帧 (CAN_ID_CAN_HEALTH)
+ * [0]TEC [1]REC [2]bit0 EWG/bit1 EPV/bit2 BOF/bit4-6 LEC
+ * [3]bus-off次数 [4]错误中断次数 [5]进入错误被动次数 [6]发送超时次数 (均饱和于255)
+ * [7]总线负载 (0.5%/LSB)
+ */
+RAMFUNC void CAN_Health_Encode(const CAN_Health *health, uint8_t *data)
+{
+    data[0] = health->tec;
+    data[1] = health->rec;
+    data[2] = (uint8_t)((health->error_warning ? 0x01 : 0) |
+                        (health->error_passive ? 0x02 : 0) |
+                        (health->bus_off ? 0x04 : 0) |
+                        ((health->lec & 0x07) << 4));
+    data[3] = (health->bus_off_count > 255) ? 255 : (uint8_t)health->bus_off_count;
+    data[4] = (health->error_count > 255) ? 255 : (uint8_t)health->error_count;
+    data[5] = (health->error_passive_count > 255) ? 255 : (uint8_t)health->error_passive_count;
+    data[6] = (health->tx_timeouts > 255) ? 255 : (uint8_t)health->tx_timeouts;
+    data[7] = (health->bus_load_permille / 5 > 255) ? 255 : (uint8_t)(health->bus_load_permille / 5);
+}
+
+/**
+ * @brief 写入16-bit小端计数, 饱和
+ */
+static void CAN_Put16(uint8_t *dst, uint32_t value)
+{
+    if (value > 0xFFFF)
+    {
+        value = 0xFFFF;
+    }
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief 打包健康诊断第2页 (CAN_ID_CAN_HEALTH2), uint16小端, 饱和
+ * [0-1]发送错误次数 [2-3]软件重启控制器次数 [4-5]最近一次bus-off恢复耗时 (ms)
+ * [6-7]bus-off次数
+ */
+void CAN_Health_Encode2(const CAN_Health *health, uint8_t *data)
+{
+    CAN_Put16(&data[0], health->tx_errors);
+    CAN_Put16(&data[2], health->forced_restarts);
+    CAN_Put16(&data[4], health->last_recovery_ms);
+    CAN_Put16(&data[6], health->bus_off_count);
+}
+
+/**
+ * @brief 发送完成处理: 计入总线负载, TTCM下更新总线时间锚点
+ * 发送完成中断发生在帧结束处, 回推一帧长度得到SOF对应的本地时刻
+ */
+RAMFUNC static void CAN_TxComplete(CAN_HandleTypeDef *hcan_p, uint32_t mailbox)
+{
+    uint32_t now = Timestamp_Now();
+    volatile CAN_TxStamp *stamp = &s_tx_stamp[mailbox >> 1];
+    
+    if (stamp->valid)
+    {
+        Latency_Record(LATENCY_PUBLISH_TO_ACK, now - stamp->submit_cycles);
+        if (stamp->capture && stamp->sample_cycles != 0)
+        {
+            Latency_Record(LATENCY_CAPTURE_TO_ACK, now - stamp->sample_cycles);
+        }
+        stamp->valid = false;
+    }
+    
+#if CAN_USE_TTCM
+    s_anchor_bus_time = (uint16_t)HAL_CAN_GetTxTimestamp(hcan_p, mailbox);
+    s_anchor_cycles = now - CAN_FRAME_SOF_TO_TXOK_BITS * (SystemCoreClock / s_bitrate);
+    s_anchor_valid = true;
+#else
+    (void)hcan_p;
+#endif
+    TRACE_EVENT(TRACE_EV_CAN_TX_DONE, mailbox, 0);
+    s_window_bits += CAN_FRAME_BITS(s_tx_dlc[mailbox >> 1]);
+}
+
+RAMFUNC void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan_p)
+{
+    CAN_TxComplete(hcan_p, CAN_TX_MAILBOX0);
+}
+
+RAMFUNC void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan_p)
+{
+    CAN_TxComplete(hcan_p, CAN_TX_MAILBOX1);
+}
+
+RAMFUNC void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan_p)
+{
+    CAN_TxComplete(hcan_p, CAN_TX_MAILBOX2);
+}
+
+/**
+ * @brief 错误回调: 按错误类型计数
+ * 开启自动重传时仲裁丢失不会结束发送请求 (ALST不可观察), 不计数;
+ * 发送错误 (TERR) 只在请求被中止时报告
+ */
+void HAL_CAN_ErrorCallback(CAN_HandleTypeDef *hcan_p)
+{
+    uint32_t err = HAL_CAN_GetError(hcan_p);
+    
+    if (err & HAL_CAN_ERROR_BOF)
+    {
+        s_health.bus_off_count++;
+    }
+    if (err & (HAL_CAN_ERROR_STF | HAL_CAN_ERROR_FOR | HAL_CAN_ERROR_ACK |
+               HAL_CAN_ERROR_BR | HAL_CAN_ERROR_BD | HAL_CAN_ERROR_CRC))
+    {
+        s_health.error_count++;
+    }
+    if ((err & HAL_CAN_ERROR_EPV) && !s_health.error_passive)
+    {
+        s_health.error_passive = true;              /* 同一次进入在CAN_Health_Update中不再计数 */
+        s_health.error_passive_count++;
+    }
+    if (err & (HAL_CAN_ERROR_TX_TERR0 | HAL_CAN_ERROR_TX_TERR1 | HAL_CAN_ERROR_TX_TERR2))
+    {
+        s_health.tx_errors++;
+    }
+    
+    HAL_CAN_ResetError(hcan_p);
+}
+
+/**
+ * @brief CAN1发送中断
+ */
+RAMFUNC void USB_HP_CAN1_TX_IRQHandler(void)
+{
+    TRACE_ISR_ENTER(USB_HP_CAN1_TX_IRQn);
+    HAL_CAN_IRQHandler(&hcan);
+    TRACE_ISR_EXIT(USB_HP_CAN1_TX_IRQn);
+}
+
+/**
+ * @brief CAN1状态变化/错误中断
+ */
+void CAN1_SCE_IRQHandler(void)
+{
+    TRACE_ISR_ENTER(CAN1_SCE_IRQn);
+    HAL_CAN_IRQHandler(&hcan);
+    TRACE_ISR_EXIT(CAN1_SCE_IRQn);
 }
@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 #include "stm32f1xx_hal.h"
+#include <stdbool.h>
 
 /* CAN1 引脚定义 */
 #define CAN_RX_PIN          GPIO_PIN_11
@@ -17,6 +18,80 @@ extern "C" {
 #define CAN_ID_ANGLE        0x321   /* 角度数据 */
 #define CAN_ID_TEMP         0x322   /* 温度数据 */
 #define CAN_ID_GYRO_RATE    0x323   /* 角速度数据 */
+#define CAN_ID_CAN_HEALTH   0x324   /* CAN总线健康诊断 */
+#define CAN_ID_RAW_STREAM   0x325   /* 原始采样流 (诊断) */
+#define CAN_ID_RECORDER     0x326   /* 飞行记录仪导出 (最低优先级) */
+#define CAN_ID_CAPTURE      0x327   /* 采集记录流 (离线回放) */
+#define CAN_ID_SYS_MONITOR  0x328   /* 系统监视 (CPU占用/栈/堆) */
+#define CAN_ID_TRACE        0x329   /* 事件跟踪导出 */
+#define CAN_ID_DEADLINE     0x32A   /* 控制循环截止时间监视 */
+#define CAN_ID_LATENCY      0x32B   /* 分段延迟直方图导出 */
+#define CAN_ID_POWER        0x32C   /* 功耗管理状态 */
+#define CAN_ID_BOOT         0x32D   /* 启动状态 */
+#define CAN_ID_RETAIN       0x32E   /* 角度保持 (热复位恢复) */
+#define CAN_ID_FILTER       0x32F   /* 角速度输出滤波配置应答 */
+#define CAN_ID_SENSOR_CFG   0x330   /* 传感器DSP/输出格式配置应答 */
+#define CAN_ID_ACQ_SCHED    0x331   /* 多速率采集调度应答 */
+#define CAN_ID_FUSION       0x332   /* 多陀螺仪融合状态 */
+#define CAN_ID_SENSOR_FAULT 0x333   /* 传感器读数故障计数 */
+#define CAN_ID_CAN_HEALTH2  0x334   /* CAN总线健康诊断第2页 (发送错误与bus-off恢复) */
+
+/* 位速率与位时序 */
+#define CAN_DEFAULT_BITRATE         500000  /* 默认位速率 (bps), 可通过命令修改并保存 */
+#define CAN_SAMPLE_POINT_PERMILLE   875     /* 目标采样点 87.5% (CiA推荐) */
+#define CAN_AUTOBAUD_LISTEN_MS      200     /* 自动波特率检测每个候选速率的监听时间 */
+#define CAN_AUTOBAUD_RETRY_MS       10000   /* 运行中重新检测的最小间隔 */
+#define CAN_AUTOBAUD_TX_ERRORS      16      /* 错误被动时新增该数量的发送错误即重新检测 */
+
+/* 工作模式: 环回模式用于无外部硬件测试, 正式使用时改为 CAN_MODE_NORMAL */
+#ifndef CAN_OPERATING_MODE
+#define CAN_OPERATING_MODE          CAN_MODE_LOOPBACK
+#endif
+
+/*
+ * 时间触发通信模式 (TTCM)
+ * 1 = 启用: 接收帧带硬件SOF时间戳, 遥测帧扩展为8字节:
+ *     [0-3] 数据 [4-5] 采样时刻(总线时间) [6-7] 发送SOF时刻(硬件填充)
+ *     数据龄 = ([6-7] - [4-5]) & 0xFFFF, 单位为1个CAN位时间
+ *     [4-5] = CAN_BUS_TIME_INVALID: 启动或改变位速率后第一帧发送完成前,
+ *     本地时刻与总线时间尚无对应关系, 采样时刻未知
+ * 0 = 禁用: 保持原4字节帧格式
+ */
+#ifndef CAN_USE_TTCM
+#define CAN_USE_TTCM        0
+#endif
+#define CAN_BUS_TIME_INVALID    0xFFFF  /* 采样时刻未知 (有效总线时间不取此值) */
+
+/* 总线健康监测参数 */
+#define CAN_BUSOFF_RECOVERY_MS  100     /* bus-off超过该时间未自动恢复则重启控制器 */
+#define CAN_LOAD_WINDOW_MS      1000    /* 总线负载统计窗口 */
+
+/* 位时序参数 (TQ数) */
+typedef struct {
+    uint16_t prescaler;         /* 分频 1~1024 */
+    uint8_t bs1;                /* 时间段1 1~16 TQ */
+    uint8_t bs2;                /* 时间段2 2~8 TQ */
+    uint8_t sjw;                /* 同步跳转宽度 1~4 TQ */
+    uint16_t sample_point;      /* 实际采样点 (‰) */
+} CAN_BitTiming;
+
+/* 总线健康状态 */
+typedef struct {
+    uint8_t tec;                /* 发送错误计数 */
+    uint8_t rec;                /* 接收错误计数 */
+    uint8_t lec;                /* 最近错误码 (0=无错误) */
+    bool error_warning;         /* 错误警告 (TEC/REC≥96) */
+    bool error_passive;         /* 错误被动 (TEC/REC>127) */
+    bool bus_off;               /* 离线 (TEC>255) */
+    uint32_t bus_off_count;     /* 进入bus-off次数 */
+    uint32_t error_count;       /* 总线错误 (填充/格式/应答/位/CRC) 次数 */
+    uint32_t error_passive_count; /* 进入错误被动次数 */
+    uint32_t tx_errors;         /* 发送错误次数 */
+    uint32_t tx_timeouts;       /* 等待邮箱超时次数 */
+    uint32_t forced_restarts;   /* 超时后软件重启控制器次数 */
+    uint32_t last_recovery_ms;  /* 最近一次bus-off恢复耗时 */
+    uint16_t bus_load_permille; /* 总线负载 (‰) */
+} CAN_Health;
 
 /* CAN句柄 */
 extern CAN_HandleTypeDef hcan;
@@ -24,8 +99,21 @@ extern CAN_HandleTypeDef hcan;
 /* 函数声明 */
 void MX_CAN_Init(void);
 HAL_StatusTypeDef CAN_Driver_Init(void);
+HAL_StatusTypeDef CAN_CalcBitTiming(uint32_t pclk, uint32_t bitrate, uint16_t sample_point, CAN_BitTiming *bt);
+HAL_StatusTypeDef CAN_SetBitrate(uint32_t bitrate);
+uint32_t CAN_GetBitrate(void);
+uint32_t CAN_AutoDetectBitrate(uint32_t listen_ms);
 HAL_StatusTypeDef CAN_Transmit(uint8_t *pData, uint16_t Size);
 HAL_StatusTypeDef CAN_TransmitWithId(uint32_t StdId, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef CAN_TransmitStamped(uint32_t StdId, uint8_t *pData, uint16_t Size, uint32_t SampleCycles,
+                                      bool Capture);
+uint16_t CAN_LocalToBusTime(uint32_t Cycles);
+uint32_t CAN_BusTimeToLocal(uint16_t BusTime);
+HAL_StatusTypeDef CAN_Receive(CAN_RxHeaderTypeDef *pHeader, uint8_t *pData);
+void CAN_Health_Update(uint32_t now_ms);
+void CAN_GetHealth(CAN_Health *health);
+void CAN_Health_Encode(const CAN_Health *health, uint8_t *data);
+void CAN_Health_Encode2(const CAN_Health *health, uint8_t *data);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,131 @@
+#include "config_store.h"
+#include "can.h"
+#include <stddef.h>
+#include <string.h>
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+static ConfigStore_Data s_config;
+static bool s_stored;                       /* Flash中的参数有效 (与s_config一致) */
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+/**
+ * @brief CRC32 (多项式0xEDB88320), 仅在加载/保存时使用
+ */
+static uint32_t ConfigStore_Crc32(const uint8_t *data, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+    
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief 填充默认参数
+ */
+static void ConfigStore_Defaults(ConfigStore_Data *cfg)
+{
+    memset(cfg, 0, sizeof(ConfigStore_Data));
+    cfg->magic = CONFIG_STORE_MAGIC;
+    cfg->version = CONFIG_STORE_VERSION;
+    cfg->size = sizeof(ConfigStore_Data);
+    cfg->can_bitrate = CAN_DEFAULT_BITRATE;
+}
+
+/**
+ * @brief 擦除参数页并按半字写入
+ */
+static HAL_StatusTypeDef ConfigStore_Save(void)
+{
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t page_error = 0;
+    const uint16_t *src = (const uint16_t *)&s_config;
+    HAL_StatusTypeDef ret;
+    
+    s_config.crc = ConfigStore_Crc32((const uint8_t *)&s_config, offsetof(ConfigStore_Data, crc));
+    
+    HAL_FLASH_Unlock();
+    
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.PageAddress = CONFIG_STORE_ADDR;
+    erase.NbPages = 1;
+    ret = HAL_FLASHEx_Erase(&erase, &page_error);
+    
+    for (uint32_t i = 0; ret == HAL_OK && i < sizeof(ConfigStore_Data) / 2; i++)
+    {
+        ret = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, CONFIG_STORE_ADDR + i * 2, src[i]);
+    }
+    
+    HAL_FLASH_Lock();
+    return ret;
+}
+
+/*============================================================================
+ * 公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 从Flash加载参数
+ */
+bool ConfigStore_Load(void)
+{
+    const ConfigStore_Data *stored = (const ConfigStore_Data *)CONFIG_STORE_ADDR;
+    
+    if (stored->magic == CONFIG_STORE_MAGIC &&
+        stored->version == CONFIG_STORE_VERSION &&
+        stored->size == sizeof(ConfigStore_Data) &&
+        stored->crc == ConfigStore_Crc32((const uint8_t *)stored, offsetof(ConfigStore_Data, crc)))
+    {
+        memcpy(&s_config, stored, sizeof(ConfigStore_Data));
+        s_stored = true;
+        return true;
+    }
+    
+    ConfigStore_Defaults(&s_config);
+    s_stored = false;
+    return false;
+}
+
+/**
+ * @brief 获取当前参数
+ */
+const ConfigStore_Data *ConfigStore_Get(void)
+{
+    return &s_config;
+}
+
+/**
+ * @brief Flash中是否有有效参数
+ */
+bool ConfigStore_Stored(void)
+{
+    return s_stored;
+}
+
+/**
+ * @brief 修改CAN位速率并写入Flash
+ */
+HAL_StatusTypeDef ConfigStore_SetCanBitrate(uint32_t bitrate)
+{
+    HAL_StatusTypeDef ret;
+    
+    if (s_config.can_bitrate == bitrate && s_stored)
+    {
+        return HAL_OK;
+    }
+    s_config.can_bitrate = bitrate;
+    ret = ConfigStore_Save();
+    s_stored = (ret == HAL_OK);
+    return ret;
+}
@@ -0,0 +1,56 @@
+#ifndef __CONFIG_STORE_H
+#define __CONFIG_STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f1xx_hal.h"
+#include <stdbool.h>
+
+/*============================================================================
+ * 参数持久化 (Flash最后一页)
+ * STM32F103C8: 64KB Flash, 页大小1KB, 使用第63页 0x0800FC00
+ * 链接脚本STM32F103C8_ramfunc.lds将该页划为CONFIG区域, FLASH区域只有63KB;
+ * 改用BSP默认链接脚本时须同样保留该页
+ *============================================================================*/
+#define CONFIG_STORE_ADDR       (FLASH_BASE + 0xFC00U)     /* 与链接脚本的CONFIG区域一致 */
+#define CONFIG_STORE_MAGIC      0x58563743U     /* "XV7C" */
+#define CONFIG_STORE_VERSION    1
+
+/* 持久化参数 */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;              /* sizeof(ConfigStore_Data), 结构变化时校验失败回落默认值 */
+    uint32_t can_bitrate;       /* CAN位速率 (bps) */
+    uint32_t crc;               /* 以上字段的CRC32 */
+} ConfigStore_Data;
+
+/**
+ * @brief 从Flash加载参数, 校验失败时使用默认值
+ * @return true=Flash中有有效参数
+ */
+bool ConfigStore_Load(void);
+
+/**
+ * @brief 获取当前参数 (只读)
+ */
+const ConfigStore_Data *ConfigStore_Get(void);
+
+/**
+ * @brief Flash中是否有有效参数 (未保存过时为false, 位速率为默认值)
+ */
+bool ConfigStore_Stored(void);
+
+/**
+ * @brief 修改CAN位速率并写入Flash (与Flash中的值相同时不写入)
+ * 注意: 擦写期间CPU停顿约20~40ms
+ */
+HAL_StatusTypeDef ConfigStore_SetCanBitrate(uint32_t bitrate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CONFIG_STORE_H */
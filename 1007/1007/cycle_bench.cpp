@@ -0,0 +1,444 @@
+#include "cycle_bench.h"
+#include "gyro_pipeline.h"
+#include "xvlog.h"
+#include "xv7001bb.h"
+#include "can.h"
+#include "ramfunc.h"
+#include "rate_filter.h"
+#include "acq_sched.h"
+#include "gyro_fusion.h"
+#include <string.h>
+#include <math.h>
+
+/*============================================================================
+ * 计时器
+ *============================================================================*/
+#ifdef HOST_BUILD
+extern "C" uint32_t HostSim_BenchNow(void);
+extern "C" uint32_t HostSim_BenchHz(void);
+
+#define CYCLE_BENCH_PLATFORM    "host"
+#define CYCLE_BENCH_NOW()       HostSim_BenchNow()
+#define CYCLE_BENCH_HZ()        HostSim_BenchHz()
+#define CYCLE_BENCH_LOCK()
+#define CYCLE_BENCH_UNLOCK()
+#else
+#define CYCLE_BENCH_PLATFORM    "stm32f103"
+#define CYCLE_BENCH_NOW()       (DWT->CYCCNT)
+#define CYCLE_BENCH_HZ()        (SystemCoreClock)
+#define CYCLE_BENCH_LOCK()      __disable_irq()     /* 排除SysTick等中断 */
+#define CYCLE_BENCH_UNLOCK()    __enable_irq()
+#endif
+
+/*============================================================================
+ * 被测阶段
+ *============================================================================*/
+
+/* 浮点/定点积分核心 (与流水线相同参数, 仅数值类型不同) */
+struct CycleBenchFloatConfig : GyroPipelineConfig { typedef float value_type; };
+struct CycleBenchFixedConfig : GyroPipelineConfig { typedef GyroFixed value_type; };
+
+/* 阶段共用数据 */
+typedef struct {
+    XV7_Device *dev;            /* 第一个传感器 (SPI阶段) */
+    XV7_StatusReg status;
+    XV7_GyroData gyro;
+    XV7_TempData temp;
+    GyroPipeline pipe;
+    GyroPipeline_Sample sample;
+    GyroIntegrator<CycleBenchFloatConfig> integ_float;
+    GyroIntegrator<CycleBenchFixedConfig> integ_fixed;
+    BiquadCascade filter;       /* 全部节启用 (最坏情况) */
+    int32_t raw_moving;         /* 远离零偏, 只积分 */
+    int32_t raw_still;          /* 接近零偏, 积分并更新零偏 */
+    float rate_dps;             /* 滤波输入 */
+    uint32_t acq_cycle;         /* 按调度表读数的周期序号 */
+    GyroFusion fusion;          /* 4个传感器, 学习期结束 (最坏情况) */
+    GyroFusion_Input fusion_in;
+    int32_t fused;
+    uint8_t frame[8];
+    volatile float sink;        /* 防止结果被优化掉 */
+} CycleBench_Context;
+
+static void Stage_Empty(void *ctx)
+{
+    (void)ctx;
+}
+
+static void Stage_ReadStatus(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    XV7001bb_ReadStatus(c->dev, &c->status);
+}
+
+static void Stage_ReadRate(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    XV7001bb_ReadAngle(c->dev, &c->gyro);
+}
+
+static void Stage_ReadTemp(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    XV7001bb_ReadTmp(c->dev, &c->temp);
+}
+
+static void Stage_Convert(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    c->sink = GyroPipelineIntegrator::toDps(c->raw_moving);
+}
+
+static void Stage_IntegrateFloat(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    c->integ_float.update(c->raw_moving);
+}
+
+static void Stage_BiasUpdateFloat(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    c->integ_float.update(c->raw_still);
+}
+
+static void Stage_IntegrateFixed(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    c->integ_fixed.update(c->raw_moving);
+}
+
+static void Stage_BiasUpdateFixed(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    c->integ_fixed.update(c->raw_still);
+}
+
+static void Stage_PipelineStep(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    GyroPipeline_Step(&c->pipe, &c->sample);
+}
+
+static void Stage_RateFilter(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    
+    // 与RateFilter_Process相同: 换算Q15.16、级联运算、换算回°/s
+    int32_t x = (int32_t)lrintf(c->rate_dps * (float)(1L << RATE_FILTER_DATA_SHIFT));
+    c->sink = (float)BiquadCascade_Process(&c->filter, x) / (float)(1L << RATE_FILTER_DATA_SHIFT);
+}
+
+static void Stage_CanEncode(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    CAN_Health health;
+    
+    // 健康帧与角度帧打包 (不含邮箱写入)
+    CAN_GetHealth(&health);
+    CAN_Health_Encode(&health, c->frame);
+    float angle = c->pipe.angle;
+    memcpy(c->frame, &angle, sizeof(float));
+}
+
+static void Stage_FusionCombine(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    GyroFusion_Combine(&c->fusion, &c->fusion_in, &c->fused);
+}
+
+static void Stage_RecordEncode(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    XvLog_EncodeSample(c->frame, &c->sample);
+}
+
+/**
+ * @brief 完整周期: 与Task_Main相同的读数、处理和记录编码 (不含全局变量发布)
+ */
+static void Stage_FullIteration(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    GyroPipeline_Sample *s = &c->sample;
+    
+    s->status_ok = (XV7001bb_ReadStatus(c->dev, &c->status) == XV7_OK);
+    s->status_raw = c->status.raw;
+    s->gyro_ok = (XV7001bb_ReadAngle(c->dev, &c->gyro) == XV7_OK);
+    s->gyro_raw = c->gyro.raw;
+    s->temp_ok = (XV7001bb_ReadTmp(c->dev, &c->temp) == XV7_OK);
+    s->temp_raw = c->temp.raw;
+    GyroPipeline_Step(&c->pipe, s);
+    XvLog_EncodeSample(c->frame, s);
+}
+
+/**
+ * @brief 按采集调度表的周期: 连续运行覆盖各慢通道的读取周期, max为调度后的最坏周期
+ * (状态未读的周期沿用上次状态, 与Task_Main相同)
+ */
+static void Stage_ScheduledIteration(void *ctx)
+{
+    CycleBench_Context *c = (CycleBench_Context *)ctx;
+    GyroPipeline_Sample *s = &c->sample;
+    uint8_t due = AcqSched_DueAt(c->acq_cycle++);
+    
+    if (due & ACQ_DUE_STATUS)
+    {
+        s->status_ok = (XV7001bb_ReadStatus(c->dev, &c->status) == XV7_OK);
+        s->status_raw = c->status.raw;
+    }
+    if (due & ACQ_DUE_RATE)
+    {
+        s->gyro_ok = (XV7001bb_ReadAngle(c->dev, &c->gyro) == XV7_OK);
+        s->gyro_raw = c->gyro.raw;
+    }
+    s->temp_ok = false;
+    if (due & ACQ_DUE_TEMP)
+    {
+        s->temp_ok = (XV7001bb_ReadTmp(c->dev, &c->temp) == XV7_OK);
+        s->temp_raw = c->temp.raw;
+    }
+    GyroPipeline_Step(&c->pipe, s);
+    XvLog_EncodeSample(c->frame, s);
+}
+
+/**
+ * @brief 积分核心进入运行阶段 (零偏=0)
+ */
+template <class Integrator>
+static void CycleBench_PrimeIntegrator(Integrator *integ)
+{
+    integ->reset();
+    for (int i = 0; i < GYRO_BIAS_SAMPLE_COUNT; i++)
+    {
+        integ->calibrate(true, 0);
+    }
+}
+
+/*============================================================================
+ * JSON输出 (不使用printf, 避免链接格式化库)
+ *============================================================================*/
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+} CycleBench_Writer;
+
+static void Json_Str(CycleBench_Writer *w, const char *s)
+{
+    while (*s != '\0')
+    {
+        if (w->len + 1 < w->size)
+        {
+            w->buf[w->len] = *s;
+        }
+        w->len++;
+        s++;
+    }
+}
+
+static void Json_U32(CycleBench_Writer *w, uint32_t value)
+{
+    char digits[11];
+    int n = 0;
+    
+    do
+    {
+        digits[n++] = (char)('0' + value % 10U);
+        value /= 10U;
+    } while (value != 0U);
+    
+    char out[12];
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = digits[n - 1 - i];
+    }
+    out[n] = '\0';
+    Json_Str(w, out);
+}
+
+static void Json_Field(CycleBench_Writer *w, const char *key, uint32_t value, bool last)
+{
+    Json_Str(w, "\"");
+    Json_Str(w, key);
+    Json_Str(w, "\":");
+    Json_U32(w, value);
+    Json_Str(w, last ? "" : ",");
+}
+
+/*============================================================================
+ * 公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 测量一个阶段
+ * 
+ * 每次运行前后读取计时器, 扣除空函数测得的最小开销; 中位数用插入排序求取
+ */
+void CycleBench_Run(CycleBench_Report *report, const char *name, CycleBench_Fn fn, void *ctx, uint32_t runs)
+{
+    static uint32_t samples[CYCLE_BENCH_RUNS];
+    
+    if (report->count >= CYCLE_BENCH_MAX_STAGES)
+    {
+        return;
+    }
+    if (runs == 0 || runs > CYCLE_BENCH_RUNS)
+    {
+        runs = CYCLE_BENCH_RUNS;
+    }
+    
+    for (uint32_t i = 0; i < runs; i++)
+    {
+        CYCLE_BENCH_LOCK();
+        uint32_t t0 = CYCLE_BENCH_NOW();
+        fn(ctx);
+        uint32_t t1 = CYCLE_BENCH_NOW();
+        CYCLE_BENCH_UNLOCK();
+        
+        uint32_t cycles = t1 - t0;
+        cycles = (cycles > report->overhead) ? cycles - report->overhead : 0U;
+        
+        // 插入排序
+        uint32_t j = i;
+        while (j > 0 && samples[j - 1] > cycles)
+        {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = cycles;
+    }
+    
+    if (report->hists != NULL)
+    {
+        LatencyHist *h = &report->hists[report->count];
+        uint32_t span = samples[runs - 1] - samples[0] + 1;
+        
+        LatencyHist_Init(h, samples[0], (span + LATENCY_HIST_BUCKETS - 1) / LATENCY_HIST_BUCKETS);
+        for (uint32_t i = 0; i < runs; i++)
+        {
+            LatencyHist_Add(h, samples[i]);
+        }
+    }
+    
+    CycleBench_Result *r = &report->stages[report->count++];
+    r->name = name;
+    r->runs = runs;
+    r->min = samples[0];
+    r->median = samples[runs / 2];
+    r->max = samples[runs - 1];
+}
+
+/**
+ * @brief 运行全部热路径阶段
+ */
+void CycleBench_RunAll(CycleBench_Report *report, uint32_t runs)
+{
+    static CycleBench_Context ctx;
+    LatencyHist *hists = report->hists;
+    
+    memset(report, 0, sizeof(CycleBench_Report));
+    report->hists = hists;
+    report->platform = CYCLE_BENCH_PLATFORM;
+    report->timer_hz = CYCLE_BENCH_HZ();
+    report->ramfunc_bytes = RamFunc_Size();
+    
+    // 计时开销: 空函数的最小值
+    CycleBench_Run(report, "overhead", Stage_Empty, &ctx, runs);
+    report->overhead = report->stages[0].min;
+    report->count = 0;
+    
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.dev = GyroSensors_Device(0);
+    ctx.raw_moving = (int32_t)(10.0f * XV7_GYRO_SENSITIVITY_24BIT);     // 10°/s
+    ctx.raw_still = (int32_t)(0.1f * XV7_GYRO_SENSITIVITY_24BIT);       // 0.1°/s
+    CycleBench_PrimeIntegrator(&ctx.integ_float);
+    CycleBench_PrimeIntegrator(&ctx.integ_fixed);
+    
+    // 流水线进入运行阶段, 样本为正常工作状态下的读数
+    GyroPipeline_Init(&ctx.pipe);
+    ctx.sample.status_ok = true;
+    ctx.sample.status_raw = XV7_STATUS_PROC_OK | XV7_STATE_SLEEP_OUT;
+    ctx.sample.gyro_ok = true;
+    ctx.sample.gyro_raw = 0;
+    ctx.sample.temp_ok = true;
+    for (int i = 0; i < GYRO_BIAS_SAMPLE_COUNT; i++)
+    {
+        GyroPipeline_Step(&ctx.pipe, &ctx.sample);
+    }
+    ctx.sample.gyro_raw = ctx.raw_moving;
+    
+    // 滤波: 2节低通 + 2节陷波
+    ctx.rate_dps = 10.0f;
+    BiquadCascade_Init(&ctx.filter);
+    for (uint8_t i = 0; i < RATE_FILTER_SECTIONS; i++)
+    {
+        int32_t coef[RATE_FILTER_COEFS];
+        Biquad_Design(coef, (i < 2) ? RATE_FILTER_LOWPASS : RATE_FILTER_NOTCH,
+                      (i < 2) ? 20.0f : 12.5f + i, 0.707f + i, (float)GYRO_PIPELINE_RATE_HZ);
+        BiquadCascade_SetSection(&ctx.filter, i, coef);
+    }
+    
+    // 融合: 4个传感器全部参与 (含中位数与剔除判断)
+    GyroFusion_Init(&ctx.fusion, 0x0F);
+    ctx.fusion.learn = GYRO_FUSION_LEARN_SAMPLES;
+    ctx.fusion_in.valid = 0x0F;
+    ctx.fusion_in.held = 0;
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        ctx.fusion.sensors[i].noise_var = 1000.0f * 1000.0f;
+        ctx.fusion_in.raw[i] = ctx.raw_moving + 200 * i;
+    }
+    
+    CycleBench_Run(report, "spi_read_status", Stage_ReadStatus, &ctx, runs);
+    CycleBench_Run(report, "spi_read_rate", Stage_ReadRate, &ctx, runs);
+    CycleBench_Run(report, "spi_read_temp", Stage_ReadTemp, &ctx, runs);
+    CycleBench_Run(report, "convert", Stage_Convert, &ctx, runs);
+    CycleBench_Run(report, "integrate_float", Stage_IntegrateFloat, &ctx, runs);
+    CycleBench_Run(report, "bias_update_float", Stage_BiasUpdateFloat, &ctx, runs);
+    CycleBench_Run(report, "integrate_fixed", Stage_IntegrateFixed, &ctx, runs);
+    CycleBench_Run(report, "bias_update_fixed", Stage_BiasUpdateFixed, &ctx, runs);
+    CycleBench_Run(report, "pipeline_step", Stage_PipelineStep, &ctx, runs);
+    CycleBench_Run(report, "rate_filter", Stage_RateFilter, &ctx, runs);
+    CycleBench_Run(report, "fusion_combine", Stage_FusionCombine, &ctx, runs);
+    CycleBench_Run(report, "can_encode", Stage_CanEncode, &ctx, runs);
+    CycleBench_Run(report, "record_encode", Stage_RecordEncode, &ctx, runs);
+    CycleBench_Run(report, "full_iteration", Stage_FullIteration, &ctx, runs);
+    CycleBench_Run(report, "scheduled_iteration", Stage_ScheduledIteration, &ctx, runs);
+}
+
+/**
+ * @brief 结果格式化为JSON
+ * 
+ * {"platform":"stm32f103","timer_hz":72000000,"overhead":N,"ramfunc":N,
+ *  "stages":[{"name":"spi_read_rate","runs":101,"min":..,"median":..,"max":..},...]}
+ */
+size_t CycleBench_FormatJson(const CycleBench_Report *report, char *buf, size_t size)
+{
+    CycleBench_Writer w = { buf, size, 0 };
+    
+    Json_Str(&w, "{\"platform\":\"");
+    Json_Str(&w, report->platform);
+    Json_Str(&w, "\",");
+    Json_Field(&w, "timer_hz", report->timer_hz, false);
+    Json_Field(&w, "overhead", report->overhead, false);
+    Json_Field(&w, "ramfunc", report->ramfunc_bytes, false);
+    Json_Str(&w, "\"stages\":[");
+    for (int i = 0; i < report->count; i++)
+    {
+        const CycleBench_Result *r = &report->stages[i];
+        Json_Str(&w, i ? ",\n{\"name\":\"" : "\n{\"name\":\"");
+        Json_Str(&w, r->name);
+        Json_Str(&w, "\",");
+        Json_Field(&w, "runs", r->runs, false);
+        Json_Field(&w, "min", r->min, false);
+        Json_Field(&w, "median", r->median, false);
+        Json_Field(&w, "max", r->max, true);
+        Json_Str(&w, "}");
+    }
+    Json_Str(&w, "]}\n");
+    
+    if (size > 0)
+    {
+        buf[(w.len < size) ? w.len : size - 1] = '\0';
+    }
+    return (w.len < size) ? w.len : size - 1;
+}
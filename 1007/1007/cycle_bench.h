@@ -0,0 +1,79 @@
+#ifndef __CYCLE_BENCH_H
+#define __CYCLE_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f1xx_hal.h"
+#include "latency_hist.h"
+#include <stddef.h>
+
+/*============================================================================
+ * 热路径周期基准测试
+ * 
+ * 目标板以DWT周期计数器计时 (每次运行关中断), 主机以校准过的TSC计时.
+ * 每个阶段单独运行CYCLE_BENCH_RUNS次, 扣除计时开销后统计最小/中位/最大值,
+ * 结果以JSON输出, 便于在评审中比对回归.
+ * ramfunc字段标明构建是否启用SRAM常驻热路径, 与Flash构建对比时
+ * 比较中位数 (周期节省) 与max-min (抖动).
+ * 
+ * 目标板: 以CYCLE_BENCH=1编译, 启动时在创建任务前运行一次,
+ *         结果保存在g_cycle_bench_json (调试器读取), 随后正常启动
+ * 主机:   host/bench_cycles
+ *============================================================================*/
+#ifndef CYCLE_BENCH
+#define CYCLE_BENCH             0       /* 1=启动时运行基准测试 */
+#endif
+
+#define CYCLE_BENCH_RUNS        101     /* 每阶段运行次数 (奇数, 中位数取中间值) */
+#define CYCLE_BENCH_MAX_STAGES  16
+#define CYCLE_BENCH_JSON_SIZE   1536
+
+/* 单个阶段结果 (计时器周期, 已扣除计时开销) */
+typedef struct {
+    const char *name;
+    uint32_t runs;
+    uint32_t min;
+    uint32_t median;
+    uint32_t max;
+} CycleBench_Result;
+
+/* 一次完整测试的结果 */
+typedef struct {
+    const char *platform;
+    uint32_t timer_hz;          /* 计时器频率 */
+    uint32_t overhead;          /* 计时开销 (已从各阶段扣除) */
+    uint32_t ramfunc_bytes;     /* SRAM常驻代码字节数 (0=全部在Flash执行, 见ramfunc.h) */
+    int count;
+    CycleBench_Result stages[CYCLE_BENCH_MAX_STAGES];
+    LatencyHist *hists;         /* 非NULL时为各阶段填充直方图 (CYCLE_BENCH_MAX_STAGES个, 区间为min~max) */
+} CycleBench_Report;
+
+typedef void (*CycleBench_Fn)(void *ctx);
+
+/**
+ * @brief 测量一个阶段
+ * @param runs 运行次数, 不超过CYCLE_BENCH_RUNS
+ */
+void CycleBench_Run(CycleBench_Report *report, const char *name, CycleBench_Fn fn, void *ctx, uint32_t runs);
+
+/**
+ * @brief 运行全部热路径阶段 (需先完成SPI与XV7001BB初始化, 保留report->hists)
+ * 
+ * 阶段: 读状态/角速度/温度 (SPI)、原始值换算、积分、积分+零偏更新
+ * (浮点与定点)、流水线处理、角速度输出滤波 (4节)、CAN帧编码、采集记录编码、完整周期
+ */
+void CycleBench_RunAll(CycleBench_Report *report, uint32_t runs);
+
+/**
+ * @brief 结果格式化为JSON (不依赖printf)
+ * @return 写入的字符数 (不含结尾0), 缓冲区不足时截断
+ */
+size_t CycleBench_FormatJson(const CycleBench_Report *report, char *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CYCLE_BENCH_H */
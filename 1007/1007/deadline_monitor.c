@@ -0,0 +1,163 @@
+#include "deadline_monitor.h"
+#include "timestamp.h"
+#include "trace.h"
+#include <string.h>
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+#if DEADLINE_IWDG_ENABLE
+static IWDG_HandleTypeDef s_hiwdg;
+#endif
+
+static TickType_t s_period_ticks = 1;
+static uint32_t s_period_cycles;
+static TickType_t s_release;                   /* 本次循环的释放时刻 */
+static uint32_t s_start_cycles;                /* 本次循环开始的周期计数 */
+static bool s_started_late;                    /* 本次循环开始时已过截止时刻 */
+
+/* 主任务更新, 其他任务在临界区内读取 */
+static Deadline_Stats s_stats;
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+static void DeadlineMonitor_Put16(uint8_t *dst, uint32_t value)
+{
+    if (value > 0xFFFF)
+    {
+        value = 0xFFFF;
+    }
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief 启动IWDG: LSI 40kHz / 32 = 1250Hz, 重装值按DEADLINE_IWDG_TIMEOUT_MS
+ */
+static void DeadlineMonitor_StartWatchdog(void)
+{
+#if DEADLINE_IWDG_ENABLE
+    __HAL_DBGMCU_FREEZE_IWDG();                 /* 调试器暂停内核时看门狗同时暂停 */
+
+    s_hiwdg.Instance = IWDG;
+    s_hiwdg.Init.Prescaler = IWDG_PRESCALER_32;
+    s_hiwdg.Init.Reload = DEADLINE_IWDG_TIMEOUT_MS * 1250U / 1000U;
+    if (HAL_IWDG_Init(&s_hiwdg) == HAL_OK)
+    {
+        s_stats.flags |= DEADLINE_FLAG_IWDG_RUNNING;
+    }
+#endif
+}
+
+/*============================================================================
+ * 公共函数
+ *============================================================================*/
+
+void DeadlineMonitor_CheckResetCause(void)
+{
+    if (__HAL_RCC_GET_FLAG(RCC_FLAG_IWDGRST))
+    {
+        s_stats.flags |= DEADLINE_FLAG_IWDG_RESET;
+    }
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+}
+
+void DeadlineMonitor_Init(uint32_t period_ms)
+{
+    s_period_ticks = pdMS_TO_TICKS(period_ms);
+    if (s_period_ticks == 0)
+    {
+        s_period_ticks = 1;
+    }
+    s_period_cycles = period_ms * (SystemCoreClock / 1000U);
+    DeadlineMonitor_StartWatchdog();
+}
+
+void DeadlineMonitor_Begin(TickType_t release)
+{
+    s_start_cycles = Timestamp_Now();
+    s_release = release;
+    s_started_late = (TickType_t)(xTaskGetTickCount() - release) >= s_period_ticks;
+}
+
+bool DeadlineMonitor_End(void)
+{
+    uint32_t exec = Timestamp_Now() - s_start_cycles;
+    bool overrun = (TickType_t)(xTaskGetTickCount() - s_release) >= s_period_ticks || exec > s_period_cycles;
+
+    taskENTER_CRITICAL();
+    s_stats.iterations++;
+    s_stats.last_cycles = exec;
+    if (exec > s_stats.worst_cycles)
+    {
+        s_stats.worst_cycles = exec;
+    }
+    if (exec > s_stats.window_worst_cycles)
+    {
+        s_stats.window_worst_cycles = exec;
+    }
+    if (s_started_late)
+    {
+        s_stats.missed++;               /* 补齐的循环, 延迟由此前的超时造成 */
+    }
+    else if (overrun)
+    {
+        s_stats.overruns++;
+        s_stats.flags |= DEADLINE_FLAG_WINDOW_OVERRUN;
+    }
+    taskEXIT_CRITICAL();
+
+    if (s_started_late || overrun)
+    {
+        if (!s_started_late)
+        {
+            TRACE_MARK(TRACE_MARK_OVERRUN, Timestamp_CyclesToUs(exec));
+        }
+        return false;
+    }
+
+#if DEADLINE_IWDG_ENABLE
+    HAL_IWDG_Refresh(&s_hiwdg);
+#endif
+    return true;
+}
+
+void DeadlineMonitor_GetStats(Deadline_Stats *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = s_stats;
+    taskEXIT_CRITICAL();
+}
+
+void DeadlineMonitor_Encode(uint8_t *data)
+{
+    Deadline_Stats stats;
+
+    taskENTER_CRITICAL();
+    stats = s_stats;
+    s_stats.window_worst_cycles = 0;
+    s_stats.flags &= (uint8_t)~DEADLINE_FLAG_WINDOW_OVERRUN;
+    taskEXIT_CRITICAL();
+
+    uint32_t budget = (s_period_cycles > 0) ? (uint32_t)(((uint64_t)stats.window_worst_cycles * 100U) / s_period_cycles) : 0;
+
+    data[0] = stats.flags;
+    DeadlineMonitor_Put16(&data[1], stats.overruns);
+    DeadlineMonitor_Put16(&data[3], stats.missed);
+    DeadlineMonitor_Put16(&data[5], Timestamp_CyclesToUs(stats.worst_cycles));
+    data[7] = (budget > 255) ? 255 : (uint8_t)budget;
+}
+
+void DeadlineMonitor_Clear(void)
+{
+    taskENTER_CRITICAL();
+    s_stats.iterations = 0;
+    s_stats.overruns = 0;
+    s_stats.missed = 0;
+    s_stats.worst_cycles = 0;
+    s_stats.window_worst_cycles = 0;
+    s_stats.flags &= (uint8_t)~(DEADLINE_FLAG_WINDOW_OVERRUN | DEADLINE_FLAG_IWDG_RESET);
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,89 @@
+#ifndef __DEADLINE_MONITOR_H
+#define __DEADLINE_MONITOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f1xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdbool.h>
+
+/*============================================================================
+ * 周期任务截止时间监视 (Task_Main 10ms控制循环)
+ *
+ * 每次循环的释放时刻为vTaskDelayUntil的唤醒时刻, 截止时刻 = 释放 + 周期:
+ *   超时 (overrun):  按时开始, 但结束时已过截止时刻或执行时间超过一个周期
+ *   丢周期 (missed): 开始时已过截止时刻, 整个周期被此前的执行占用 (不再计为超时)
+ * vTaskDelayUntil在超时后连续返回补齐欠下的周期 (积分样本数不变),
+ * 补齐的循环开始时若已过各自的截止时刻即计为丢周期.
+ *
+ * 独立看门狗 (IWDG) 只在循环按时完成时喂狗: 连续超时超过
+ * DEADLINE_IWDG_TIMEOUT_MS (或任务停止运行) 即复位. 调试暂停时IWDG冻结.
+ *
+ * 统计经CAN_ID_DEADLINE每秒发送:
+ *   [0]=标志 [1-2]=累计超时次数 [3-4]=累计丢周期数 (饱和于65535)
+ *   [5-6]=最长执行时间(µs) [7]=最近窗口最长执行时间占周期的百分比 (饱和于255)
+ *============================================================================*/
+#define DEADLINE_IWDG_ENABLE        1       /* 0=只统计不启用看门狗 */
+#define DEADLINE_IWDG_TIMEOUT_MS    250     /* 看门狗超时 (LSI标称40kHz, 实际约160~330ms) */
+
+/* 标志 */
+#define DEADLINE_FLAG_IWDG_RESET    0x01    /* 上次复位由IWDG引起 */
+#define DEADLINE_FLAG_WINDOW_OVERRUN 0x02   /* 最近窗口内有超时 */
+#define DEADLINE_FLAG_IWDG_RUNNING  0x04    /* 看门狗已启动 */
+
+/* 统计 */
+typedef struct {
+    uint32_t iterations;        /* 循环次数 */
+    uint32_t overruns;          /* 超时次数 */
+    uint32_t missed;            /* 丢周期数 */
+    uint32_t last_cycles;       /* 最近一次执行时间 (DWT周期) */
+    uint32_t worst_cycles;      /* 最长执行时间 (DWT周期) */
+    uint32_t window_worst_cycles; /* 最近窗口最长执行时间 (DWT周期) */
+    uint8_t flags;              /* DEADLINE_FLAG_xxx */
+} Deadline_Stats;
+
+/**
+ * @brief 读取复位原因并清除复位标志 (main中尽早调用一次)
+ */
+void DeadlineMonitor_CheckResetCause(void);
+
+/**
+ * @brief 设置周期并启动看门狗 (进入控制循环前调用)
+ */
+void DeadlineMonitor_Init(uint32_t period_ms);
+
+/**
+ * @brief 循环开始 (vTaskDelayUntil返回后)
+ * @param release 本次释放时刻 (vTaskDelayUntil更新后的唤醒时刻)
+ */
+void DeadlineMonitor_Begin(TickType_t release);
+
+/**
+ * @brief 循环结束 (进入vTaskDelayUntil前): 统计, 按时完成时喂狗
+ * @return true=本次按时完成
+ */
+bool DeadlineMonitor_End(void);
+
+/**
+ * @brief 获取统计 (任意任务调用)
+ */
+void DeadlineMonitor_GetStats(Deadline_Stats *stats);
+
+/**
+ * @brief 打包8字节诊断帧并开始新的统计窗口 (发送任务调用)
+ */
+void DeadlineMonitor_Encode(uint8_t *data);
+
+/**
+ * @brief 清除计数与最长执行时间
+ */
+void DeadlineMonitor_Clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DEADLINE_MONITOR_H */
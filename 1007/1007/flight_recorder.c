@@ -0,0 +1,225 @@
+#include "flight_recorder.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+static FR_Block s_blocks[FR_BLOCK_COUNT];
+static uint8_t s_head;                          /* 当前写入块 */
+static uint8_t s_pos;                           /* 当前块payload写入位置 */
+static bool s_wrapped;                          /* 环形缓冲已回绕 */
+static bool s_empty = true;
+static int32_t s_last_raw;
+static uint32_t s_samples;
+static uint32_t s_overwritten;
+
+static volatile uint8_t s_trigger = FR_TRIGGER_NONE;
+static volatile uint32_t s_trigger_tick;
+static volatile uint16_t s_post_remaining;
+static volatile bool s_frozen;
+
+/* 导出状态 (仅CAN发送任务访问) */
+static bool s_dumping;
+static uint32_t s_dump_offset;
+static uint16_t s_dump_seq;
+static FR_DumpHeader s_dump_header;
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+/**
+ * @brief 开始新块
+ */
+static void FlightRecorder_NewBlock(int32_t raw, uint16_t temp_raw, uint8_t status)
+{
+    if (!s_empty)
+    {
+        if (++s_head >= FR_BLOCK_COUNT)
+        {
+            s_head = 0;
+            s_wrapped = true;
+        }
+        if (s_wrapped)
+        {
+            s_samples -= s_blocks[s_head].count;
+            s_overwritten++;
+        }
+    }
+    s_empty = false;
+    
+    FR_Block *blk = &s_blocks[s_head];
+    blk->tick = xTaskGetTickCount();
+    blk->raw0 = raw;
+    blk->temp_raw = temp_raw;
+    blk->status = status;
+    blk->count = 1;
+    s_pos = 0;
+}
+
+/**
+ * @brief 导出数据流中第offset字节
+ */
+static uint8_t FlightRecorder_DumpByte(uint32_t offset)
+{
+    if (offset < sizeof(FR_DumpHeader))
+    {
+        return ((const uint8_t *)&s_dump_header)[offset];
+    }
+    
+    offset -= sizeof(FR_DumpHeader);
+    uint32_t oldest = s_wrapped ? (s_head + 1U) % FR_BLOCK_COUNT : 0;
+    uint32_t index = (oldest + offset / sizeof(FR_Block)) % FR_BLOCK_COUNT;
+    return ((const uint8_t *)&s_blocks[index])[offset % sizeof(FR_Block)];
+}
+
+/*============================================================================
+ * 公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 记录一个样本
+ * 
+ * 热路径: 一次减法、zigzag变换和1~4次字节写入
+ */
+void FlightRecorder_Record(int32_t raw, uint16_t temp_raw, uint8_t status)
+{
+    if (s_frozen)
+    {
+        return;
+    }
+    
+    FR_Block *blk = &s_blocks[s_head];
+    int32_t delta = raw - s_last_raw;
+    uint32_t zz = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    s_last_raw = raw;
+    s_samples++;
+    
+    /* 状态变化、样本数或空间不足时开始新块 (预留4字节最大编码长度) */
+    if (s_empty || status != blk->status || blk->count == 0xFF ||
+        s_pos > FR_BLOCK_PAYLOAD - 4)
+    {
+        FlightRecorder_NewBlock(raw, temp_raw, status);
+    }
+    else
+    {
+        while (zz >= 0x80)
+        {
+            blk->payload[s_pos++] = (uint8_t)(zz | 0x80);
+            zz >>= 7;
+        }
+        blk->payload[s_pos++] = (uint8_t)zz;
+        blk->count++;
+    }
+    
+    if (s_trigger != FR_TRIGGER_NONE && s_post_remaining > 0)
+    {
+        if (--s_post_remaining == 0)
+        {
+            s_frozen = true;
+        }
+    }
+}
+
+/**
+ * @brief 触发冻结
+ */
+void FlightRecorder_Trigger(FR_Trigger reason)
+{
+    taskENTER_CRITICAL();
+    if (s_trigger == FR_TRIGGER_NONE && !s_empty)
+    {
+        s_trigger = (uint8_t)reason;
+        s_trigger_tick = xTaskGetTickCount();
+        s_post_remaining = FR_POST_TRIGGER_SAMPLES;
+        
+        /* 传感器未就绪时不会再有新样本, 立即冻结 */
+        if (reason == FR_TRIGGER_NOT_READY)
+        {
+            s_post_remaining = 0;
+            s_frozen = true;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 是否已冻结
+ */
+bool FlightRecorder_IsFrozen(void)
+{
+    return s_frozen;
+}
+
+/**
+ * @brief 清空并重新开始记录
+ */
+void FlightRecorder_Rearm(void)
+{
+    taskENTER_CRITICAL();
+    s_head = 0;
+    s_pos = 0;
+    s_wrapped = false;
+    s_empty = true;
+    s_samples = 0;
+    s_overwritten = 0;
+    s_trigger = FR_TRIGGER_NONE;
+    s_post_remaining = 0;
+    s_dumping = false;
+    s_frozen = false;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief 开始导出
+ */
+bool FlightRecorder_StartDump(void)
+{
+    if (!s_frozen)
+    {
+        return false;
+    }
+    
+    s_dump_header.version = FR_DUMP_VERSION;
+    s_dump_header.trigger = s_trigger;
+    s_dump_header.block_count = s_wrapped ? FR_BLOCK_COUNT : (uint8_t)(s_head + 1U);
+    s_dump_header.block_size = (uint8_t)sizeof(FR_Block);
+    s_dump_header.trigger_tick = s_trigger_tick;
+    s_dump_header.samples = s_samples;
+    s_dump_header.overwritten = s_overwritten;
+    
+    s_dump_offset = 0;
+    s_dump_seq = 0;
+    s_dumping = true;
+    return true;
+}
+
+/**
+ * @brief 取下一导出帧
+ */
+bool FlightRecorder_NextDumpFrame(uint8_t frame[8])
+{
+    uint32_t total = sizeof(FR_DumpHeader) + (uint32_t)s_dump_header.block_count * sizeof(FR_Block);
+    
+    if (!s_dumping || !s_frozen)
+    {
+        return false;
+    }
+    
+    frame[0] = (uint8_t)(s_dump_seq & 0xFF);
+    frame[1] = (uint8_t)(s_dump_seq >> 8);
+    for (int i = 2; i < 8; i++)
+    {
+        frame[i] = (s_dump_offset < total) ? FlightRecorder_DumpByte(s_dump_offset) : 0xFF;
+        s_dump_offset++;
+    }
+    s_dump_seq++;
+    
+    if (s_dump_offset >= total)
+    {
+        s_dumping = false;
+    }
+    return true;
+}
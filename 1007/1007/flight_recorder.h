@@ -0,0 +1,93 @@
+#ifndef __FLIGHT_RECORDER_H
+#define __FLIGHT_RECORDER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f1xx_hal.h"
+#include <stdbool.h>
+
+/*============================================================================
+ * 飞行记录仪 (RAM环形缓冲)
+ * 
+ * 按块记录最近约15秒的原始角速度, 块内为zigzag变长差分编码:
+ *   |差分| < 64 占1字节, < 8192 占2字节, < 2^20 占3字节, 其余4字节
+ * 静止时每样本约2字节, 状态变化或块满时开始新块.
+ * 触发后继续记录FR_POST_TRIGGER_SAMPLES个样本再冻结, 冻结后可经CAN导出.
+ *============================================================================*/
+#define FR_BLOCK_COUNT              25      /* 块数 (共3400字节) */
+#define FR_BLOCK_PAYLOAD            124     /* 每块差分数据字节数 */
+#define FR_POST_TRIGGER_SAMPLES     100     /* 触发后继续记录的样本数 (1秒@100Hz) */
+#define FR_DUMP_VERSION             1
+
+/* 触发源 */
+typedef enum {
+    FR_TRIGGER_NONE = 0,
+    FR_TRIGGER_NOT_READY = 1,   /* 传感器未就绪 */
+    FR_TRIGGER_RATE_SPIKE = 2,  /* 角速度跳变 */
+    FR_TRIGGER_COMMAND = 3      /* CAN命令 */
+} FR_Trigger;
+
+/* 记录块 (136字节) */
+typedef struct {
+    uint32_t tick;              /* 首样本时刻 (ms) */
+    int32_t raw0;               /* 首样本原始值 */
+    uint16_t temp_raw;          /* 温度原始值 (块内不变) */
+    uint8_t status;             /* 状态寄存器 (块内不变) */
+    uint8_t count;              /* 样本数 (含首样本) */
+    uint8_t payload[FR_BLOCK_PAYLOAD];
+} FR_Block;
+
+/* 导出数据头 (16字节), 其后按时间顺序跟随block_count个FR_Block */
+typedef struct {
+    uint8_t version;
+    uint8_t trigger;            /* FR_Trigger */
+    uint8_t block_count;
+    uint8_t block_size;         /* sizeof(FR_Block) */
+    uint32_t trigger_tick;      /* 触发时刻 (ms) */
+    uint32_t samples;           /* 缓冲内样本总数 */
+    uint32_t overwritten;       /* 被覆盖的块数 */
+} FR_DumpHeader;
+
+/**
+ * @brief 记录一个样本 (采集任务调用)
+ * @param raw 原始角速度
+ * @param temp_raw 最近一次温度原始值
+ * @param status 状态寄存器原始值
+ */
+void FlightRecorder_Record(int32_t raw, uint16_t temp_raw, uint8_t status);
+
+/**
+ * @brief 触发冻结 (已触发或尚无数据时忽略)
+ */
+void FlightRecorder_Trigger(FR_Trigger reason);
+
+/**
+ * @brief 是否已冻结 (触发且后置样本记录完成)
+ */
+bool FlightRecorder_IsFrozen(void);
+
+/**
+ * @brief 清空并重新开始记录
+ */
+void FlightRecorder_Rearm(void);
+
+/**
+ * @brief 开始导出 (仅冻结后有效)
+ * @return true=开始导出
+ */
+bool FlightRecorder_StartDump(void);
+
+/**
+ * @brief 取下一导出帧
+ * @param frame 输出8字节: [0-1]帧序号uint16小端, [2-7]数据
+ * @return true=有帧待发送
+ */
+bool FlightRecorder_NextDumpFrame(uint8_t frame[8]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLIGHT_RECORDER_H */
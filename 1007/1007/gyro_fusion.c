@@ -0,0 +1,798 @@
+#include "gyro_fusion.h"
+#include "gyro_pipeline.h"
+#include "latency_hist.h"
+#include "timestamp.h"
+#include "spi.h"
+#include "ramfunc.h"
+#include <string.h>
+#include <math.h>
+
+#define GYRO_FUSION_ALL             ((1U << GYRO_FUSION_MAX_SENSORS) - 1U)
+#define GYRO_FUSION_NOISE_FLOOR_LSB (GYRO_FUSION_NOISE_FLOOR_DPS * XV7_GYRO_SENSITIVITY_24BIT)
+#define GYRO_FUSION_OUTLIER_MIN_LSB (GYRO_FUSION_OUTLIER_MIN_DPS * XV7_GYRO_SENSITIVITY_24BIT)
+
+/*============================================================================
+ * 融合
+ *============================================================================*/
+
+static uint8_t GyroFusion_Count(uint8_t bits)
+{
+    uint8_t n = 0;
+    for (; bits != 0; bits &= (uint8_t)(bits - 1))
+    {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief 参与者的中位数 (偶数个时取中间两个的均值)
+ */
+static float GyroFusion_Median(const float *c, uint8_t members)
+{
+    float v[GYRO_FUSION_MAX_SENSORS];
+    uint8_t n = 0;
+
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        if (members & (1U << i))
+        {
+            /* 插入排序 */
+            uint8_t j = n++;
+            while (j > 0 && v[j - 1] > c[i])
+            {
+                v[j] = v[j - 1];
+                j--;
+            }
+            v[j] = c[i];
+        }
+    }
+    return (n & 1) ? v[n / 2] : 0.5f * (v[n / 2 - 1] + v[n / 2]);
+}
+
+/**
+ * @brief |c - ref| 是否超过该传感器的剔除门限 (比较平方, 不开方)
+ */
+static bool GyroFusion_IsOutlier(const GyroFusion_Sensor *s, float c, float ref)
+{
+    float d = c - ref;
+    float floor_thr = GYRO_FUSION_OUTLIER_MIN_LSB + GYRO_FUSION_OUTLIER_REL * fabsf(ref);
+    float thr2 = GYRO_FUSION_OUTLIER_SIGMA * GYRO_FUSION_OUTLIER_SIGMA * s->noise_var;
+
+    if (thr2 < floor_thr * floor_thr)
+    {
+        thr2 = floor_thr * floor_thr;
+    }
+    return d * d > thr2;
+}
+
+/**
+ * @brief 有效读数减去offset, 返回其中OK状态的传感器 (位图)
+ */
+static uint8_t GyroFusion_Correct(const GyroFusion *f, const GyroFusion_Input *in, float *c)
+{
+    uint8_t members = 0;
+
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        if (in->valid & (1U << i))
+        {
+            c[i] = (float)in->raw[i] - f->sensors[i].offset;
+            if (f->sensors[i].state == GYRO_SENSOR_OK)
+            {
+                members |= (uint8_t)(1U << i);
+            }
+        }
+    }
+    return members;
+}
+
+static void GyroFusion_SetState(GyroFusion *f, uint8_t index, uint8_t state)
+{
+    GyroFusion_Sensor *s = &f->sensors[index];
+
+    s->state = state;
+    s->bad_cycles = 0;
+    s->samples = 0;
+    f->changed |= (uint8_t)(1U << index);
+}
+
+void GyroFusion_Init(GyroFusion *f, uint8_t mask)
+{
+    memset(f, 0, sizeof(GyroFusion));
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        f->sensors[i].state = (mask & (1U << i)) ? GYRO_SENSOR_OK : GYRO_SENSOR_ABSENT;
+    }
+}
+
+void GyroFusion_Relearn(GyroFusion *f)
+{
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        f->sensors[i].offset = 0.0f;
+        f->sensors[i].noise_var = 0.0f;
+    }
+    f->learn = 0;
+}
+
+void GyroFusion_Fail(GyroFusion *f, uint8_t index)
+{
+    if (index < GYRO_FUSION_MAX_SENSORS && f->sensors[index].state != GYRO_SENSOR_ABSENT)
+    {
+        f->sensors[index].faults++;
+        GyroFusion_SetState(f, index, GYRO_SENSOR_FAILED);
+    }
+}
+
+bool GyroFusion_Disagree(const GyroFusion *f, const GyroFusion_Input *in)
+{
+    float c[GYRO_FUSION_MAX_SENSORS];
+    uint8_t members = GyroFusion_Correct(f, in, c);
+
+    if (f->learn < GYRO_FUSION_LEARN_SAMPLES || GyroFusion_Count(members) < 2)
+    {
+        return false;
+    }
+
+    float ref = GyroFusion_Median(c, members);
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        if ((members & (1U << i)) && GyroFusion_IsOutlier(&f->sensors[i], c[i], ref))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+RAMFUNC bool GyroFusion_Combine(GyroFusion *f, const GyroFusion_Input *in, int32_t *fused)
+{
+    float c[GYRO_FUSION_MAX_SENSORS];
+    float w[GYRO_FUSION_MAX_SENSORS];
+    float out = 0.0f;
+    uint8_t members = GyroFusion_Correct(f, in, c);
+    uint8_t fresh = in->valid & (uint8_t)~in->held;     /* 本周期读到的新读数 */
+    bool learning;
+
+    // 没有OK传感器 (全部失效后恢复, 或单传感器恢复): 有效的传感器重新开始
+    if (members == 0 && fresh != 0)
+    {
+        bool any_ok = false;
+        for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+        {
+            any_ok = any_ok || f->sensors[i].state == GYRO_SENSOR_OK;
+        }
+        if (!any_ok)
+        {
+            GyroFusion_Relearn(f);
+            for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+            {
+                if ((fresh & (1U << i)) && f->sensors[i].state != GYRO_SENSOR_ABSENT)
+                {
+                    GyroFusion_SetState(f, i, GYRO_SENSOR_OK);
+                }
+            }
+            members = GyroFusion_Correct(f, in, c);
+        }
+    }
+    learning = f->learn < GYRO_FUSION_LEARN_SAMPLES;
+
+    // 剔除 (多数表决, 至少3个参与)
+    if (!learning && GyroFusion_Count(members) >= 3)
+    {
+        float ref = GyroFusion_Median(c, members);
+        uint8_t kept = members;
+        for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+        {
+            if ((members & (1U << i)) && GyroFusion_IsOutlier(&f->sensors[i], c[i], ref))
+            {
+                kept &= (uint8_t)~(1U << i);
+                f->sensors[i].outliers++;
+            }
+        }
+        members = kept;
+    }
+
+    // 加权平均 (单个参与者直接取其读数, 与单传感器逐位一致)
+    uint8_t n = GyroFusion_Count(members);
+    if (n == 1)
+    {
+        for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+        {
+            w[i] = (members & (1U << i)) ? 1.0f : 0.0f;
+            out = (members & (1U << i)) ? c[i] : out;
+        }
+    }
+    else if (n > 1)
+    {
+        float sum_w = 0.0f, sum_wc = 0.0f;
+        for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+        {
+            w[i] = 0.0f;
+            if (members & (1U << i))
+            {
+                float var = f->sensors[i].noise_var;
+                float floor_var = GYRO_FUSION_NOISE_FLOOR_LSB * GYRO_FUSION_NOISE_FLOOR_LSB;
+                w[i] = 1.0f / ((var > floor_var) ? var : floor_var);
+                sum_w += w[i];
+                sum_wc += w[i] * c[i];
+            }
+        }
+        out = sum_wc / sum_w;
+        for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+        {
+            w[i] /= sum_w;
+        }
+
+        // 跟踪offset与σ² (学习期为累计均值). σ²的残差取相对其他参与者的均值:
+        // 相对融合值时权重大的传感器残差更小, 权重会自我强化
+        float a_off = learning ? 1.0f / (float)(f->learn + 1) : GYRO_FUSION_OFFSET_ALPHA;
+        float a_var = learning ? 1.0f / (float)(f->learn + 1) : GYRO_FUSION_NOISE_ALPHA;
+        float sum_c = 0.0f;
+        for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+        {
+            sum_c += (members & (1U << i)) ? c[i] : 0.0f;
+        }
+        for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+        {
+            if (members & fresh & (1U << i))
+            {
+                GyroFusion_Sensor *s = &f->sensors[i];
+                float r = c[i] - (sum_c - c[i]) / (float)(n - 1);
+                s->offset += a_off * (c[i] - out);
+                s->noise_var += a_var * (r * r - s->noise_var);
+            }
+        }
+    }
+    else
+    {
+        memset(w, 0, sizeof(w));
+    }
+
+    // 各传感器健康状态
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        GyroFusion_Sensor *s = &f->sensors[i];
+        bool valid = (fresh & (1U << i)) != 0;
+
+        s->weight = w[i];
+        switch (s->state)
+        {
+        case GYRO_SENSOR_OK:
+            if (members & fresh & (1U << i))
+            {
+                s->bad_cycles = 0;
+            }
+            else
+            {
+                s->faults++;
+                if (++s->bad_cycles >= GYRO_FUSION_FAIL_CYCLES)
+                {
+                    GyroFusion_SetState(f, i, GYRO_SENSOR_FAILED);
+                }
+            }
+            break;
+
+        case GYRO_SENSOR_LEARNING:
+            if (!valid)
+            {
+                s->faults++;
+                GyroFusion_SetState(f, i, GYRO_SENSOR_FAILED);
+            }
+            else if (n > 0)
+            {
+                // 相对当前融合值重新学习 (累计均值)
+                float k = 1.0f / (float)(s->samples + 1);
+                s->offset += k * ((float)in->raw[i] - out - s->offset);
+                float r = (float)in->raw[i] - s->offset - out;
+                s->noise_var += k * (r * r - s->noise_var);
+                if (++s->samples >= GYRO_FUSION_LEARN_SAMPLES)
+                {
+                    GyroFusion_SetState(f, i, GYRO_SENSOR_OK);
+                }
+            }
+            break;
+
+        case GYRO_SENSOR_FAILED:
+            if (valid)
+            {
+                GyroFusion_SetState(f, i, GYRO_SENSOR_LEARNING);
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (learning && n > 0)
+    {
+        f->learn++;
+    }
+    f->used = members;
+    if (n > 0)
+    {
+        *fused = (int32_t)lrintf(out);
+    }
+    return n > 0;
+}
+
+/*============================================================================
+ * 固件传感器组
+ *============================================================================*/
+static XV7_Device s_devices[GYRO_FUSION_MAX_SENSORS] = {
+    XV7_DEVICE_INIT(SPI2_NSS_PORT, SPI2_NSS_PIN),
+    XV7_DEVICE_INIT(SPI2_CS2_PORT, SPI2_CS2_PIN),
+    XV7_DEVICE_INIT(SPI2_CS3_PORT, SPI2_CS3_PIN),
+    XV7_DEVICE_INIT(SPI2_CS4_PORT, SPI2_CS4_PIN),
+};
+
+static GyroFusion s_fusion;                     /* 仅由Task_Main访问 */
+static uint8_t s_mask;                          /* 装配位图 */
+static uint8_t s_ready;                         /* 最近一次状态读取成功且就绪 (位图) */
+static uint8_t s_status_raw[GYRO_FUSION_MAX_SENSORS];
+static uint8_t s_rr;                            /* 本周期第一个读取的传感器 */
+static bool s_relearn;                          /* 零点校准后下一次融合前重新学习 */
+static volatile int s_report_index = -1;       /* -1=未在应答 */
+
+/* 读数故障统计 (Task_Main累计, 应答时读取) */
+typedef struct {
+    uint32_t counts[XV7_FAULT_CLASSES];         /* 各分类检测次数 ([0]不用) */
+    uint32_t retries;
+    uint32_t rejected;                          /* 重试后仍无效的读取 */
+    uint32_t flagged;                           /* 检测到故障后标记为FAILED的次数 */
+    uint32_t last_latency_us;                   /* 检测→FAILED */
+    uint32_t worst_latency_us;
+    uint32_t detect_cycles;                     /* 本次故障首次检测时刻 */
+    bool detecting;
+    uint8_t last_fault;
+} GyroSensors_FaultStats;
+
+static volatile GyroSensors_FaultStats s_faults[GYRO_FUSION_MAX_SENSORS];
+static uint8_t s_retry_budget;                  /* 本周期剩余重试次数 */
+static uint8_t s_spi_timeouts;                  /* 本周期HAL超时次数 */
+static volatile bool s_clear_faults;
+static volatile int s_fault_report = -1;       /* 传感器*页数+页, -1=未在应答 */
+
+/**
+ * @brief 记录一次读取的故障, 允许重试时消耗预算并返回true
+ * FAILED状态的传感器只是探测是否恢复, 输出冻结与跳变重读只会读回同一个值
+ * (输出寄存器在内部更新之间保持), 三者都不重试;
+ * HAL超时每周期只重试一次 (每次最多XV7_SPI_TIMEOUT_MS, 见gyro_fusion.h)
+ */
+RAMFUNC static bool GyroSensors_Fault(uint8_t index, XV7_Status ret, uint8_t *attempts)
+{
+    volatile GyroSensors_FaultStats *st = &s_faults[index];
+    uint8_t fault = s_devices[index].fault;
+
+    if (ret != XV7_ERR_SPI && ret != XV7_ERR_DATA)
+    {
+        return false;
+    }
+
+    st->counts[fault]++;
+    st->last_fault = fault;
+    if (fault == XV7_FAULT_SPI && s_spi_timeouts < GYRO_SENSORS_SPI_TIMEOUTS)
+    {
+        s_spi_timeouts++;
+    }
+    if (!st->detecting)
+    {
+        st->detecting = true;
+        st->detect_cycles = Timestamp_Now();
+    }
+    if (fault != XV7_FAULT_STUCK && fault != XV7_FAULT_JUMP && s_fusion.sensors[index].state != GYRO_SENSOR_FAILED &&
+        !(fault == XV7_FAULT_SPI && s_spi_timeouts >= GYRO_SENSORS_SPI_TIMEOUTS) &&
+        *attempts < GYRO_SENSORS_READ_RETRIES && s_retry_budget > 0)
+    {
+        (*attempts)++;
+        s_retry_budget--;
+        st->retries++;
+        return true;
+    }
+    st->rejected++;
+    return false;
+}
+
+/**
+ * @brief 本周期HAL超时已达上限 (总线失效): 不再访问SPI, 按SPI故障处理
+ */
+RAMFUNC static bool GyroSensors_BusDown(uint8_t index)
+{
+    if (s_spi_timeouts < GYRO_SENSORS_SPI_TIMEOUTS)
+    {
+        return false;
+    }
+    s_devices[index].fault = XV7_FAULT_SPI;
+    return true;
+}
+
+/**
+ * @brief 读一个传感器的状态 (有限重试), 更新就绪位
+ */
+static XV7_Status GyroSensors_ReadOne(uint8_t index, XV7_StatusReg *status)
+{
+    XV7_Status ret;
+    uint8_t attempts = 0;
+    uint8_t bit = (uint8_t)(1U << index);
+
+    do
+    {
+        ret = GyroSensors_BusDown(index) ? XV7_ERR_SPI : XV7001bb_ReadStatus(&s_devices[index], status);
+    } while (GyroSensors_Fault(index, ret, &attempts));
+    if (ret != XV7_OK)
+    {
+        status->raw = 0;
+    }
+
+    s_status_raw[index] = status->raw;
+    if (ret == XV7_OK && GyroPipeline_StatusReady(status->raw))
+    {
+        s_ready |= bit;
+    }
+    else
+    {
+        s_ready &= (uint8_t)~bit;
+    }
+    return ret;
+}
+
+/**
+ * @brief 写入16-bit小端字段, 按[min, max]饱和
+ */
+static void GyroSensors_Put16(uint8_t *dst, float value, float min, float max)
+{
+    int32_t v = (int32_t)lrintf((value > max) ? max : (value < min) ? min : value);
+    dst[0] = (uint8_t)(v & 0xFF);
+    dst[1] = (uint8_t)((v >> 8) & 0xFF);
+}
+
+/**
+ * @brief 写入16-bit小端计数, 饱和
+ */
+static void GyroSensors_PutCount(uint8_t *dst, uint32_t value)
+{
+    if (value > 0xFFFF)
+    {
+        value = 0xFFFF;
+    }
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+void GyroSensors_Init(uint8_t mask)
+{
+    s_mask = mask & GYRO_FUSION_ALL;
+    s_ready = 0;
+    s_rr = 0;
+    s_relearn = false;
+    memset(s_status_raw, 0, sizeof(s_status_raw));
+    GyroFusion_Init(&s_fusion, s_mask);
+    s_fusion.changed = 0;
+    memset((void *)s_faults, 0, sizeof(s_faults));
+    s_retry_budget = GYRO_SENSORS_RETRY_BUDGET;
+    s_spi_timeouts = 0;
+}
+
+XV7_Device *GyroSensors_Device(uint8_t index)
+{
+    return &s_devices[index % GYRO_FUSION_MAX_SENSORS];
+}
+
+void GyroSensors_Command(uint8_t reg, uint8_t data)
+{
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        if (s_mask & (1U << i))
+        {
+            XV7001bb_WriteData(&s_devices[i], reg, data);
+        }
+    }
+}
+
+void GyroSensors_Wake(void)
+{
+    GyroSensors_Command(XV7_REG_SLEEP_OUT, 0x00);
+}
+
+XV7_Status GyroSensors_PollReady(void)
+{
+    XV7_Status result = XV7_OK;
+
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        uint8_t bit = (uint8_t)(1U << i);
+        if (!(s_mask & bit) || s_fusion.sensors[i].state == GYRO_SENSOR_FAILED)
+        {
+            continue;
+        }
+        if (XV7001bb_PollReady(&s_devices[i]) == XV7_OK)
+        {
+            s_ready |= bit;
+        }
+        else
+        {
+            s_ready &= (uint8_t)~bit;
+            result = XV7_ERR_NOT_READY;
+        }
+    }
+    return result;
+}
+
+uint8_t GyroSensors_DropUnready(void)
+{
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        if ((s_mask & (1U << i)) && !(s_ready & (1U << i)))
+        {
+            GyroFusion_Fail(&s_fusion, i);
+        }
+    }
+    return GyroFusion_Count(s_ready & s_mask);
+}
+
+XV7_Status GyroSensors_ReadStatus(XV7_StatusReg *status)
+{
+    XV7_StatusReg reg[GYRO_FUSION_MAX_SENSORS];
+    XV7_Status ret[GYRO_FUSION_MAX_SENSORS];
+    int pick = -1, any = -1, first = -1;
+
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        uint8_t bit = (uint8_t)(1U << i);
+        if (!(s_mask & bit))
+        {
+            continue;
+        }
+        ret[i] = GyroSensors_ReadOne(i, &reg[i]);
+        first = (first < 0) ? i : first;
+        if (s_ready & bit)
+        {
+            any = (any < 0) ? i : any;
+            pick = (pick < 0 && s_fusion.sensors[i].state == GYRO_SENSOR_OK) ? i : pick;
+        }
+    }
+
+    pick = (pick >= 0) ? pick : (any >= 0) ? any : first;
+    if (pick < 0)
+    {
+        return XV7_ERR_NOT_READY;
+    }
+    *status = reg[pick];
+    return ret[pick];
+}
+
+RAMFUNC XV7_Status GyroSensors_ReadRate(XV7_GyroData *gyro)
+{
+    GyroFusion_Input in;
+    XV7_GyroData data;
+    int32_t fused;
+
+    if (s_relearn)
+    {
+        s_relearn = false;
+        GyroFusion_Relearn(&s_fusion);
+    }
+
+    // 轮转读取: 起始传感器逐周期轮换
+    in.valid = 0;
+    in.held = 0;
+    for (uint8_t k = 0; k < GYRO_FUSION_MAX_SENSORS; k++)
+    {
+        uint8_t i = (uint8_t)((s_rr + k) % GYRO_FUSION_MAX_SENSORS);
+        uint8_t bit = (uint8_t)(1U << i);
+        uint8_t attempts = 0;
+        XV7_Status ret;
+        in.raw[i] = 0;
+        if (!(s_mask & s_ready & bit))
+        {
+            continue;
+        }
+        do
+        {
+            ret = GyroSensors_BusDown(i) ? XV7_ERR_SPI : XV7001bb_ReadAngle(&s_devices[i], &data);
+        } while (GyroSensors_Fault(i, ret, &attempts));
+        if (ret == XV7_OK)
+        {
+            in.raw[i] = data.raw;
+            in.valid |= bit;
+            s_faults[i].detecting = false;
+        }
+        else if (ret == XV7_ERR_DATA && s_devices[i].fault == XV7_FAULT_JUMP)
+        {
+            /* 跳变未接受: 本周期沿用上次接受的读数, 计为异常周期 */
+            in.raw[i] = s_devices[i].last_raw;
+            in.valid |= bit;
+            in.held |= bit;
+        }
+    }
+    s_rr = (uint8_t)((s_rr + 1) % GYRO_FUSION_MAX_SENSORS);
+
+    // 读数不一致: 立即确认各传感器状态, 未就绪的本周期不参与
+    if (GyroFusion_Disagree(&s_fusion, &in))
+    {
+        for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+        {
+            XV7_StatusReg status;
+            if (!(in.valid & (1U << i)))
+            {
+                continue;
+            }
+            GyroSensors_ReadOne(i, &status);
+            if (!(s_ready & (1U << i)))
+            {
+                in.valid &= (uint8_t)~(1U << i);
+            }
+        }
+    }
+
+    bool ok = GyroFusion_Combine(&s_fusion, &in, &fused);
+
+    // 检测到故障的传感器被标记为FAILED: 记录检测→标记延迟
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        volatile GyroSensors_FaultStats *st = &s_faults[i];
+        if ((s_fusion.changed & (1U << i)) && s_fusion.sensors[i].state == GYRO_SENSOR_FAILED && st->detecting)
+        {
+            uint32_t cycles = Timestamp_Now() - st->detect_cycles;
+            uint32_t us = Timestamp_CyclesToUs(cycles);
+            st->last_latency_us = us;
+            st->worst_latency_us = (us > st->worst_latency_us) ? us : st->worst_latency_us;
+            st->flagged++;
+            st->detecting = false;
+            Latency_Record(LATENCY_FAULT_TO_FLAG, cycles);
+        }
+    }
+    if (s_fusion.changed != 0)
+    {
+        s_fusion.changed = 0;
+        GyroSensors_StartReport();
+    }
+    if (!ok)
+    {
+        return XV7_ERR_NOT_READY;
+    }
+    gyro->raw = fused;
+    gyro->dps = (float)fused / XV7_GYRO_SENSITIVITY_24BIT;
+    return XV7_OK;
+}
+
+XV7_Status GyroSensors_ReadTemp(XV7_TempData *temp)
+{
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        if (s_fusion.used & (1U << i))
+        {
+            XV7_Status ret;
+            uint8_t attempts = 0;
+            do
+            {
+                ret = GyroSensors_BusDown(i) ? XV7_ERR_SPI : XV7001bb_ReadTmp(&s_devices[i], temp);
+            } while (GyroSensors_Fault(i, ret, &attempts));
+            return ret;
+        }
+    }
+    return XV7_ERR_NOT_READY;
+}
+
+XV7_Status GyroSensors_Configure(const XV7_Config *cfg)
+{
+    XV7_Status first = XV7_OK;
+
+    for (uint8_t i = 0; i < GYRO_FUSION_MAX_SENSORS; i++)
+    {
+        if (s_mask & (1U << i))
+        {
+            XV7_Status ret = XV7001bb_Configure(&s_devices[i], cfg);
+            first = (first != XV7_OK) ? first : ret;
+        }
+    }
+    return first;
+}
+
+void GyroSensors_ZeroCalibrate(void)
+{
+    GyroSensors_Command(XV7_REG_ZERO_CAL, 0x01);
+    s_relearn = true;
+}
+
+void GyroSensors_StartReport(void)
+{
+    s_report_index = 0;
+}
+
+bool GyroSensors_NextReportFrame(uint8_t *data)
+{
+    int index = s_report_index;
+
+    while (index >= 0 && index < GYRO_FUSION_MAX_SENSORS && !(s_mask & (1U << index)))
+    {
+        index++;
+    }
+    if (index < 0 || index >= GYRO_FUSION_MAX_SENSORS)
+    {
+        s_report_index = -1;
+        return false;
+    }
+
+    const GyroFusion_Sensor *s = &s_fusion.sensors[index];
+    data[0] = (uint8_t)index;
+    data[1] = s->state;
+    data[2] = (uint8_t)lrintf(s->weight * 100.0f);
+    data[3] = s_status_raw[index];
+    GyroSensors_Put16(&data[4], s->offset * 1000.0f / XV7_GYRO_SENSITIVITY_24BIT, -32768.0f, 32767.0f);
+    GyroSensors_Put16(&data[6], sqrtf(s->noise_var) * 10000.0f / XV7_GYRO_SENSITIVITY_24BIT, 0.0f, 65535.0f);
+
+    s_report_index = index + 1;
+    return true;
+}
+
+void GyroSensors_BeginCycle(void)
+{
+    if (s_clear_faults)
+    {
+        s_clear_faults = false;
+        memset((void *)s_faults, 0, sizeof(s_faults));
+    }
+    s_retry_budget = GYRO_SENSORS_RETRY_BUDGET;
+    s_spi_timeouts = 0;
+}
+
+void GyroSensors_ClearFaults(void)
+{
+    s_clear_faults = true;
+}
+
+void GyroSensors_StartFaultReport(void)
+{
+    s_fault_report = 0;
+}
+
+bool GyroSensors_NextFaultFrame(uint8_t *data)
+{
+    int item = s_fault_report;
+
+    while (item >= 0 && item < GYRO_FUSION_MAX_SENSORS * GYRO_SENSORS_FAULT_PAGES &&
+           !(s_mask & (1U << (item / GYRO_SENSORS_FAULT_PAGES))))
+    {
+        item += GYRO_SENSORS_FAULT_PAGES;
+    }
+    if (item < 0 || item >= GYRO_FUSION_MAX_SENSORS * GYRO_SENSORS_FAULT_PAGES)
+    {
+        s_fault_report = -1;
+        return false;
+    }
+
+    uint8_t index = (uint8_t)(item / GYRO_SENSORS_FAULT_PAGES);
+    uint8_t page = (uint8_t)(item % GYRO_SENSORS_FAULT_PAGES);
+    volatile const GyroSensors_FaultStats *st = &s_faults[index];
+
+    data[0] = (uint8_t)((index << 4) | page);
+    switch (page)
+    {
+    case 0:
+        data[1] = st->last_fault;
+        GyroSensors_PutCount(&data[2], st->counts[XV7_FAULT_SPI]);
+        GyroSensors_PutCount(&data[4], st->counts[XV7_FAULT_ONES]);
+        GyroSensors_PutCount(&data[6], st->counts[XV7_FAULT_ZEROS]);
+        break;
+
+    case 1:
+        data[1] = s_fusion.sensors[index].state;
+        GyroSensors_PutCount(&data[2], st->counts[XV7_FAULT_STUCK]);
+        GyroSensors_PutCount(&data[4], st->counts[XV7_FAULT_JUMP]);
+        GyroSensors_PutCount(&data[6], st->retries);
+        break;
+
+    default:
+        data[1] = (uint8_t)((st->flagged > 0xFF) ? 0xFF : st->flagged);
+        GyroSensors_PutCount(&data[2], st->rejected);
+        GyroSensors_PutCount(&data[4], st->last_latency_us / 100U);
+        GyroSensors_PutCount(&data[6], st->worst_latency_us / 100U);
+        break;
+    }
+
+    s_fault_report = item + 1;
+    return true;
+}
@@ -0,0 +1,250 @@
+#ifndef __GYRO_FUSION_H
+#define __GYRO_FUSION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xv7001bb.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================
+ * 多陀螺仪融合
+ *
+ * SPI2上最多4个XV7001BB (片选PB12/PB0/PB1/PB10, 见spi.h), 装配情况由位图给出
+ * (GYRO_FUSION_SENSOR_MASK). 每周期按轮转顺序读各传感器角速度 (起始传感器逐周期
+ * 轮换, 各传感器的平均采样时刻相同), 融合为一个24-bit LSB值交给GyroPipeline,
+ * 采集记录与回放只看到融合值. 单传感器时融合值即该传感器读数.
+ *
+ * 融合 (GyroFusion_Combine, 不访问硬件):
+ *   c_i = raw_i - offset_i              offset_i: 该传感器相对其他传感器的零偏差
+ *   参考值 = 参与者c_i的中位数, ≥3个参与时 |c_i - 参考值| 超过门限的本周期剔除
+ *   门限 = max(GYRO_FUSION_OUTLIER_SIGMA·σ_i, GYRO_FUSION_OUTLIER_MIN_DPS + REL·|参考值|)
+ *   融合值 = Σ w_i·c_i / Σ w_i,  w_i = 1 / max(σ_i², 下限²)
+ *   offset_i 以 c_i - 融合值 的EMA跟踪, σ_i² 以 c_i - 其他参与者均值 的平方的EMA跟踪
+ *   (不含自身, 避免权重自我强化; ≥2个参与时)
+ * 启动 (及硬件零点校准) 后前GYRO_FUSION_LEARN_SAMPLES个周期为学习期: 以累计均值
+ * 估计offset与σ², 不剔除. 共同零偏仍由流水线校准, offset只消除传感器之间的差异,
+ * 某个传感器退出或恢复时融合值不跳变.
+ *
+ * 2个传感器时无法判断哪一个异常 (不剔除, 残差也相同即等权平均); 两者相差超过门限
+ * 时立即读两者的状态, 未就绪的一方本周期不参与. σ_i²含其他传感器的噪声, 3个以上
+ * 传感器时噪声大的传感器权重才会降低.
+ *
+ * 每个传感器的健康状态:
+ *   OK        参与融合; 连续GYRO_FUSION_FAIL_CYCLES个周期读取失败/状态未就绪/被剔除/
+ *             沿用旧读数 (held) → FAILED
+ *   FAILED    不参与; 状态就绪且读取成功 (非held) 后 → LEARNING
+ *   LEARNING  读取但不参与, 以累计均值重新学习offset与σ²,
+ *             连续GYRO_FUSION_LEARN_SAMPLES个有效样本后 → OK (期间无效则回到FAILED)
+ * 没有OK传感器时, 有效的传感器直接转为OK并重新开始学习期 (单传感器恢复即如此).
+ * 所有传感器都不可用时本周期无角速度 (与单传感器未就绪相同).
+ *
+ * 状态应答经CAN_ID_FUSION (状态变化时及命令0x63查询时, 每个装配的传感器一帧):
+ *   [0]=传感器序号 [1]=健康状态 [2]=权重% [3]=最近状态寄存器
+ *   [4-5]=offset (int16, 0.001°/s) [6-7]=噪声标准差σ (uint16, 0.0001°/s)
+ *============================================================================*/
+#define GYRO_FUSION_MAX_SENSORS         4
+
+#ifndef GYRO_FUSION_SENSOR_MASK
+#define GYRO_FUSION_SENSOR_MASK         0x01    /* bit i=片选i装配了传感器 */
+#endif
+
+#define GYRO_FUSION_LEARN_SAMPLES       200     /* 学习期样本数 (2秒) */
+#define GYRO_FUSION_FAIL_CYCLES         3       /* 连续异常周期数 → FAILED */
+#define GYRO_FUSION_OFFSET_ALPHA        0.001f  /* 运行中offset跟踪EMA系数 */
+#define GYRO_FUSION_NOISE_ALPHA         0.01f   /* 运行中σ²跟踪EMA系数 */
+#define GYRO_FUSION_NOISE_FLOOR_DPS     0.001f  /* σ下限 (限制单个传感器的权重) */
+#define GYRO_FUSION_OUTLIER_SIGMA       6.0f    /* 剔除门限 (σ倍数) */
+#define GYRO_FUSION_OUTLIER_MIN_DPS     1.0f    /* 剔除门限下限 (°/s) */
+#define GYRO_FUSION_OUTLIER_REL         0.02f   /* 剔除门限随角速度增加 (标度因数差异) */
+
+/* 健康状态 */
+#define GYRO_SENSOR_ABSENT              0       /* 未装配 */
+#define GYRO_SENSOR_OK                  1
+#define GYRO_SENSOR_LEARNING            2
+#define GYRO_SENSOR_FAILED              3
+
+/* 单个传感器的校准与健康状态 */
+typedef struct {
+    uint8_t state;
+    uint8_t bad_cycles;         /* OK状态下连续异常周期数 */
+    uint16_t samples;           /* LEARNING状态下有效样本数 */
+    float offset;               /* 相对零偏差 (LSB) */
+    float noise_var;            /* 残差方差σ² (LSB²) */
+    float weight;               /* 最近一次融合中的权重 (0~1) */
+    uint32_t faults;            /* 累计异常周期 */
+    uint32_t outliers;          /* 累计被剔除次数 */
+} GyroFusion_Sensor;
+
+/* 融合状态 */
+typedef struct {
+    GyroFusion_Sensor sensors[GYRO_FUSION_MAX_SENSORS];
+    uint16_t learn;             /* 学习期已处理周期数 */
+    uint8_t used;               /* 最近一次参与融合的传感器 (位图) */
+    uint8_t changed;            /* 健康状态变化的传感器 (位图, 由使用者清除) */
+} GyroFusion;
+
+/* 一个周期的读数 */
+typedef struct {
+    uint8_t valid;              /* bit i=读取成功且状态就绪 */
+    uint8_t held;               /* bit i=沿用上次接受的读数 (跳变未接受), 参与融合但计为异常周期 */
+    int32_t raw[GYRO_FUSION_MAX_SENSORS];
+} GyroFusion_Input;
+
+/**
+ * @brief 初始化: 装配的传感器为OK并开始学习期
+ * @param mask 装配位图
+ */
+void GyroFusion_Init(GyroFusion *f, uint8_t mask);
+
+/**
+ * @brief offset清零并重新开始学习期 (传感器零点改变后)
+ */
+void GyroFusion_Relearn(GyroFusion *f);
+
+/**
+ * @brief 将传感器标记为FAILED (启动时未就绪)
+ */
+void GyroFusion_Fail(GyroFusion *f, uint8_t index);
+
+/**
+ * @brief OK状态的有效读数之间是否有超过剔除门限的差异 (学习期内为false)
+ */
+bool GyroFusion_Disagree(const GyroFusion *f, const GyroFusion_Input *in);
+
+/**
+ * @brief 融合一个周期的读数并更新各传感器状态
+ * @param fused 融合值 (24-bit LSB)
+ * @return true=fused有效
+ */
+bool GyroFusion_Combine(GyroFusion *f, const GyroFusion_Input *in, int32_t *fused);
+
+/*============================================================================
+ * 固件传感器组 (只由Task_Main调用, SPI只在该任务访问; 其他任务的命令置标志)
+ *
+ * 读数故障 (驱动分类, 见xv7001bb.h) 在本周期内有限重试: 每次读取最多重试
+ * GYRO_SENSORS_READ_RETRIES次, 全部传感器每周期共GYRO_SENSORS_RETRY_BUDGET次
+ * (正常完成的事务约115~230µs, 见xv7001bb.h). HAL超时是总线级故障, 每周期只重试
+ * 一次; 失败的事务最多约XV7_SPI_TIMEOUT_MS, 一个周期内第GYRO_SENSORS_SPI_TIMEOUTS次
+ * HAL超时后本周期不再访问SPI (其余读取按SPI故障计), 总线完全失效时一个周期最多
+ * 约4ms, 与传感器数无关; 读状态失败的传感器之后不再读角速度, 持续失效时只剩按
+ * 调度的状态读取. STUCK、JUMP与FAILED状态的传感器不重试;
+ * JUMP的读数以该传感器上次接受的读数代替 (held), 参与本周期融合但计为异常周期.
+ * 重试后仍无效的读数不参与融合, 不会进入积分; 连续GYRO_FUSION_FAIL_CYCLES个周期
+ * 无效或held即标记为FAILED, 持续跳变的传感器与失效的传感器同样退出.
+ * 首次检测到故障到标记为FAILED的延迟记入延迟直方图分段LATENCY_FAULT_TO_FLAG.
+ *
+ * 故障计数经CAN_ID_SENSOR_FAULT应答 (命令0x64), 每个装配的传感器3帧,
+ * [0]=传感器<<4 | 页, 计数为uint16小端 (饱和):
+ *   页0: [1]=最近故障分类 [2-3]=SPI [4-5]=ONES [6-7]=ZEROS
+ *   页1: [1]=健康状态 [2-3]=STUCK [4-5]=JUMP [6-7]=重试次数
+ *   页2: [1]=标记FAILED次数 (uint8饱和) [2-3]=重试后仍无效的读取
+ *        [4-5]=最近一次检测→FAILED延迟 [6-7]=最大延迟 (0.1ms)
+ *============================================================================*/
+#define GYRO_SENSORS_READ_RETRIES       2       /* 每次读取的重试上限 */
+#define GYRO_SENSORS_RETRY_BUDGET       4       /* 每周期重试上限 (全部传感器共享) */
+#define GYRO_SENSORS_SPI_TIMEOUTS       2       /* 每周期HAL超时上限, 达到后本周期不再访问SPI */
+#define GYRO_SENSORS_FAULT_PAGES        3
+
+/**
+ * @brief 初始化传感器句柄与融合状态
+ * @param mask 装配位图
+ */
+void GyroSensors_Init(uint8_t mask);
+
+/**
+ * @brief 传感器句柄 (0=PB12片选)
+ */
+XV7_Device *GyroSensors_Device(uint8_t index);
+
+/**
+ * @brief 向全部装配的传感器写一个命令寄存器 (唤醒/待机/睡眠等)
+ */
+void GyroSensors_Command(uint8_t reg, uint8_t data);
+
+/**
+ * @brief 向全部装配的传感器发送唤醒命令
+ */
+void GyroSensors_Wake(void);
+
+/**
+ * @brief 查询一次所有未失效传感器的唤醒状态 (唤醒命令未生效时重发)
+ * @return XV7_OK=全部就绪, XV7_ERR_NOT_READY=仍有未就绪
+ */
+XV7_Status GyroSensors_PollReady(void);
+
+/**
+ * @brief 将未就绪的传感器标记为FAILED (唤醒超时后)
+ * @return 就绪的传感器数
+ */
+uint8_t GyroSensors_DropUnready(void);
+
+/**
+ * @brief 读全部装配传感器的状态寄存器
+ * @param status 代表状态: 优先取OK且就绪的传感器, 其次任意就绪的传感器, 否则为第一个装配的传感器
+ * @return 代表状态的读取结果
+ */
+XV7_Status GyroSensors_ReadStatus(XV7_StatusReg *status);
+
+/**
+ * @brief 轮转读取各就绪传感器的角速度并融合
+ * @return XV7_OK=gyro有效, XV7_ERR_NOT_READY=没有可用的传感器
+ */
+XV7_Status GyroSensors_ReadRate(XV7_GyroData *gyro);
+
+/**
+ * @brief 读温度 (第一个参与融合的传感器)
+ */
+XV7_Status GyroSensors_ReadTemp(XV7_TempData *temp);
+
+/**
+ * @brief 写入DSP与输出格式配置 (全部装配的传感器)
+ * @return 第一个错误
+ */
+XV7_Status GyroSensors_Configure(const XV7_Config *cfg);
+
+/**
+ * @brief 硬件零点校准 (全部装配的传感器), 下一周期重新学习offset
+ * Task_Main处理命令0x02时调用
+ */
+void GyroSensors_ZeroCalibrate(void);
+
+/**
+ * @brief 每个采样周期开始时调用 (Task_Main): 恢复重试预算, 执行待处理的计数清零
+ */
+void GyroSensors_BeginCycle(void);
+
+/**
+ * @brief 故障计数清零 (任意任务调用, 下一周期开始时生效)
+ */
+void GyroSensors_ClearFaults(void);
+
+/**
+ * @brief 开始发送故障计数应答
+ */
+void GyroSensors_StartFaultReport(void);
+
+/**
+ * @brief 取下一故障计数应答帧
+ * @return true=data有效
+ */
+bool GyroSensors_NextFaultFrame(uint8_t *data);
+
+/**
+ * @brief 开始发送状态应答
+ */
+void GyroSensors_StartReport(void);
+
+/**
+ * @brief 取下一应答帧
+ * @return true=data有效
+ */
+bool GyroSensors_NextReportFrame(uint8_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GYRO_FUSION_H */
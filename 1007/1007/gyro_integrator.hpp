@@ -0,0 +1,351 @@
+#ifndef __GYRO_INTEGRATOR_HPP
+#define __GYRO_INTEGRATOR_HPP
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*============================================================================
+ * 角速度积分核心 (零偏校准、静止判断、梯形积分、动态零偏EMA)
+ *
+ * 仅依赖标准头文件, 不访问硬件与全局变量, 目标板和主机基准测试共用.
+ * 采样率、灵敏度、阈值和数值类型均为编译期参数, 换算系数在编译期合并,
+ * 每个样本只需一次乘法即可累加角度.
+ *
+ * 内部以原始计数 (LSB) 为单位运算, 仅在输出时换算为°和°/s:
+ *   angle += (c[n] + c[n-1]) * (0.5 * dt / sensitivity),  c = raw - bias
+ *
+ * 用法:
+ *   struct MyConfig : GyroIntegratorDefaultConfig { typedef GyroFixed value_type; };
+ *   GyroIntegrator<MyConfig> integ;
+ *   integ.reset();
+ *   每周期: integ.calibrating() ? integ.calibrate(ok, raw) : integ.update(raw);
+ *============================================================================*/
+
+/* 定点数值类型标记: 角度以int64累加原始计数, 长时间积分不丢精度 */
+struct GyroFixed {};
+
+/* 默认配置 (XV7001BB 24-bit模式, 100Hz) */
+struct GyroIntegratorDefaultConfig {
+    typedef float value_type;                                   /* float或GyroFixed */
+    static constexpr float sample_rate_hz = 100.0f;             /* 采样率 */
+    static constexpr float sensitivity_lsb = 71680.0f;          /* LSB/(°/s) */
+    static constexpr float still_threshold_dps = 0.5f;          /* 静止判断阈值 */
+    static constexpr float bias_ema_alpha = 0.01f;              /* 动态零偏EMA系数 */
+    static constexpr int bias_sample_count = 200;               /* 启动校准样本数 */
+};
+
+/*============================================================================
+ * 公共部分: 启动零偏校准 (整数运算, 与数值类型无关)
+ *============================================================================*/
+template <class Config>
+class GyroIntegratorBase {
+public:
+    /* 状态导出字数 (GyroIntegrator::save/load) */
+    static const int kStateWords = 12;
+
+    /**
+     * @brief 开始静止零偏校准, 零偏在完成前无效
+     */
+    void beginCalibration()
+    {
+        m_calibrating = true;
+        m_bias_ready = false;
+        m_cal_index = 0;
+        m_cal_count = 0;
+        m_cal_sum = 0;
+        m_cal_last = 0;
+    }
+
+    bool calibrating() const { return m_calibrating; }
+    bool biasReady() const { return m_bias_ready; }
+
+protected:
+    /**
+     * @brief 结束校准并标记零偏有效 (零偏由外部给出)
+     */
+    void skipCalibration()
+    {
+        beginCalibration();
+        m_calibrating = false;
+        m_bias_ready = true;
+    }
+
+    /* 静止阈值 (LSB), 编译期换算 */
+    static constexpr int32_t kStillLsb = (int32_t)(Config::still_threshold_dps * Config::sensitivity_lsb);
+
+    /**
+     * @brief 处理一个校准样本, 检测到运动则重新开始
+     * @return true=本样本完成校准, m_cal_sum/m_cal_count可用
+     */
+    bool calibrateStep(bool valid, int32_t raw)
+    {
+        if (valid)
+        {
+            int32_t diff = raw - m_cal_last;
+            if (m_cal_index > 0 && (diff > kStillLsb || diff < -kStillLsb))
+            {
+                m_cal_sum = 0;
+                m_cal_count = 0;
+                m_cal_index = -1;
+            }
+            else
+            {
+                m_cal_sum += raw;
+                m_cal_count++;
+            }
+            m_cal_last = raw;
+        }
+
+        if (++m_cal_index < Config::bias_sample_count)
+        {
+            return false;
+        }
+        m_calibrating = false;
+        return true;
+    }
+
+    void saveBase(uint32_t *words) const
+    {
+        words[0] = (m_calibrating ? 1u : 0u) | (m_bias_ready ? 2u : 0u);
+        words[1] = (uint32_t)m_cal_index;
+        words[2] = (uint32_t)m_cal_count;
+        words[3] = (uint32_t)(uint64_t)m_cal_sum;
+        words[4] = (uint32_t)((uint64_t)m_cal_sum >> 32);
+        words[5] = (uint32_t)m_cal_last;
+    }
+
+    void loadBase(const uint32_t *words)
+    {
+        m_calibrating = (words[0] & 1u) != 0;
+        m_bias_ready = (words[0] & 2u) != 0;
+        m_cal_index = (int32_t)words[1];
+        m_cal_count = (int32_t)words[2];
+        m_cal_sum = (int64_t)((uint64_t)words[3] | ((uint64_t)words[4] << 32));
+        m_cal_last = (int32_t)words[5];
+    }
+
+    bool m_calibrating;
+    bool m_bias_ready;
+    int32_t m_cal_index;
+    int32_t m_cal_count;
+    int64_t m_cal_sum;          /* 原始计数之和, 整数累加无舍入 */
+    int32_t m_cal_last;
+};
+
+template <class Config, class T = typename Config::value_type>
+class GyroIntegrator;
+
+/*============================================================================
+ * 浮点实现
+ *============================================================================*/
+template <class Config>
+class GyroIntegrator<Config, float> : public GyroIntegratorBase<Config> {
+    typedef GyroIntegratorBase<Config> Base;
+
+public:
+    /* 编译期合并的换算系数 */
+    static constexpr float kDpsPerLsb = 1.0f / Config::sensitivity_lsb;
+    static constexpr float kDegPerLsbSum = 0.5f / (Config::sample_rate_hz * Config::sensitivity_lsb);
+    static constexpr float kStillLsbF = Config::still_threshold_dps * Config::sensitivity_lsb;
+
+    /**
+     * @brief 清除全部状态并开始校准
+     */
+    void reset()
+    {
+        m_angle = 0.0f;
+        m_bias = 0.0f;
+        m_last = 0.0f;
+        Base::beginCalibration();
+    }
+
+    /**
+     * @brief 校准阶段处理一个样本
+     * @param valid 本周期读数是否有效
+     */
+    void calibrate(bool valid, int32_t raw)
+    {
+        // 校准失败时保留原零偏, 零偏无效
+        if (Base::calibrateStep(valid, raw) && Base::m_cal_count > 0)
+        {
+            // 整数部分与余数分开换算, 避免大数转float丢失低位
+            int64_t mean = Base::m_cal_sum / Base::m_cal_count;
+            int64_t rem = Base::m_cal_sum - mean * Base::m_cal_count;
+            m_bias = (float)mean + (float)rem / (float)Base::m_cal_count;
+            Base::m_bias_ready = true;
+        }
+    }
+
+    /**
+     * @brief 运行阶段处理一个样本: 零偏校正、梯形积分、静止时更新零偏
+     */
+    void update(int32_t raw)
+    {
+        float sample = (float)raw;
+        float corrected = sample - m_bias;
+
+        if (Base::m_bias_ready)
+        {
+            m_angle += (corrected + m_last) * kDegPerLsbSum;
+        }
+        m_last = corrected;
+
+        if (Base::m_bias_ready && corrected < kStillLsbF && corrected > -kStillLsbF)
+        {
+            m_bias += Config::bias_ema_alpha * (sample - m_bias);
+        }
+    }
+
+    /**
+     * @brief 角度清零, 补偿命令等待期间转过的角度
+     */
+    void resetAngle(uint32_t pending_us)
+    {
+        m_angle = Base::m_bias_ready ? rateDps() * (float)pending_us * 1e-6f : 0.0f;
+    }
+
+    void setBiasDps(float dps) { m_bias = dps * Config::sensitivity_lsb; }
+
+    /**
+     * @brief 以保存的角度和零偏恢复, 跳过启动校准 (下一样本起积分)
+     */
+    void restore(float angle_deg, float bias_dps)
+    {
+        reset();
+        Base::skipCalibration();
+        m_angle = angle_deg;
+        setBiasDps(bias_dps);
+    }
+
+    float angleDeg() const { return m_angle; }
+    float biasDps() const { return m_bias * kDpsPerLsb; }
+    float rateDps() const { return m_last * kDpsPerLsb; }   /* 最近一次校正后角速度 */
+    static float toDps(int32_t raw) { return (float)raw * kDpsPerLsb; }
+
+    /**
+     * @brief 导出/恢复状态 (kStateWords个32-bit字)
+     */
+    void save(uint32_t *words) const
+    {
+        Base::saveBase(words);
+        memcpy(&words[6], &m_angle, sizeof(float));
+        memcpy(&words[7], &m_bias, sizeof(float));
+        memcpy(&words[8], &m_last, sizeof(float));
+        words[9] = words[10] = words[11] = 0;
+    }
+
+    void load(const uint32_t *words)
+    {
+        Base::loadBase(words);
+        memcpy(&m_angle, &words[6], sizeof(float));
+        memcpy(&m_bias, &words[7], sizeof(float));
+        memcpy(&m_last, &words[8], sizeof(float));
+    }
+
+private:
+    float m_angle;              /* 角度 (°) */
+    float m_bias;               /* 零偏 (LSB) */
+    float m_last;               /* 上一样本校正后角速度 (LSB) */
+};
+
+/*============================================================================
+ * 定点实现
+ * 零偏与校正值为Q8原始计数, 角度以int64累加 (c[n] + c[n-1]), 仅在读取
+ * 角度时乘以换算系数; Cortex-M3无FPU, 每样本只有整数加减和一次乘法
+ *============================================================================*/
+template <class Config>
+class GyroIntegrator<Config, GyroFixed> : public GyroIntegratorBase<Config> {
+    typedef GyroIntegratorBase<Config> Base;
+
+public:
+    static const int kFracBits = 8;
+    static constexpr float kDpsPerQ = 1.0f / (Config::sensitivity_lsb * (1 << kFracBits));
+    static constexpr float kDegPerSum = 0.5f / (Config::sample_rate_hz * Config::sensitivity_lsb * (1 << kFracBits));
+    static constexpr int64_t kStillQ = (int64_t)(Config::still_threshold_dps * Config::sensitivity_lsb * (1 << kFracBits));
+    static constexpr int32_t kAlphaQ16 = (int32_t)(Config::bias_ema_alpha * 65536.0f + 0.5f);
+    static constexpr int64_t kPeriodUs = (int64_t)(1000000.0f / Config::sample_rate_hz + 0.5f);
+
+    void reset()
+    {
+        m_sum = 0;
+        m_bias = 0;
+        m_last = 0;
+        Base::beginCalibration();
+    }
+
+    void calibrate(bool valid, int32_t raw)
+    {
+        if (Base::calibrateStep(valid, raw) && Base::m_cal_count > 0)
+        {
+            m_bias = (Base::m_cal_sum * (1 << kFracBits)) / Base::m_cal_count;
+            Base::m_bias_ready = true;
+        }
+    }
+
+    void update(int32_t raw)
+    {
+        int64_t sample = (int64_t)raw * (1 << kFracBits);
+        int64_t corrected = sample - m_bias;
+
+        if (Base::m_bias_ready)
+        {
+            m_sum += corrected + m_last;
+        }
+        m_last = corrected;
+
+        if (Base::m_bias_ready && corrected < kStillQ && corrected > -kStillQ)
+        {
+            m_bias += ((sample - m_bias) * kAlphaQ16) >> 16;
+        }
+    }
+
+    /**
+     * @brief 角度清零: 等待期间转过的角度折算为积分和 (last * pending * 2 / 周期)
+     */
+    void resetAngle(uint32_t pending_us)
+    {
+        m_sum = Base::m_bias_ready ? (m_last * (int64_t)pending_us * 2) / kPeriodUs : 0;
+    }
+
+    void setBiasDps(float dps) { m_bias = (int64_t)(dps * Config::sensitivity_lsb * (1 << kFracBits)); }
+
+    void restore(float angle_deg, float bias_dps)
+    {
+        reset();
+        Base::skipCalibration();
+        m_sum = (int64_t)(angle_deg / kDegPerSum);
+        setBiasDps(bias_dps);
+    }
+
+    float angleDeg() const { return (float)m_sum * kDegPerSum; }
+    float biasDps() const { return (float)m_bias * kDpsPerQ; }
+    float rateDps() const { return (float)m_last * kDpsPerQ; }
+    static float toDps(int32_t raw) { return (float)raw * (kDpsPerQ * (1 << kFracBits)); }
+
+    void save(uint32_t *words) const
+    {
+        Base::saveBase(words);
+        words[6] = (uint32_t)(uint64_t)m_sum;
+        words[7] = (uint32_t)((uint64_t)m_sum >> 32);
+        words[8] = (uint32_t)(uint64_t)m_bias;
+        words[9] = (uint32_t)((uint64_t)m_bias >> 32);
+        words[10] = (uint32_t)(uint64_t)m_last;
+        words[11] = (uint32_t)((uint64_t)m_last >> 32);
+    }
+
+    void load(const uint32_t *words)
+    {
+        Base::loadBase(words);
+        m_sum = (int64_t)((uint64_t)words[6] | ((uint64_t)words[7] << 32));
+        m_bias = (int64_t)((uint64_t)words[8] | ((uint64_t)words[9] << 32));
+        m_last = (int64_t)((uint64_t)words[10] | ((uint64_t)words[11] << 32));
+    }
+
+private:
+    int64_t m_sum;              /* 梯形积分和 (Q8 LSB) */
+    int64_t m_bias;             /* 零偏 (Q8 LSB) */
+    int64_t m_last;             /* 上一样本校正值 (Q8 LSB) */
+};
+
+#endif /* __GYRO_INTEGRATOR_HPP */
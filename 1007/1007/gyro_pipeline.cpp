@@ -0,0 +1,127 @@
+#include "gyro_pipeline.h"
+#include "ramfunc.h"
+#include <string.h>
+#include <new>
+
+typedef GyroPipelineIntegrator Integrator;
+
+static_assert(sizeof(Integrator) <= sizeof(((GyroPipeline *)0)->core), "GYRO_PIPELINE_CORE_WORDS too small");
+static_assert(Integrator::kStateWords + 1 == GYRO_PIPELINE_STATE_WORDS, "GYRO_PIPELINE_STATE_WORDS mismatch");
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+static inline Integrator *GyroPipeline_Core(GyroPipeline *p)
+{
+    return reinterpret_cast<Integrator *>(p->core);
+}
+
+static inline const Integrator *GyroPipeline_Core(const GyroPipeline *p)
+{
+    return reinterpret_cast<const Integrator *>(p->core);
+}
+
+/**
+ * @brief 刷新输出字段
+ */
+RAMFUNC static void GyroPipeline_Publish(GyroPipeline *p)
+{
+    const Integrator *core = GyroPipeline_Core(p);
+    
+    p->phase = core->calibrating() ? GYRO_PHASE_CALIBRATING : GYRO_PHASE_RUNNING;
+    p->bias_ready = core->biasReady();
+    p->angle = core->angleDeg();
+    p->gyro_bias = core->biasDps();
+    p->last_dps = core->rateDps();
+}
+
+/*============================================================================
+ * 公共函数实现
+ *============================================================================*/
+
+void GyroPipeline_Init(GyroPipeline *p)
+{
+    memset(p, 0, sizeof(GyroPipeline));
+    new (p->core) Integrator();
+    GyroPipeline_Core(p)->reset();
+    p->sensor_ready = true;
+    GyroPipeline_Publish(p);
+}
+
+RAMFUNC bool GyroPipeline_StatusReady(uint8_t status_raw)
+{
+    return (status_raw & XV7_STATUS_PROC_OK) &&
+           (status_raw & XV7_STATUS_STATE_MASK) == XV7_STATE_SLEEP_OUT;
+}
+
+RAMFUNC bool GyroPipeline_WantsStatus(const GyroPipeline *p)
+{
+    return !GyroPipeline_Core(p)->calibrating();
+}
+
+RAMFUNC void GyroPipeline_Step(GyroPipeline *p, const GyroPipeline_Sample *s)
+{
+    Integrator *core = GyroPipeline_Core(p);
+    
+    p->rate_valid = false;
+    
+    if (core->calibrating())
+    {
+        core->calibrate(s->gyro_ok, s->gyro_raw);
+    }
+    else if (!s->status_ok || !GyroPipeline_StatusReady(s->status_raw))
+    {
+        p->sensor_ready = false;
+    }
+    else
+    {
+        p->sensor_ready = true;
+        if (s->gyro_ok)
+        {
+            core->update(s->gyro_raw);
+            p->raw_dps = Integrator::toDps(s->gyro_raw);
+            p->corrected_dps = core->rateDps();
+            p->rate_valid = true;
+        }
+    }
+    
+    GyroPipeline_Publish(p);
+}
+
+void GyroPipeline_ResetAngle(GyroPipeline *p, uint32_t pending_us)
+{
+    GyroPipeline_Core(p)->resetAngle(pending_us);
+    GyroPipeline_Publish(p);
+}
+
+void GyroPipeline_StartCalibration(GyroPipeline *p)
+{
+    GyroPipeline_Core(p)->beginCalibration();
+    GyroPipeline_Publish(p);
+}
+
+void GyroPipeline_SetBias(GyroPipeline *p, float bias)
+{
+    GyroPipeline_Core(p)->setBiasDps(bias);
+    GyroPipeline_Publish(p);
+}
+
+void GyroPipeline_Restore(GyroPipeline *p, float angle, float bias)
+{
+    GyroPipeline_Core(p)->restore(angle, bias);
+    GyroPipeline_Publish(p);
+}
+
+void GyroPipeline_SaveState(const GyroPipeline *p, uint32_t *words)
+{
+    words[0] = p->sensor_ready ? 1u : 0u;
+    GyroPipeline_Core(p)->save(&words[1]);
+}
+
+void GyroPipeline_LoadState(GyroPipeline *p, const uint32_t *words)
+{
+    p->sensor_ready = (words[0] & 1u) != 0;
+    GyroPipeline_Core(p)->load(&words[1]);
+    GyroPipeline_Publish(p);
+}
@@ -0,0 +1,134 @@
+#ifndef __GYRO_PIPELINE_H
+#define __GYRO_PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f1xx_hal.h"
+#include <stdbool.h>
+
+/*============================================================================
+ * 角速度处理流水线 (状态判断 + GyroIntegrator)
+ * 
+ * Task_Main每周期读取传感器后调用GyroPipeline_Step, 算法本身不访问硬件和
+ * 全局变量, 主机回放工具以同一份代码处理记录文件, 结果逐位一致.
+ * 零偏校准、静止判断、积分和动态零偏见gyro_integrator.hpp.
+ *============================================================================*/
+#define GYRO_PIPELINE_RATE_HZ       100     /* 采样率, 与主任务周期一致 */
+
+#ifndef GYRO_PIPELINE_FIXED_POINT
+#define GYRO_PIPELINE_FIXED_POINT   0       /* 1=定点积分 (int64累加, 无浮点运算) */
+#endif
+
+/* 零偏校准参数 */
+#define GYRO_BIAS_SAMPLE_COUNT      200     /* 校准采样数 (2秒@10ms) */
+#define GYRO_STILL_THRESHOLD_DPS    0.5f    /* 静止判断阈值 (°/s) */
+#define GYRO_BIAS_EMA_ALPHA         0.01f   /* 动态校准EMA系数 */
+
+#define GYRO_PIPELINE_CORE_WORDS    8       /* 积分核心存储 (uint64_t) */
+#define GYRO_PIPELINE_STATE_WORDS   13      /* 状态导出字数: 流水线1 + 积分核心12 */
+
+/* 流水线阶段 */
+typedef enum {
+    GYRO_PHASE_CALIBRATING = 0,     /* 静止零偏校准, 每周期只读角速度 */
+    GYRO_PHASE_RUNNING = 1          /* 正常运行, 每周期读状态/角速度/温度 */
+} GyroPipeline_Phase;
+
+/* 一个周期的传感器读数 (即记录文件中的一条样本) */
+typedef struct {
+    bool status_ok;             /* 读状态寄存器成功 */
+    uint8_t status_raw;
+    bool gyro_ok;               /* 读角速度成功 */
+    int32_t gyro_raw;
+    bool temp_ok;               /* 读温度成功 */
+    uint16_t temp_raw;
+} GyroPipeline_Sample;
+
+/* 流水线状态, 输出字段在每次调用后刷新 */
+typedef struct {
+    uint64_t core[GYRO_PIPELINE_CORE_WORDS];   /* GyroIntegrator (gyro_pipeline.cpp) */
+    bool sensor_ready;          /* 传感器处于工作状态 */
+    
+    /* 输出 */
+    GyroPipeline_Phase phase;
+    bool bias_ready;            /* 零偏有效 */
+    float angle;                /* 积分角度 (°) */
+    float gyro_bias;            /* 零偏 (°/s) */
+    float last_dps;             /* 最近一次校正后角速度 */
+    bool rate_valid;            /* 本周期得到新角速度 */
+    float raw_dps;
+    float corrected_dps;
+} GyroPipeline;
+
+/**
+ * @brief 初始化并进入零偏校准阶段
+ */
+void GyroPipeline_Init(GyroPipeline *p);
+
+/**
+ * @brief 状态寄存器是否表示正常工作 (PROC_OK且SLEEP_OUT)
+ */
+bool GyroPipeline_StatusReady(uint8_t status_raw);
+
+/**
+ * @brief 本周期是否需要读状态寄存器 (校准阶段只读角速度)
+ */
+bool GyroPipeline_WantsStatus(const GyroPipeline *p);
+
+/**
+ * @brief 处理一个周期的读数
+ */
+void GyroPipeline_Step(GyroPipeline *p, const GyroPipeline_Sample *s);
+
+/**
+ * @brief 角度清零, 补偿命令等待期间转过的角度
+ * @param pending_us 命令接收到处理的时间
+ */
+void GyroPipeline_ResetAngle(GyroPipeline *p, uint32_t pending_us);
+
+/**
+ * @brief 重新开始零偏校准
+ */
+void GyroPipeline_StartCalibration(GyroPipeline *p);
+
+/**
+ * @brief 设置软件零偏 (°/s)
+ */
+void GyroPipeline_SetBias(GyroPipeline *p, float bias);
+
+/**
+ * @brief 以保存的角度 (°) 和零偏 (°/s) 恢复, 跳过零偏校准直接进入运行阶段
+ */
+void GyroPipeline_Restore(GyroPipeline *p, float angle, float bias);
+
+/**
+ * @brief 导出/恢复全部状态 (GYRO_PIPELINE_STATE_WORDS个字, 用于采集记录)
+ */
+void GyroPipeline_SaveState(const GyroPipeline *p, uint32_t *words);
+void GyroPipeline_LoadState(GyroPipeline *p, const uint32_t *words);
+
+#ifdef __cplusplus
+}
+
+#include "gyro_integrator.hpp"
+#include "xv7001bb.h"
+
+/* 积分核心配置 (流水线与基准测试共用) */
+struct GyroPipelineConfig {
+#if GYRO_PIPELINE_FIXED_POINT
+    typedef GyroFixed value_type;
+#else
+    typedef float value_type;
+#endif
+    static constexpr float sample_rate_hz = (float)GYRO_PIPELINE_RATE_HZ;
+    static constexpr float sensitivity_lsb = XV7_GYRO_SENSITIVITY_24BIT;
+    static constexpr float still_threshold_dps = GYRO_STILL_THRESHOLD_DPS;
+    static constexpr float bias_ema_alpha = GYRO_BIAS_EMA_ALPHA;
+    static constexpr int bias_sample_count = GYRO_BIAS_SAMPLE_COUNT;
+};
+
+typedef GyroIntegrator<GyroPipelineConfig> GyroPipelineIntegrator;
+#endif
+
+#endif /* __GYRO_PIPELINE_H */
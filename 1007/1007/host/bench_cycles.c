@@ -0,0 +1,196 @@
+#include "cycle_bench.h"
+#include "spi.h"
+#include "xv7001bb.h"
+#include "acq_sched.h"
+#include "gyro_fusion.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*============================================================================
+ * bench_cycles: 在主机上运行热路径周期基准测试 (cycle_bench.cpp)
+ * 
+ * 用法: bench_cycles [-n 次数] [-o 输出.json] [-b 基线.json] [-t 百分比] [-hist]
+ *   -n 每阶段运行次数 (默认CYCLE_BENCH_RUNS)
+ *   -o 结果写入文件 (默认标准输出)
+ *   -b 与基线比较各阶段中位数, 任一阶段慢于基线超过-t (默认20%) 时返回1
+ *   -hist 在标准错误输出各阶段的周期分布 (16桶, 覆盖min~max), 用于观察长尾
+ * 
+ * SPI阶段测量的是主机替身与设备模型的开销, 目标板数值以CYCLE_BENCH=1固件为准;
+ * 基线比较只在同一台机器的结果之间有意义.
+ *============================================================================*/
+
+/**
+ * @brief 在基线JSON中查找阶段的中位数
+ * @return -1=未找到
+ */
+static long Bench_BaselineMedian(const char *json, const char *name)
+{
+    char key[64];
+    const char *p;
+    
+    snprintf(key, sizeof(key), "\"name\":\"%s\"", name);
+    if ((p = strstr(json, key)) == NULL || (p = strstr(p, "\"median\":")) == NULL)
+    {
+        return -1;
+    }
+    return strtol(p + 9, NULL, 10);
+}
+
+/**
+ * @brief 输出各阶段直方图 (每桶一行: 下限 计数 条形)
+ */
+static void Bench_PrintHists(const CycleBench_Report *report, const LatencyHist *hists)
+{
+    for (int i = 0; i < report->count; i++)
+    {
+        const LatencyHist *h = &hists[i];
+        uint32_t peak = 1;
+        
+        for (int b = 0; b < LATENCY_HIST_BUCKETS; b++)
+        {
+            peak = (h->buckets[b] > peak) ? h->buckets[b] : peak;
+        }
+        fprintf(stderr, "%s: n=%u min=%u mean=%u p99=%u max=%u\n", report->stages[i].name,
+                h->count, h->min, LatencyHist_Mean(h), LatencyHist_Percentile(h, 990), h->max);
+        for (int b = 0; b < LATENCY_HIST_BUCKETS; b++)
+        {
+            int bar = (int)((h->buckets[b] * 40U + peak - 1) / peak);
+            fprintf(stderr, "  %8u %6u %.*s\n", h->base + (uint32_t)b * h->width, h->buckets[b], bar,
+                    "########################################");
+        }
+    }
+}
+
+/**
+ * @brief 读取整个文件
+ */
+static char *Bench_ReadFile(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    char *buf;
+    long size;
+    
+    if (f == NULL)
+    {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = (char *)malloc((size_t)size + 1);
+    if (buf != NULL)
+    {
+        buf[fread(buf, 1, (size_t)size, f)] = '\0';
+    }
+    fclose(f);
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t runs = CYCLE_BENCH_RUNS;
+    const char *out_path = NULL;
+    const char *baseline_path = NULL;
+    double threshold = 20.0;
+    bool print_hists = false;
+    static CycleBench_Report report;
+    static LatencyHist hists[CYCLE_BENCH_MAX_STAGES];
+    static char json[CYCLE_BENCH_JSON_SIZE];
+    
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            out_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            baseline_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            threshold = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-hist") == 0)
+        {
+            print_hists = true;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-n runs] [-o out.json] [-b baseline.json] [-t percent] [-hist]\n", argv[0]);
+            return 2;
+        }
+    }
+    
+    // 与固件启动顺序相同: SPI初始化后唤醒传感器 (调度器未运行, 延时原地推进虚拟时间)
+    HAL_Init();
+    MX_SPI2_Init();
+    GyroSensors_Init(0x01);
+    if (XV7001bb_Init(GyroSensors_Device(0)) != XV7_OK)
+    {
+        fprintf(stderr, "sensor model init failed\n");
+        return 2;
+    }
+    AcqSched_Init();
+    
+    report.hists = print_hists ? hists : NULL;
+    CycleBench_RunAll(&report, runs);
+    CycleBench_FormatJson(&report, json, sizeof(json));
+    if (print_hists)
+    {
+        Bench_PrintHists(&report, hists);
+    }
+    
+    if (out_path != NULL)
+    {
+        FILE *out = fopen(out_path, "w");
+        if (out == NULL)
+        {
+            fprintf(stderr, "cannot write %s\n", out_path);
+            return 2;
+        }
+        fputs(json, out);
+        fclose(out);
+    }
+    else
+    {
+        fputs(json, stdout);
+    }
+    
+    if (baseline_path == NULL)
+    {
+        return 0;
+    }
+    
+    char *baseline = Bench_ReadFile(baseline_path);
+    int regressions = 0;
+    if (baseline == NULL)
+    {
+        fprintf(stderr, "cannot read %s\n", baseline_path);
+        return 2;
+    }
+    
+    fprintf(stderr, "%-20s %10s %10s %8s\n", "stage", "baseline", "median", "delta");
+    for (int i = 0; i < report.count; i++)
+    {
+        const CycleBench_Result *r = &report.stages[i];
+        long base = Bench_BaselineMedian(baseline, r->name);
+        if (base <= 0)
+        {
+            fprintf(stderr, "%-20s %10s %10u\n", r->name, "-", r->median);
+            continue;
+        }
+        
+        double delta = 100.0 * ((double)r->median - (double)base) / (double)base;
+        bool slow = delta > threshold;
+        regressions += slow ? 1 : 0;
+        fprintf(stderr, "%-20s %10ld %10u %+7.1f%%%s\n", r->name, base, r->median, delta, slow ? "  REGRESSION" : "");
+    }
+    free(baseline);
+    return regressions > 0 ? 1 : 0;
+}
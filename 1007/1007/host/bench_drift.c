@@ -0,0 +1,416 @@
+#include "gyro_noise_model.h"
+#include "gyro_pipeline.h"
+#include "xv7001bb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/*============================================================================
+ * bench_drift: 长时间漂移回归基准测试
+ *
+ * 用法: bench_drift [-s 场景] [-seed N] [-tol dps] [-o 输出.json] [-b 基线.json] [-t 百分比]
+ *   -s    只运行指定场景
+ *   -seed 误差模型随机种子 (默认1, 固定种子保证结果可在提交之间比较)
+ *   -tol  零偏收敛门限 (默认0.005°/s)
+ *   -b    与基线比较漂移与收敛时间, 任一场景差于基线超过-t (默认10%) 时返回1
+ *
+ * 误差模型 (gyro_noise_model) 按100Hz生成24-bit计数, 不经RTOS直接送入固件的
+ * GyroPipeline_Step, 24小时场景在主机上只需数秒. 每个场景前10秒静止 (启动校准),
+ * 输出最终角度误差、漂移 (°/h)、最大角度误差和零偏估计收敛时间.
+ *============================================================================*/
+#define DRIFT_CAL_S             10.0    /* 启动校准静止时长 */
+#define DRIFT_CYCLE_S           600.0   /* 运动场景一个周期: 静止-正转-静止-反转 */
+#define DRIFT_RATE_DPS          30.0    /* 运动场景匀速段角速度 */
+#define DRIFT_CHECK_SAMPLES     GYRO_PIPELINE_RATE_HZ   /* 每秒检查一次误差 */
+#define DRIFT_SETTLE_S          60.0    /* 零偏误差持续小于门限的时长视为收敛 */
+#define DRIFT_JSON_SIZE         4096
+
+/* 场景定义 */
+typedef struct {
+    const char *name;
+    double hours;
+    double temp_start_c;
+    double temp_end_c;
+    bool motion;
+} Drift_Scenario;
+
+/* 场景结果 */
+typedef struct {
+    const char *name;
+    double hours;
+    uint64_t samples;
+    double final_error_deg;     /* 最终角度 - 真实角度 */
+    double drift_deg_h;         /* 最终误差 / 时长 */
+    double max_error_deg;       /* 运行期间最大绝对误差 */
+    double bias_converge_s;     /* 校准结束到零偏误差开始持续小于门限的时间, -1=未收敛 */
+    double bias_error_dps;      /* 结束时零偏估计误差 */
+    double wall_s;
+    double speedup;             /* 仿真时长 / 运行时间 */
+} Drift_Result;
+
+static const Drift_Scenario s_scenarios[] = {
+    { "stationary_1h",    1.0, 25.0, 25.0, false },
+    { "stationary_8h",    8.0, 25.0, 25.0, false },
+    { "stationary_24h",  24.0, 25.0, 25.0, false },
+    { "temp_ramp_8h",     8.0, 25.0, 45.0, false },
+    { "motion_1h",        1.0, 25.0, 25.0, true },
+    { "motion_temp_24h", 24.0, 20.0, 50.0, true },
+};
+
+#define DRIFT_SCENARIO_COUNT    ((int)(sizeof(s_scenarios) / sizeof(s_scenarios[0])))
+
+/**
+ * @brief 追加一段剖面, 温度按场景总时长线性变化
+ */
+static void Drift_AddSegment(GyroProfile_Segment *segs, int *count, const Drift_Scenario *sc,
+                             double *t, double duration, double rate_start, double rate_end)
+{
+    double total = DRIFT_CAL_S + sc->hours * 3600.0;
+    double span = sc->temp_end_c - sc->temp_start_c;
+    GyroProfile_Segment *seg = &segs[(*count)++];
+
+    seg->duration_s = duration;
+    seg->rate_start_dps = rate_start;
+    seg->rate_end_dps = rate_end;
+    seg->temp_start_c = sc->temp_start_c + span * (*t / total);
+    seg->temp_end_c = sc->temp_start_c + span * ((*t + duration) / total);
+    *t += duration;
+}
+
+/**
+ * @brief 生成场景剖面
+ *
+ * 运动场景每周期: 10s加速 → 匀速60s → 10s减速 → 静止220s → 反向重复,
+ * 整小时的场景结束于静止段末尾
+ * @return 段数
+ */
+static int Drift_BuildProfile(const Drift_Scenario *sc, GyroProfile_Segment **out)
+{
+    double end = DRIFT_CAL_S + sc->hours * 3600.0;
+    int max = 2 + (sc->motion ? (int)(sc->hours * 3600.0 / DRIFT_CYCLE_S + 1.0) * 8 : 0);
+    GyroProfile_Segment *segs = (GyroProfile_Segment *)malloc(sizeof(GyroProfile_Segment) * (size_t)max);
+    int count = 0;
+    double t = 0.0;
+
+    Drift_AddSegment(segs, &count, sc, &t, DRIFT_CAL_S, 0.0, 0.0);
+    if (!sc->motion)
+    {
+        Drift_AddSegment(segs, &count, sc, &t, end - t, 0.0, 0.0);
+    }
+
+    /* 周期内各段: 时长与起止角速度 (正转, 后半周期取反) */
+    static const double cycle[4][3] = {
+        { 10.0, 0.0, 1.0 },
+        { 60.0, 1.0, 1.0 },
+        { 10.0, 1.0, 0.0 },
+        { 220.0, 0.0, 0.0 },
+    };
+    for (int n = 0; sc->motion && t < end; n++)
+    {
+        double sign = (n & 4) ? -DRIFT_RATE_DPS : DRIFT_RATE_DPS;
+        const double *c = cycle[n & 3];
+        double duration = (t + c[0] > end) ? end - t : c[0];
+
+        Drift_AddSegment(segs, &count, sc, &t, duration, c[1] * sign, c[2] * sign);
+    }
+
+    *out = segs;
+    return count;
+}
+
+static double Drift_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief 运行一个场景
+ */
+static void Drift_Run(const Drift_Scenario *sc, uint64_t seed, double tol_dps, Drift_Result *r)
+{
+    GyroProfile_Segment *segs;
+    GyroProfile profile;
+    GyroNoise_Params params;
+    GyroNoise_Model model;
+    static GyroPipeline pipe;
+    double dt = 1.0 / GYRO_PIPELINE_RATE_HZ;
+    uint64_t n = (uint64_t)((DRIFT_CAL_S + sc->hours * 3600.0) * GYRO_PIPELINE_RATE_HZ + 0.5);
+    double cal_end = -1.0;
+    double below_since = -1.0;
+    double t = 0.0;
+    uint16_t temp_raw = 0;
+    double start = Drift_Now();
+
+    profile.count = Drift_BuildProfile(sc, &segs);
+    profile.segments = segs;
+    GyroNoise_DefaultParams(&params);
+    params.seed = seed;
+    GyroNoise_Init(&model, &params, &profile);
+    GyroPipeline_Init(&pipe);
+
+    memset(r, 0, sizeof(*r));
+    r->name = sc->name;
+    r->hours = sc->hours;
+    r->samples = n;
+    r->bias_converge_s = -1.0;
+
+    for (uint64_t k = 1; k <= n; k++)
+    {
+        t = (double)k * dt;
+        int32_t raw = GyroNoise_Raw(&model, t);
+
+        /* 温度编码与设备模型一致: raw = (T + 6) * 16, 10-bit; 流水线不使用温度, 每秒刷新一次 */
+        if (k % DRIFT_CHECK_SAMPLES == 1)
+        {
+            double temp;
+            GyroProfile_At(&profile, t, NULL, &temp);
+            double code = (temp + 6.0) * 16.0;
+            temp_raw = (uint16_t)((code < 0.0) ? 0 : (code > 1023.0) ? 1023 : (uint16_t)(code + 0.5));
+        }
+        GyroPipeline_Sample sample = {
+            true, XV7_STATUS_PROC_OK | XV7_STATE_SLEEP_OUT,
+            true, raw,
+            true, temp_raw
+        };
+        GyroPipeline_Step(&pipe, &sample);
+
+        if (!pipe.bias_ready)
+        {
+            continue;
+        }
+        if (cal_end < 0.0)
+        {
+            cal_end = t;
+        }
+        if (k % DRIFT_CHECK_SAMPLES == 0)
+        {
+            double err = fabs((double)pipe.angle - GyroProfile_Angle(&profile, t));
+            double bias_err = fabs((double)pipe.gyro_bias - GyroNoise_Bias(&model));
+
+            r->max_error_deg = (err > r->max_error_deg) ? err : r->max_error_deg;
+            if (bias_err >= tol_dps)
+            {
+                below_since = -1.0;
+            }
+            else if (below_since < 0.0)
+            {
+                below_since = t;
+            }
+            if (r->bias_converge_s < 0.0 && below_since >= 0.0 && t - below_since >= DRIFT_SETTLE_S)
+            {
+                r->bias_converge_s = below_since - cal_end;
+            }
+        }
+    }
+
+    r->final_error_deg = (double)pipe.angle - GyroProfile_Angle(&profile, t);
+    r->drift_deg_h = r->final_error_deg / sc->hours;
+    r->bias_error_dps = (double)pipe.gyro_bias - GyroNoise_Bias(&model);
+    r->wall_s = Drift_Now() - start;
+    r->speedup = (r->wall_s > 0.0) ? (double)n * dt / r->wall_s : 0.0;
+    free(segs);
+}
+
+/**
+ * @brief 结果格式化为JSON, 字段顺序固定便于逐行比较
+ */
+static int Drift_FormatJson(const Drift_Result *results, int count, uint64_t seed, double tol_dps,
+                            char *buf, size_t size)
+{
+    int len = snprintf(buf, size,
+        "{\n  \"benchmark\":\"drift\",\n  \"numeric\":\"%s\",\n  \"seed\":%llu,\n"
+        "  \"bias_tolerance_dps\":%.6f,\n  \"scenarios\":[\n",
+        GYRO_PIPELINE_FIXED_POINT ? "fixed" : "float", (unsigned long long)seed, tol_dps);
+
+    for (int i = 0; i < count && len < (int)size; i++)
+    {
+        const Drift_Result *r = &results[i];
+        len += snprintf(buf + len, size - (size_t)len,
+            "    {\"name\":\"%s\",\"hours\":%.1f,\"samples\":%llu,"
+            "\"final_error_deg\":%.6f,\"drift_deg_h\":%.6f,\"max_error_deg\":%.6f,"
+            "\"bias_converge_s\":%.0f,\"bias_error_dps\":%.6f,\"wall_s\":%.3f,\"speedup\":%.0f}%s\n",
+            r->name, r->hours, (unsigned long long)r->samples,
+            r->final_error_deg, r->drift_deg_h, r->max_error_deg,
+            r->bias_converge_s, r->bias_error_dps, r->wall_s, r->speedup,
+            (i + 1 < count) ? "," : "");
+    }
+    if (len < (int)size)
+    {
+        len += snprintf(buf + len, size - (size_t)len, "  ]\n}\n");
+    }
+    return len;
+}
+
+/**
+ * @brief 在基线JSON中查找场景的数值字段
+ * @return false=未找到
+ */
+static bool Drift_BaselineValue(const char *json, const char *name, const char *field, double *value)
+{
+    char key[64];
+    const char *p;
+    const char *end;
+
+    snprintf(key, sizeof(key), "\"name\":\"%s\"", name);
+    if ((p = strstr(json, key)) == NULL || (end = strchr(p, '}')) == NULL)
+    {
+        return false;
+    }
+    snprintf(key, sizeof(key), "\"%s\":", field);
+    if ((p = strstr(p, key)) == NULL || p > end)
+    {
+        return false;
+    }
+    *value = strtod(p + strlen(key), NULL);
+    return true;
+}
+
+/**
+ * @brief 读取整个文件
+ */
+static char *Drift_ReadFile(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    char *buf;
+    long size;
+
+    if (f == NULL)
+    {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = (char *)malloc((size_t)size + 1);
+    if (buf != NULL)
+    {
+        buf[fread(buf, 1, (size_t)size, f)] = '\0';
+    }
+    fclose(f);
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    const char *only = NULL;
+    const char *out_path = NULL;
+    const char *baseline_path = NULL;
+    uint64_t seed = 1;
+    double tol_dps = 0.005;
+    double threshold = 10.0;
+    static Drift_Result results[DRIFT_SCENARIO_COUNT];
+    static char json[DRIFT_JSON_SIZE];
+    int count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            only = argv[++i];
+        }
+        else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+        {
+            seed = strtoull(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-tol") == 0 && i + 1 < argc)
+        {
+            tol_dps = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            out_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            baseline_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            threshold = atof(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-s scenario] [-seed N] [-tol dps] [-o out.json] [-b baseline.json] [-t percent]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (int i = 0; i < DRIFT_SCENARIO_COUNT; i++)
+    {
+        if (only != NULL && strcmp(only, s_scenarios[i].name) != 0)
+        {
+            continue;
+        }
+        Drift_Run(&s_scenarios[i], seed, tol_dps, &results[count]);
+        fprintf(stderr, "%-16s drift %+9.4f deg/h  converge %6.0f s  %.2f s\n", results[count].name,
+                results[count].drift_deg_h, results[count].bias_converge_s, results[count].wall_s);
+        count++;
+    }
+    if (count == 0)
+    {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        return 2;
+    }
+
+    Drift_FormatJson(results, count, seed, tol_dps, json, sizeof(json));
+    if (out_path != NULL)
+    {
+        FILE *out = fopen(out_path, "w");
+        if (out == NULL)
+        {
+            fprintf(stderr, "cannot write %s\n", out_path);
+            return 2;
+        }
+        fputs(json, out);
+        fclose(out);
+    }
+    else
+    {
+        fputs(json, stdout);
+    }
+
+    if (baseline_path == NULL)
+    {
+        return 0;
+    }
+
+    char *baseline = Drift_ReadFile(baseline_path);
+    int regressions = 0;
+    if (baseline == NULL)
+    {
+        fprintf(stderr, "cannot read %s\n", baseline_path);
+        return 2;
+    }
+
+    /* 结果由固定种子决定, 任何变化都来自算法; 加0.01°/h与1s绝对余量避免基线接近0时误报 */
+    fprintf(stderr, "%-16s %12s %12s %10s %10s\n", "scenario", "base deg/h", "deg/h", "base conv", "conv");
+    for (int i = 0; i < count; i++)
+    {
+        const Drift_Result *r = &results[i];
+        double base_drift;
+        double base_conv;
+
+        if (!Drift_BaselineValue(baseline, r->name, "drift_deg_h", &base_drift) ||
+            !Drift_BaselineValue(baseline, r->name, "bias_converge_s", &base_conv))
+        {
+            fprintf(stderr, "%-16s %12s %+12.4f %10s %10.0f\n", r->name, "-", r->drift_deg_h, "-", r->bias_converge_s);
+            continue;
+        }
+
+        double scale = 1.0 + threshold / 100.0;
+        bool worse = fabs(r->drift_deg_h) > fabs(base_drift) * scale + 0.01;
+        if (base_conv >= 0.0)
+        {
+            worse = worse || r->bias_converge_s < 0.0 || r->bias_converge_s > base_conv * scale + 1.0;
+        }
+        regressions += worse ? 1 : 0;
+        fprintf(stderr, "%-16s %+12.4f %+12.4f %10.0f %10.0f%s\n", r->name, base_drift, r->drift_deg_h,
+                base_conv, r->bias_converge_s, worse ? "  REGRESSION" : "");
+    }
+    free(baseline);
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,15 @@
+#ifndef __FIRMWARE_ENTRY_H
+#define __FIRMWARE_ENTRY_H
+
+/*============================================================================
+ * 主机构建: 1007.cpp 以 -Dmain=Firmware_Main 编译并强制包含本文件,
+ * 使固件入口以C链接导出, 供各仿真程序调用
+ *============================================================================*/
+
+#ifdef __cplusplus
+extern "C" int main(void);
+#else
+int Firmware_Main(void);
+#endif
+
+#endif /* __FIRMWARE_ENTRY_H */
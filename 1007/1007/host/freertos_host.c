@@ -0,0 +1,961 @@
+#include "freertos_host.h"
+#include "task.h"
+#include "queue.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*============================================================================
+ * 配置
+ *============================================================================*/
+#define HOST_MAX_TASKS          16
+#define HOST_SPIN_LIMIT         10000   /* 连续轮询次数超过该值视为忙等 */
+
+/* 堆记账: 按目标板heap_4的分配量扣除configTOTAL_HEAP_SIZE (Cortex-M3上的近似值, 仅动态分配) */
+#define HOST_HEAP_BLOCK_HEADER  8       /* heap_4块头 */
+#define HOST_HEAP_ALIGNMENT     8
+#define HOST_TCB_BYTES          96      /* TCB (含运行时间统计与任务名) */
+#define HOST_QUEUE_BYTES        80      /* Queue_t */
+
+/*============================================================================
+ * 私有类型
+ *============================================================================*/
+typedef enum {
+    HOST_TASK_READY,
+    HOST_TASK_BLOCKED,
+    HOST_TASK_SUSPENDED,
+    HOST_TASK_DELETED
+} HostTaskState;
+
+struct tskTaskControlBlock {
+    pthread_t thread;
+    pthread_cond_t cond;
+    TaskFunction_t entry;
+    void *param;
+    char name[configMAX_TASK_NAME_LEN];
+    UBaseType_t priority;
+    uint16_t stack_depth;
+    HostTaskState state;
+    TickType_t wake_tick;
+    bool has_timeout;
+    bool timed_out;
+    const void *wait_object;        /* 阻塞等待的内核对象 */
+    uint64_t ready_seq;             /* 同优先级轮转次序 */
+    UBaseType_t number;             /* 创建序号 (TaskStatus_t.xTaskNumber) */
+    UBaseType_t trace_number;       /* 跟踪用任务号 (vTaskSetTaskNumber) */
+    uint32_t run_time;              /* 累计运行时间 (portGET_RUN_TIME_COUNTER_VALUE计) */
+};
+
+struct QueueDefinition {
+    uint8_t *storage;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t count;
+    UBaseType_t head;
+};
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_start_cond = PTHREAD_COND_INITIALIZER;
+
+static TaskHandle_t s_tasks[HOST_MAX_TASKS];
+static int s_task_count;
+static TaskHandle_t s_current;
+static bool s_scheduler_running;
+static uint64_t s_seq;
+
+static volatile TickType_t s_tick;
+static struct timespec s_tick_real;             /* 当前节拍开始的真实时间 */
+static uint32_t s_busy_cycles;                  /* 本节拍内已建模的任务耗时 (HostSim_Busy) */
+static uint64_t s_last_cycles;                  /* HostSim_Cycles最近一次的返回值 */
+static volatile bool s_in_isr;
+static UBaseType_t s_critical_nesting;
+static UBaseType_t s_suspend_nesting;
+static uint32_t s_spin_count;
+
+static HostSim_TickCallback s_tick_callback;
+static HostSim_EndCallback s_end_callback;
+static TickType_t s_end_tick;
+static bool s_end_set;
+
+/* 空闲任务: 不参与调度, 全部任务阻塞期间的时间计入该任务 */
+static struct tskTaskControlBlock s_idle;
+static uint32_t s_run_mark;                     /* 上次记账时的运行时间计数 */
+
+/* 跟踪钩子中的当前任务 (对应内核pxCurrentTCB, 无就绪任务期间为空闲任务) */
+static TaskHandle_t s_trace_tcb;
+#define pxCurrentTCB    s_trace_tcb
+
+#if configSUPPORT_DYNAMIC_ALLOCATION
+static size_t s_heap_free = configTOTAL_HEAP_SIZE - HOST_HEAP_BLOCK_HEADER;
+static size_t s_heap_min_free = configTOTAL_HEAP_SIZE - HOST_HEAP_BLOCK_HEADER;
+#endif
+
+/* 固件提供的钩子 */
+extern void vApplicationTickHook(void);
+#if configUSE_MALLOC_FAILED_HOOK
+extern void vApplicationMallocFailedHook(void);
+#endif
+#if configSUPPORT_STATIC_ALLOCATION
+extern void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                          uint32_t *pulIdleTaskStackSize);
+#endif
+
+/*============================================================================
+ * 私有函数: 调度核心 (调用者持有s_lock)
+ *============================================================================*/
+
+/**
+ * @brief 自上次记账以来的运行时间计入任务
+ */
+static void HostSched_ChargeLocked(TaskHandle_t t)
+{
+#if configGENERATE_RUN_TIME_STATS
+    uint32_t now = portGET_RUN_TIME_COUNTER_VALUE();
+    if (t != NULL)
+    {
+        t->run_time += now - s_run_mark;
+    }
+    s_run_mark = now;
+#else
+    (void)t;
+#endif
+}
+
+#if configSUPPORT_DYNAMIC_ALLOCATION
+/**
+ * @brief 按heap_4的块大小从堆中扣除
+ * @return false=堆不足 (已调用分配失败钩子)
+ */
+static bool HostHeap_Take(size_t size)
+{
+    size = (size + HOST_HEAP_BLOCK_HEADER + HOST_HEAP_ALIGNMENT - 1) & ~(size_t)(HOST_HEAP_ALIGNMENT - 1);
+    if (size > s_heap_free)
+    {
+#if configUSE_MALLOC_FAILED_HOOK
+        vApplicationMallocFailedHook();
+#endif
+        return false;
+    }
+    s_heap_free -= size;
+    if (s_heap_free < s_heap_min_free)
+    {
+        s_heap_min_free = s_heap_free;
+    }
+    return true;
+}
+#endif
+
+/**
+ * @brief 选择最高优先级的就绪任务
+ */
+static TaskHandle_t HostSched_PickReady(void)
+{
+    TaskHandle_t best = NULL;
+    
+    for (int i = 0; i < s_task_count; i++)
+    {
+        TaskHandle_t t = s_tasks[i];
+        if (t->state != HOST_TASK_READY)
+        {
+            continue;
+        }
+        if (best == NULL || t->priority > best->priority ||
+            (t->priority == best->priority && t->ready_seq < best->ready_seq))
+        {
+            best = t;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief 使任务就绪 (排在同优先级末尾)
+ */
+static void HostSched_MakeReady(TaskHandle_t t)
+{
+    t->state = HOST_TASK_READY;
+    t->wait_object = NULL;
+    t->has_timeout = false;
+    t->ready_seq = ++s_seq;
+}
+
+/**
+ * @brief 唤醒所有等待指定对象的任务 (唤醒后重新检查条件)
+ * @return 被唤醒任务中的最高优先级, 无任务被唤醒时返回0
+ */
+static UBaseType_t HostSched_WakeWaiters(const void *object)
+{
+    UBaseType_t top = 0;
+    
+    for (int i = 0; i < s_task_count; i++)
+    {
+        TaskHandle_t t = s_tasks[i];
+        if (t->state == HOST_TASK_BLOCKED && t->wait_object == object)
+        {
+            HostSched_MakeReady(t);
+            t->timed_out = false;
+            if (t->priority + 1 > top)
+            {
+                top = t->priority + 1;
+            }
+        }
+    }
+    return top;
+}
+
+/**
+ * @brief 推进一个节拍: 节拍钩子、仿真回调、超时唤醒
+ */
+static void HostSched_TickLocked(void)
+{
+    s_tick++;
+    clock_gettime(CLOCK_MONOTONIC, &s_tick_real);
+    s_busy_cycles = 0;
+    s_spin_count = 0;
+    
+    /* 中断上下文回调期间释放锁, 回调内可调用FromISR接口 */
+    s_in_isr = true;
+    pthread_mutex_unlock(&s_lock);
+#if configUSE_TICK_HOOK
+    vApplicationTickHook();
+#endif
+    if (s_tick_callback != NULL)
+    {
+        s_tick_callback(s_tick);
+    }
+    if (s_end_set && s_tick >= s_end_tick)
+    {
+        if (s_end_callback != NULL)
+        {
+            s_end_callback();
+        }
+        fflush(NULL);
+        exit(0);
+    }
+    pthread_mutex_lock(&s_lock);
+    s_in_isr = false;
+    
+    for (int i = 0; i < s_task_count; i++)
+    {
+        TaskHandle_t t = s_tasks[i];
+        if (t->state == HOST_TASK_BLOCKED && t->has_timeout &&
+            (int32_t)(s_tick - t->wake_tick) >= 0)
+        {
+            HostSched_MakeReady(t);
+            t->timed_out = true;
+        }
+    }
+}
+
+/**
+ * @brief 切换到最高优先级就绪任务, 当前任务在再次被选中后返回
+ * 
+ * 当前任务应先设置好自身状态 (阻塞/就绪). 无就绪任务时推进节拍,
+ * 相当于空闲任务执行WFI直到下一次SysTick.
+ */
+static void HostSched_SwitchLocked(void)
+{
+    TaskHandle_t self = s_current;
+    TaskHandle_t next;
+    
+    s_spin_count = 0;
+    HostSched_ChargeLocked(self);
+    s_trace_tcb = (self != NULL) ? self : &s_idle;
+    traceTASK_SWITCHED_OUT();
+    if ((next = HostSched_PickReady()) == NULL)
+    {
+        s_trace_tcb = &s_idle;
+        traceTASK_SWITCHED_IN();
+        do
+        {
+            HostSched_TickLocked();
+            HostSched_ChargeLocked(&s_idle);
+        } while ((next = HostSched_PickReady()) == NULL);
+        traceTASK_SWITCHED_OUT();
+    }
+    s_trace_tcb = next;
+    traceTASK_SWITCHED_IN();
+    
+    if (next == self)
+    {
+        return;
+    }
+    
+    s_current = next;
+    pthread_cond_signal(&next->cond);
+    
+    if (self != NULL && self->state == HOST_TASK_DELETED)
+    {
+        pthread_mutex_unlock(&s_lock);
+        pthread_exit(NULL);
+    }
+    while (self != NULL && s_current != self)
+    {
+        pthread_cond_wait(&self->cond, &s_lock);
+    }
+}
+
+/**
+ * @brief 阻塞当前任务
+ * @param object 等待对象, NULL=纯延时
+ * @param ticks 超时节拍数, portMAX_DELAY=无限等待
+ * @return true=超时返回
+ */
+static bool HostSched_BlockLocked(const void *object, TickType_t ticks)
+{
+    TaskHandle_t self = s_current;
+    
+    if (ticks == 0)
+    {
+        return true;
+    }
+    self->state = HOST_TASK_BLOCKED;
+    self->wait_object = object;
+    self->has_timeout = (ticks != portMAX_DELAY);
+    self->wake_tick = s_tick + ticks;
+    self->timed_out = false;
+    HostSched_SwitchLocked();
+    return self->timed_out;
+}
+
+/**
+ * @brief 距截止节拍的剩余节拍数 (等待对象被反复唤醒时保持总超时不变)
+ */
+static TickType_t HostSched_Remaining(TickType_t deadline, TickType_t wait)
+{
+    if (wait == portMAX_DELAY)
+    {
+        return portMAX_DELAY;
+    }
+    return ((int32_t)(deadline - s_tick) > 0) ? (deadline - s_tick) : 0;
+}
+
+/**
+ * @brief 唤醒更高优先级任务后立即抢占 (临界区/调度器挂起/中断中除外)
+ */
+static void HostSched_PreemptLocked(UBaseType_t woken_top)
+{
+    if (woken_top == 0 || !s_scheduler_running || s_in_isr ||
+        s_critical_nesting > 0 || s_suspend_nesting > 0)
+    {
+        return;
+    }
+    if (woken_top - 1 > s_current->priority)
+    {
+        HostSched_SwitchLocked();               /* 当前任务保持就绪, 保留原次序 */
+    }
+}
+
+/**
+ * @brief 当前任务能否阻塞
+ */
+static bool HostSched_CanBlock(void)
+{
+    return s_scheduler_running && !s_in_isr && s_critical_nesting == 0 && s_suspend_nesting == 0;
+}
+
+/**
+ * @brief 任务线程入口
+ */
+static void *HostTask_Thread(void *arg)
+{
+    TaskHandle_t self = (TaskHandle_t)arg;
+    
+    pthread_mutex_lock(&s_lock);
+    while (s_current != self)
+    {
+        pthread_cond_wait(&self->cond, &s_lock);
+    }
+    pthread_mutex_unlock(&s_lock);
+    
+    self->entry(self->param);
+    
+    /* FreeRTOS任务函数不允许返回, 按删除处理 */
+    vTaskDelete(NULL);
+    return NULL;
+}
+
+/*============================================================================
+ * 仿真控制接口
+ *============================================================================*/
+
+void HostSim_SetTickCallback(HostSim_TickCallback callback)
+{
+    s_tick_callback = callback;
+}
+
+void HostSim_SetEndTick(TickType_t end_tick, HostSim_EndCallback callback)
+{
+    s_end_tick = end_tick;
+    s_end_callback = callback;
+    s_end_set = true;
+}
+
+uint64_t HostSim_Cycles(void)
+{
+    const uint64_t cycles_per_tick = SystemCoreClock / configTICK_RATE_HZ;
+    struct timespec now;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t ns = (int64_t)(now.tv_sec - s_tick_real.tv_sec) * 1000000000LL +
+                 (now.tv_nsec - s_tick_real.tv_nsec);
+    uint64_t frac = (ns > 0) ? (uint64_t)ns * (SystemCoreClock / 1000000U) / 1000U : 0;
+    frac += s_busy_cycles;
+    if (s_tick_real.tv_sec == 0 || frac >= cycles_per_tick)
+    {
+        frac = cycles_per_tick - 1U;
+    }
+    
+    /* 调度器启动时节拍内的真实时间重新计起, 保证不倒退 */
+    uint64_t cycles = (uint64_t)s_tick * cycles_per_tick + frac;
+    if (cycles < s_last_cycles)
+    {
+        cycles = s_last_cycles;
+    }
+    s_last_cycles = cycles;
+    return cycles;
+}
+
+double HostSim_Seconds(void)
+{
+    return (double)HostSim_Cycles() / (double)SystemCoreClock;
+}
+
+bool HostSim_InIsr(void)
+{
+    return s_in_isr;
+}
+
+/**
+ * @brief 基准测试计时器: x86上为TSC, 其他平台为纳秒
+ */
+uint32_t HostSim_BenchNow(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+#endif
+}
+
+/**
+ * @brief 基准测试计时器频率: 以CLOCK_MONOTONIC校准50ms, 结果缓存
+ */
+uint32_t HostSim_BenchHz(void)
+{
+    static uint32_t hz;
+    
+    if (hz == 0)
+    {
+        struct timespec t0, now;
+        int64_t ns;
+        
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        uint32_t c0 = HostSim_BenchNow();
+        do
+        {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            ns = (int64_t)(now.tv_sec - t0.tv_sec) * 1000000000LL + (now.tv_nsec - t0.tv_nsec);
+        } while (ns < 50000000LL);
+        uint32_t c1 = HostSim_BenchNow();
+        hz = (uint32_t)((double)(uint32_t)(c1 - c0) * 1e9 / (double)ns + 0.5);
+    }
+    return hz;
+}
+
+void HostSim_Wait(TickType_t ticks)
+{
+    if (HostSched_CanBlock())
+    {
+        vTaskDelay(ticks);
+        return;
+    }
+    
+    /* 启动阶段或临界区内: 原地推进节拍, 被唤醒的任务在下次切换时运行 */
+    if (!s_in_isr)
+    {
+        pthread_mutex_lock(&s_lock);
+        while (ticks-- > 0)
+        {
+            HostSched_TickLocked();
+        }
+        pthread_mutex_unlock(&s_lock);
+    }
+}
+
+void HostSim_Busy(uint32_t cycles)
+{
+    const uint32_t cycles_per_tick = SystemCoreClock / configTICK_RATE_HZ;
+    
+    if (s_in_isr)
+    {
+        return;
+    }
+    
+    /* 跨过节拍边界时原地推进节拍 (SysTick在任务执行中途到来, 任务不被切换) */
+    pthread_mutex_lock(&s_lock);
+    s_busy_cycles += cycles;
+    while (s_busy_cycles >= cycles_per_tick)
+    {
+        uint32_t rest = s_busy_cycles - cycles_per_tick;
+        HostSched_TickLocked();
+        s_busy_cycles = rest;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void HostSim_Poll(void)
+{
+    if (++s_spin_count >= HOST_SPIN_LIMIT)
+    {
+        s_spin_count = 0;
+        HostSim_Wait(1);
+    }
+}
+
+/*============================================================================
+ * 任务接口
+ *============================================================================*/
+
+/**
+ * @brief 创建任务线程并加入就绪表 (控制块由主机分配, 任务在主机线程栈上运行)
+ * @return NULL=失败
+ */
+static TaskHandle_t HostTask_New(TaskFunction_t pxTaskCode, const char *pcName, uint16_t usStackDepth,
+                                 void *pvParameters, UBaseType_t uxPriority)
+{
+    TaskHandle_t t;
+    
+    if ((t = calloc(1, sizeof(*t))) == NULL)
+    {
+        return NULL;
+    }
+    
+    t->entry = pxTaskCode;
+    t->param = pvParameters;
+    strncpy(t->name, pcName, sizeof(t->name) - 1);
+    t->priority = (uxPriority < configMAX_PRIORITIES) ? uxPriority : configMAX_PRIORITIES - 1;
+    t->stack_depth = usStackDepth;
+    pthread_cond_init(&t->cond, NULL);
+    
+    pthread_mutex_lock(&s_lock);
+    HostSched_MakeReady(t);
+    s_tasks[s_task_count++] = t;
+    t->number = (UBaseType_t)s_task_count;
+    pthread_mutex_unlock(&s_lock);
+    
+    if (pthread_create(&t->thread, NULL, HostTask_Thread, t) != 0)
+    {
+        return NULL;
+    }
+    return t;
+}
+
+/**
+ * @brief 运行中创建更高优先级任务时立即切换
+ */
+static void HostTask_PreemptNew(TaskHandle_t t)
+{
+    pthread_mutex_lock(&s_lock);
+    HostSched_PreemptLocked(t->priority + 1);
+    pthread_mutex_unlock(&s_lock);
+}
+
+#if configSUPPORT_DYNAMIC_ALLOCATION
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char * const pcName, const uint16_t usStackDepth,
+                       void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask)
+{
+    TaskHandle_t t;
+    
+    if (s_task_count >= HOST_MAX_TASKS || !HostHeap_Take((size_t)usStackDepth * sizeof(StackType_t)) ||
+        !HostHeap_Take(HOST_TCB_BYTES) ||
+        (t = HostTask_New(pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority)) == NULL)
+    {
+        return pdFAIL;
+    }
+    
+    if (pxCreatedTask != NULL)
+    {
+        *pxCreatedTask = t;
+    }
+    HostTask_PreemptNew(t);
+    return pdPASS;
+}
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION
+TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode, const char * const pcName, const uint32_t ulStackDepth,
+                               void * const pvParameters, UBaseType_t uxPriority, StackType_t * const puxStackBuffer,
+                               StaticTask_t * const pxTaskBuffer)
+{
+    TaskHandle_t t;
+    
+    /* 与内核相同: 缓冲为NULL时不创建 */
+    if (s_task_count >= HOST_MAX_TASKS || puxStackBuffer == NULL || pxTaskBuffer == NULL ||
+        (t = HostTask_New(pxTaskCode, pcName, (uint16_t)ulStackDepth, pvParameters, uxPriority)) == NULL)
+    {
+        return NULL;
+    }
+    
+    HostTask_PreemptNew(t);
+    return t;
+}
+#endif
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    pthread_mutex_lock(&s_lock);
+    TaskHandle_t t = (xTaskToDelete != NULL) ? xTaskToDelete : s_current;
+    t->state = HOST_TASK_DELETED;
+    if (t == s_current)
+    {
+        HostSched_SwitchLocked();               /* 不返回 */
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    pthread_mutex_lock(&s_lock);
+    if (xTicksToDelay == 0)
+    {
+        s_current->ready_seq = ++s_seq;
+        HostSched_SwitchLocked();
+    }
+    else
+    {
+        HostSched_BlockLocked(NULL, xTicksToDelay);
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void vTaskDelayUntil(TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement)
+{
+    pthread_mutex_lock(&s_lock);
+    TickType_t wake = *pxPreviousWakeTime + xTimeIncrement;
+    *pxPreviousWakeTime = wake;
+    if ((int32_t)(wake - s_tick) > 0)
+    {
+        HostSched_BlockLocked(NULL, wake - s_tick);
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return s_tick;
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return s_tick;
+}
+
+void vTaskStartScheduler(void)
+{
+    /* 与内核相同: 创建空闲任务 (只占内存, 不运行) 并启动运行时间统计时基 */
+    strncpy(s_idle.name, "IDLE", sizeof(s_idle.name) - 1);
+    s_idle.state = HOST_TASK_READY;
+    s_idle.number = (UBaseType_t)s_task_count + 1;
+#if configSUPPORT_STATIC_ALLOCATION
+    StaticTask_t *idle_tcb = NULL;
+    StackType_t *idle_stack = NULL;
+    uint32_t idle_depth = 0;
+    vApplicationGetIdleTaskMemory(&idle_tcb, &idle_stack, &idle_depth);
+    s_idle.stack_depth = (uint16_t)idle_depth;
+#else
+    s_idle.stack_depth = configMINIMAL_STACK_SIZE;
+    HostHeap_Take((size_t)configMINIMAL_STACK_SIZE * sizeof(StackType_t));
+    HostHeap_Take(HOST_TCB_BYTES);
+#endif
+#if configGENERATE_RUN_TIME_STATS
+    portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
+#endif
+    
+    pthread_mutex_lock(&s_lock);
+    clock_gettime(CLOCK_MONOTONIC, &s_tick_real);
+#if configGENERATE_RUN_TIME_STATS
+    s_run_mark = portGET_RUN_TIME_COUNTER_VALUE();
+#endif
+    s_scheduler_running = true;
+    s_current = NULL;
+    HostSched_SwitchLocked();
+    
+    /* 主线程不再参与调度, 进程由结束节拍或固件自身终止 */
+    for (;;)
+    {
+        pthread_cond_wait(&s_start_cond, &s_lock);
+    }
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+{
+    UBaseType_t n = 0;
+    
+    for (int i = 0; i < s_task_count; i++)
+    {
+        n += (s_tasks[i]->state != HOST_TASK_DELETED) ? 1 : 0;
+    }
+    return n + (s_scheduler_running ? 1 : 0);
+}
+
+/**
+ * @brief 填写一个任务的状态 (主机线程栈与目标板不可比, 栈高水位恒为栈大小)
+ */
+static void HostTask_Status(TaskHandle_t t, TaskStatus_t *st)
+{
+    static const eTaskState map[] = { eReady, eBlocked, eSuspended, eDeleted };
+    
+    st->xHandle = t;
+    st->pcTaskName = t->name;
+    st->xTaskNumber = t->number;
+    st->eCurrentState = (t == s_current) ? eRunning : map[t->state];
+    st->uxCurrentPriority = t->priority;
+    st->uxBasePriority = t->priority;
+    st->ulRunTimeCounter = t->run_time;
+    st->pxStackBase = NULL;
+    st->usStackHighWaterMark = t->stack_depth;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize,
+                                 uint32_t * const pulTotalRunTime)
+{
+    UBaseType_t n = 0;
+    
+    pthread_mutex_lock(&s_lock);
+    if (uxArraySize < uxTaskGetNumberOfTasks())
+    {
+        pthread_mutex_unlock(&s_lock);
+        return 0;
+    }
+    HostSched_ChargeLocked(s_current);
+    for (int i = 0; i < s_task_count; i++)
+    {
+        if (s_tasks[i]->state != HOST_TASK_DELETED)
+        {
+            HostTask_Status(s_tasks[i], &pxTaskStatusArray[n++]);
+        }
+    }
+    if (s_scheduler_running)
+    {
+        HostTask_Status(&s_idle, &pxTaskStatusArray[n++]);
+    }
+    if (pulTotalRunTime != NULL)
+    {
+        *pulTotalRunTime = s_run_mark;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return n;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask)
+{
+    return (xTask != NULL) ? xTask->stack_depth : s_current->stack_depth;
+}
+
+TaskHandle_t xTaskGetIdleTaskHandle(void)
+{
+    return &s_idle;
+}
+
+void vTaskSetTaskNumber(TaskHandle_t xTask, const UBaseType_t uxHandle)
+{
+    if (xTask != NULL)
+    {
+        xTask->trace_number = uxHandle;
+    }
+}
+
+UBaseType_t uxTaskGetTaskNumber(TaskHandle_t xTask)
+{
+    return (xTask != NULL) ? xTask->trace_number : 0;
+}
+
+#if configSUPPORT_DYNAMIC_ALLOCATION
+size_t xPortGetFreeHeapSize(void)
+{
+    return s_heap_free;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return s_heap_min_free;
+}
+#endif
+
+void vTaskSuspendAll(void)
+{
+    s_suspend_nesting++;
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    BaseType_t yielded = pdFALSE;
+    
+    pthread_mutex_lock(&s_lock);
+    if (--s_suspend_nesting == 0 && s_critical_nesting == 0)
+    {
+        TaskHandle_t next = HostSched_PickReady();
+        if (next != NULL && next->priority > s_current->priority)
+        {
+            HostSched_SwitchLocked();
+            yielded = pdTRUE;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return yielded;
+}
+
+void vPortEnterCritical(void)
+{
+    s_critical_nesting++;
+}
+
+void vPortExitCritical(void)
+{
+    s_critical_nesting--;
+}
+
+void vPortYield(void)
+{
+    vTaskDelay(0);
+}
+
+/*============================================================================
+ * 队列接口
+ *============================================================================*/
+
+#if configSUPPORT_DYNAMIC_ALLOCATION
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+    QueueHandle_t q;
+    
+    if (!HostHeap_Take(HOST_QUEUE_BYTES + (size_t)uxQueueLength * uxItemSize) ||
+        (q = calloc(1, sizeof(*q))) == NULL)
+    {
+        return NULL;
+    }
+    q->storage = calloc(uxQueueLength, uxItemSize > 0 ? uxItemSize : 1);
+    q->length = uxQueueLength;
+    q->item_size = uxItemSize;
+    return q;
+}
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION
+QueueHandle_t xQueueCreateStatic(UBaseType_t uxQueueLength, UBaseType_t uxItemSize, uint8_t *pucQueueStorageBuffer,
+                                 StaticQueue_t *pxQueueBuffer)
+{
+    QueueHandle_t q;
+    
+    /* 与内核相同: 元素大小非0时必须提供存储区 (固件的存储区直接用作队列环形缓冲) */
+    if (pxQueueBuffer == NULL || (uxItemSize > 0 && pucQueueStorageBuffer == NULL) ||
+        (q = calloc(1, sizeof(*q))) == NULL)
+    {
+        return NULL;
+    }
+    q->storage = pucQueueStorageBuffer;
+    q->length = uxQueueLength;
+    q->item_size = uxItemSize;
+    return q;
+}
+#endif
+
+/**
+ * @brief 入队 (调用者持有s_lock)
+ * @return 被唤醒任务中的最高优先级+1, 队列满时返回-1
+ */
+static long HostQueue_PutLocked(QueueHandle_t q, const void *item)
+{
+    if (q->count >= q->length)
+    {
+        return -1;
+    }
+    memcpy(q->storage + ((q->head + q->count) % q->length) * q->item_size, item, q->item_size);
+    q->count++;
+    return (long)HostSched_WakeWaiters(q);
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
+{
+    pthread_mutex_lock(&s_lock);
+    TickType_t deadline = s_tick + xTicksToWait;
+    for (;;)
+    {
+        long woken = HostQueue_PutLocked(xQueue, pvItemToQueue);
+        if (woken >= 0)
+        {
+            HostSched_PreemptLocked((UBaseType_t)woken);
+            pthread_mutex_unlock(&s_lock);
+            return pdPASS;
+        }
+        if (xTicksToWait == 0 || !HostSched_CanBlock() ||
+            HostSched_BlockLocked(xQueue, HostSched_Remaining(deadline, xTicksToWait)))
+        {
+            pthread_mutex_unlock(&s_lock);
+            return errQUEUE_FULL;
+        }
+    }
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    pthread_mutex_lock(&s_lock);
+    long woken = HostQueue_PutLocked(xQueue, pvItemToQueue);
+    if (woken > 0 && pxHigherPriorityTaskWoken != NULL && s_current != NULL &&
+        (UBaseType_t)woken - 1 > s_current->priority)
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return (woken >= 0) ? pdPASS : errQUEUE_FULL;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    pthread_mutex_lock(&s_lock);
+    TickType_t deadline = s_tick + xTicksToWait;
+    for (;;)
+    {
+        if (xQueue->count > 0)
+        {
+            memcpy(pvBuffer, xQueue->storage + xQueue->head * xQueue->item_size, xQueue->item_size);
+            xQueue->head = (xQueue->head + 1) % xQueue->length;
+            xQueue->count--;
+            HostSched_PreemptLocked(HostSched_WakeWaiters(xQueue));
+            pthread_mutex_unlock(&s_lock);
+            return pdPASS;
+        }
+        if (xTicksToWait == 0 || !HostSched_CanBlock() ||
+            HostSched_BlockLocked(xQueue, HostSched_Remaining(deadline, xTicksToWait)))
+        {
+            pthread_mutex_unlock(&s_lock);
+            return errQUEUE_EMPTY;
+        }
+    }
+}
+
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t xQueue)
+{
+    return xQueue->count;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue)
+{
+    pthread_mutex_lock(&s_lock);
+    xQueue->count = 0;
+    xQueue->head = 0;
+    HostSched_PreemptLocked(HostSched_WakeWaiters(xQueue));
+    pthread_mutex_unlock(&s_lock);
+    return pdPASS;
+}
@@ -0,0 +1,93 @@
+#ifndef __FREERTOS_HOST_H
+#define __FREERTOS_HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOS.h"
+#include <stdbool.h>
+
+/*============================================================================
+ * 主机 FreeRTOS 替身 (确定性虚拟时间, 不是FreeRTOS内核)
+ * 
+ * - 每个任务一个POSIX线程, 任一时刻只有一个线程在运行 (令牌传递)
+ * - 就绪任务之间按优先级调度, 同优先级按就绪先后轮转
+ * - 任务执行不消耗虚拟时间; 全部任务阻塞时节拍计数直接跳到下一节拍,
+ *   依次执行节拍钩子与仿真回调 (相当于SysTick中断)
+ * - 运行结果只取决于固件代码与仿真输入, 与主机负载无关
+ * 
+ * 未使用上游POSIX移植: 本树不含内核源码 (由BSP提供), 且POSIX移植以真实时间
+ * 信号驱动节拍, 结果随主机负载变化, 采集记录回放与回归比较需要逐位可复现.
+ * 与目标板FreeRTOS的差异 (只实现固件用到的接口):
+ * - 只在内核调用 (阻塞/让出/恢复调度/中断唤醒) 处切换任务, 任务代码中途不会
+ *   被抢占; 节拍在全部任务阻塞时发生, 或在建模的外设耗时 (HostSim_Busy, 如SPI
+ *   逐字节传输) 跨过节拍边界时发生. 依赖抢占时序的竞争在主机上不出现
+ * - 临界区与vTaskSuspendAll只是嵌套计数 (单令牌下本来就互斥)
+ * - 任务占用率与截止时间监视只含HostSim_Busy建模的耗时 (SPI传输), 不含指令
+ *   执行时间; 栈高水位恒为栈大小
+ * - 无tickless空闲: 睡眠钩子不调用, 睡眠占比为0, HAL_GetTick即虚拟节拍
+ * - 中断优先级与嵌套不建模, CAN发送在提交时同步完成
+ *============================================================================*/
+
+typedef void (*HostSim_TickCallback)(TickType_t tick);
+typedef void (*HostSim_EndCallback)(void);
+
+/**
+ * @brief 注册每节拍回调 (在节拍中断上下文执行, 用于注入CAN帧等)
+ */
+void HostSim_SetTickCallback(HostSim_TickCallback callback);
+
+/**
+ * @brief 设置仿真结束节拍, 到达后调用回调并退出进程
+ */
+void HostSim_SetEndTick(TickType_t end_tick, HostSim_EndCallback callback);
+
+/**
+ * @brief 当前虚拟周期数 (64-bit, SystemCoreClock计)
+ * 节拍内叠加真实流逝时间 (不超过一个节拍), 使同一节拍内的先后操作可区分
+ */
+uint64_t HostSim_Cycles(void);
+
+/**
+ * @brief 当前虚拟时间 (秒)
+ */
+double HostSim_Seconds(void);
+
+/**
+ * @brief 当前是否处于中断上下文 (节拍回调)
+ */
+bool HostSim_InIsr(void);
+
+/**
+ * @brief 基准测试计时器 (真实时间, 与虚拟时钟无关), 32-bit回绕
+ */
+uint32_t HostSim_BenchNow(void);
+
+/**
+ * @brief 基准测试计时器频率 (首次调用时校准)
+ */
+uint32_t HostSim_BenchHz(void);
+
+/**
+ * @brief 让虚拟时间前进若干节拍
+ * 调度器运行且允许阻塞时等同vTaskDelay, 否则原地推进节拍 (启动阶段/临界区内)
+ */
+void HostSim_Wait(TickType_t ticks);
+
+/**
+ * @brief 当前任务消耗cycles个周期 (外设传输等建模的耗时), 跨过节拍边界时推进节拍
+ * 中断上下文中调用无效
+ */
+void HostSim_Busy(uint32_t cycles);
+
+/**
+ * @brief 忙等检测: 固件轮询HAL_GetTick时调用, 连续轮询过多时推进一个节拍
+ */
+void HostSim_Poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FREERTOS_HOST_H */
@@ -0,0 +1,164 @@
+#include "gyro_noise_model.h"
+#include "xvlog.h"
+#include "xv7001bb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/*============================================================================
+ * gyro_model_gen: 不经固件直接生成误差模型输出
+ * 
+ * 用法: gyro_model_gen [-t 秒] [-hz 采样率] [-p 剖面文件] [-seed N] [-o 输出.csv] [-x 记录.xvl]
+ *   输出CSV每行: 时间s, 24-bit计数, 温度°C, 真实角速度dps
+ *   -x 生成采集记录文件 (每个样本一条, 传感器始终就绪), 供xvlog_replay处理长时间数据
+ * 结束时打印生成速度、零偏统计和直接积分的漂移 (°/h), 作为算法评估的基准
+ *============================================================================*/
+#define GEN_MAX_SEGMENTS    64
+
+int main(int argc, char **argv)
+{
+    double seconds = 3600.0;
+    double hz = 100.0;
+    const char *out_path = NULL;
+    static GyroProfile_Segment segments[GEN_MAX_SEGMENTS];
+    GyroProfile profile = { segments, 0 };
+    GyroNoise_Params params;
+    GyroNoise_Model model;
+    FILE *out = NULL;
+    const char *xvl_path = NULL;
+    FILE *xvl = NULL;
+    
+    GyroNoise_DefaultParams(&params);
+    
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-hz") == 0 && i + 1 < argc)
+        {
+            hz = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+        {
+            profile.count = GyroProfile_Load(argv[++i], segments, GEN_MAX_SEGMENTS);
+            if (profile.count < 0)
+            {
+                fprintf(stderr, "cannot read profile %s\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+        {
+            params.seed = strtoull(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            out_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-x") == 0 && i + 1 < argc)
+        {
+            xvl_path = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-t seconds] [-hz rate] [-p profile] [-seed N] [-o out.csv] [-x out.xvl]\n", argv[0]);
+            return 2;
+        }
+    }
+    
+    if (out_path != NULL && (out = fopen(out_path, "w")) == NULL)
+    {
+        fprintf(stderr, "cannot write %s\n", out_path);
+        return 2;
+    }
+    
+    if (xvl_path != NULL)
+    {
+        XvLog_FileHeader header;
+        
+        if ((xvl = fopen(xvl_path, "wb")) == NULL)
+        {
+            fprintf(stderr, "cannot write %s\n", xvl_path);
+            return 2;
+        }
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, XVLOG_MAGIC, sizeof(header.magic));
+        header.version = XVLOG_VERSION;
+        header.record_size = XVLOG_RECORD_SIZE;
+        header.period_ms = (uint16_t)(1000.0 / hz + 0.5);
+        fwrite(&header, sizeof(header), 1, xvl);
+    }
+    
+    GyroNoise_Init(&model, &params, &profile);
+    
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    
+    uint64_t n = (uint64_t)(seconds * hz);
+    double dt = 1.0 / hz;
+    double sum_err = 0.0;
+    double sum_err2 = 0.0;
+    double angle = 0.0;
+    
+    for (uint64_t k = 1; k <= n; k++)
+    {
+        double t = (double)k * dt;
+        int32_t raw = GyroNoise_Raw(&model, t);
+        double rate_true;
+        double temp;
+        
+        GyroProfile_At(&profile, t, &rate_true, &temp);
+        double err = raw / params.sensitivity_lsb - rate_true;
+        sum_err += err;
+        sum_err2 += err * err;
+        angle += raw / params.sensitivity_lsb * dt;
+        
+        if (out != NULL)
+        {
+            fprintf(out, "%.6f,%d,%.3f,%.6f\n", t, raw, temp, rate_true);
+        }
+        if (xvl != NULL)
+        {
+            /* 温度编码与设备模型一致: raw = (T + 6) * 16, 10-bit */
+            double code = (temp + 6.0) * 16.0;
+            GyroPipeline_Sample sample = {
+                true, XV7_STATUS_PROC_OK | XV7_STATE_SLEEP_OUT,
+                true, raw,
+                true, (uint16_t)((code < 0.0) ? 0 : (code > 1023.0) ? 1023 : (uint16_t)(code + 0.5))
+            };
+            uint8_t rec[XVLOG_RECORD_SIZE];
+            
+            XvLog_EncodeSample(rec, &sample);
+            rec[0] |= (uint8_t)((k - 1) & XVLOG_SEQ_MASK);
+            fwrite(rec, sizeof(rec), 1, xvl);
+        }
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double real_s = (double)(t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    double mean = (n > 0) ? sum_err / n : 0.0;
+    double sd = (n > 1) ? sqrt((sum_err2 - n * mean * mean) / (n - 1)) : 0.0;
+    double drift = angle - GyroProfile_Angle(&profile, seconds);
+    
+    printf("samples         %llu\n", (unsigned long long)n);
+    printf("samples_per_s   %.0f\n", real_s > 0 ? n / real_s : 0.0);
+    printf("speedup         x%.0f\n", real_s > 0 ? seconds / real_s : 0.0);
+    printf("error_mean_dps  %.6f\n", mean);
+    printf("error_sd_dps    %.6f\n", sd);
+    printf("raw_drift_deg   %.4f\n", drift);
+    printf("raw_drift_deg_h %.4f\n", seconds > 0 ? drift * 3600.0 / seconds : 0.0);
+    
+    if (out != NULL)
+    {
+        fclose(out);
+    }
+    if (xvl != NULL)
+    {
+        fclose(xvl);
+    }
+    return 0;
+}
@@ -0,0 +1,285 @@
+#include "gyro_noise_model.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+/**
+ * @brief xorshift64* 均匀随机数 [0,1)
+ */
+static double GyroNoise_Uniform(GyroNoise_Model *m)
+{
+    m->rng ^= m->rng >> 12;
+    m->rng ^= m->rng << 25;
+    m->rng ^= m->rng >> 27;
+    return (double)((m->rng * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief 标准正态随机数 (Box-Muller)
+ */
+static double GyroNoise_Gauss(GyroNoise_Model *m)
+{
+    double u1 = GyroNoise_Uniform(m);
+    double u2 = GyroNoise_Uniform(m);
+    
+    if (u1 < 1e-300)
+    {
+        u1 = 1e-300;
+    }
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/*============================================================================
+ * 剖面
+ *============================================================================*/
+
+/**
+ * @brief 定位时刻t所在剖面段, 从上次位置顺序推进 (长剖面每次读取O(1))
+ * @param u 段内位置 [0,1], 超出最后一段时为1
+ */
+static const GyroProfile_Segment *GyroNoise_Segment(GyroNoise_Model *m, double t, double *u)
+{
+    const GyroProfile *profile = &m->profile;
+    const GyroProfile_Segment *seg;
+    
+    while (m->seg_index < profile->count - 1 &&
+           t >= m->seg_start + profile->segments[m->seg_index].duration_s)
+    {
+        m->seg_start += profile->segments[m->seg_index].duration_s;
+        m->seg_index++;
+    }
+    seg = &profile->segments[m->seg_index];
+    *u = (t < m->seg_start + seg->duration_s) ? (t - m->seg_start) / seg->duration_s : 1.0;
+    return seg;
+}
+
+void GyroProfile_At(const GyroProfile *profile, double t, double *rate_dps, double *temp_c)
+{
+    double rate = 0.0;
+    double temp = 25.0;
+    
+    if (profile != NULL && profile->count > 0)
+    {
+        const GyroProfile_Segment *seg = &profile->segments[profile->count - 1];
+        double u = 1.0;
+        
+        for (int i = 0; i < profile->count; i++)
+        {
+            if (t < profile->segments[i].duration_s)
+            {
+                seg = &profile->segments[i];
+                u = t / seg->duration_s;
+                break;
+            }
+            t -= profile->segments[i].duration_s;
+        }
+        rate = seg->rate_start_dps + (seg->rate_end_dps - seg->rate_start_dps) * u;
+        temp = seg->temp_start_c + (seg->temp_end_c - seg->temp_start_c) * u;
+    }
+    
+    if (rate_dps != NULL)
+    {
+        *rate_dps = rate;
+    }
+    if (temp_c != NULL)
+    {
+        *temp_c = temp;
+    }
+}
+
+double GyroProfile_Angle(const GyroProfile *profile, double t)
+{
+    double angle = 0.0;
+    
+    if (profile == NULL || profile->count == 0)
+    {
+        return 0.0;
+    }
+    
+    for (int i = 0; i < profile->count && t > 0.0; i++)
+    {
+        const GyroProfile_Segment *seg = &profile->segments[i];
+        double span = (t < seg->duration_s || i == profile->count - 1) ? t : seg->duration_s;
+        double slope = (seg->duration_s > 0.0) ? (seg->rate_end_dps - seg->rate_start_dps) / seg->duration_s : 0.0;
+        
+        /* 最后一段之后保持末值 */
+        if (i == profile->count - 1 && span > seg->duration_s)
+        {
+            angle += seg->rate_start_dps * seg->duration_s + 0.5 * slope * seg->duration_s * seg->duration_s;
+            angle += seg->rate_end_dps * (span - seg->duration_s);
+        }
+        else
+        {
+            angle += seg->rate_start_dps * span + 0.5 * slope * span * span;
+        }
+        t -= span;
+    }
+    return angle;
+}
+
+int GyroProfile_Load(const char *path, GyroProfile_Segment *segments, int max_segments)
+{
+    FILE *f = fopen(path, "r");
+    char line[256];
+    int count = 0;
+    
+    if (f == NULL)
+    {
+        return -1;
+    }
+    
+    while (count < max_segments && fgets(line, sizeof(line), f) != NULL)
+    {
+        GyroProfile_Segment *seg = &segments[count];
+        if (line[0] == '#')
+        {
+            continue;
+        }
+        if (sscanf(line, "%lf %lf %lf %lf %lf", &seg->duration_s, &seg->rate_start_dps,
+                   &seg->rate_end_dps, &seg->temp_start_c, &seg->temp_end_c) == 5)
+        {
+            count++;
+        }
+    }
+    fclose(f);
+    return count;
+}
+
+/*============================================================================
+ * 误差模型
+ *============================================================================*/
+
+void GyroNoise_DefaultParams(GyroNoise_Params *params)
+{
+    memset(params, 0, sizeof(*params));
+    params->arw_dps_rthz = 0.1 / 60.0;              /* 0.1 °/√h */
+    params->bias_instability_dps = 1.0 / 3600.0;    /* 1 °/h */
+    params->bias_corr_time_s = 100.0;
+    params->rrw_dps_rts = 1e-5;
+    params->initial_bias_dps = 0.05;
+    params->temp_coeff_dps_c = 0.002;
+    params->temp_ref_c = 25.0;
+    params->scale_error_ppm = 1000.0;
+    params->sensitivity_lsb = 71680.0;
+    params->seed = 1;
+}
+
+void GyroNoise_Init(GyroNoise_Model *model, const GyroNoise_Params *params, const GyroProfile *profile)
+{
+    memset(model, 0, sizeof(*model));
+    model->params = *params;
+    if (profile != NULL)
+    {
+        model->profile = *profile;
+    }
+    model->rng = params->seed ? params->seed : 0x9E3779B97F4A7C15ULL;
+    
+    /* Gauss-Markov过程从稳态分布开始 */
+    model->gm_bias = params->bias_instability_dps * GyroNoise_Gauss(model);
+}
+
+/**
+ * @brief 测量角速度
+ * 
+ * 两次读取间隔dt内:
+ *   Gauss-Markov: x ← e^(-dt/τ)·x + σ·√(1-e^(-2dt/τ))·w
+ *   随机游走:     b ← b + K·√dt·w
+ *   白噪声在dt内的均值: σ = N/√dt
+ */
+double GyroNoise_Rate(GyroNoise_Model *model, double t)
+{
+    const GyroNoise_Params *p = &model->params;
+    double rate_true;
+    double temp;
+    double dt;
+    
+    if (model->has_last && t <= model->last_t)
+    {
+        return model->last_rate;
+    }
+    
+    dt = model->has_last ? t - model->last_t : 0.01;
+    if (dt < 1e-6)
+    {
+        dt = 1e-6;
+    }
+    
+    if (p->bias_corr_time_s > 0.0)
+    {
+        double phi = exp(-dt / p->bias_corr_time_s);
+        model->gm_bias = phi * model->gm_bias +
+                         p->bias_instability_dps * sqrt(1.0 - phi * phi) * GyroNoise_Gauss(model);
+    }
+    model->rrw_bias += p->rrw_dps_rts * sqrt(dt) * GyroNoise_Gauss(model);
+    
+    if (model->profile.count > 0)
+    {
+        double u;
+        const GyroProfile_Segment *seg = GyroNoise_Segment(model, t, &u);
+        rate_true = seg->rate_start_dps + (seg->rate_end_dps - seg->rate_start_dps) * u;
+        temp = seg->temp_start_c + (seg->temp_end_c - seg->temp_start_c) * u;
+    }
+    else
+    {
+        GyroProfile_At(NULL, t, &rate_true, &temp);
+    }
+    double bias = p->initial_bias_dps + model->gm_bias + model->rrw_bias +
+                  p->temp_coeff_dps_c * (temp - p->temp_ref_c);
+    double white = p->arw_dps_rthz / sqrt(dt) * GyroNoise_Gauss(model);
+    
+    model->last_rate = (1.0 + p->scale_error_ppm * 1e-6) * rate_true + bias + white;
+    model->last_t = t;
+    model->last_temp = temp;
+    model->has_last = 1;
+    return model->last_rate;
+}
+
+double GyroNoise_Bias(const GyroNoise_Model *model)
+{
+    const GyroNoise_Params *p = &model->params;
+    
+    return p->initial_bias_dps + model->gm_bias + model->rrw_bias +
+           p->temp_coeff_dps_c * (model->last_temp - p->temp_ref_c);
+}
+
+int32_t GyroNoise_Raw(GyroNoise_Model *model, double t)
+{
+    double lsb = floor(GyroNoise_Rate(model, t) * model->params.sensitivity_lsb + 0.5);
+    
+    if (lsb > XV7_MODEL_RAW_MAX)
+    {
+        lsb = XV7_MODEL_RAW_MAX;
+    }
+    if (lsb < -XV7_MODEL_RAW_MAX - 1)
+    {
+        lsb = -XV7_MODEL_RAW_MAX - 1;
+    }
+    return (int32_t)lsb;
+}
+
+/*============================================================================
+ * 设备模型样本源适配
+ *============================================================================*/
+static double GyroNoise_SourceRate(void *ctx, double t)
+{
+    return GyroNoise_Rate((GyroNoise_Model *)ctx, t);
+}
+
+static float GyroNoise_SourceTemp(void *ctx, double t)
+{
+    double temp;
+    
+    GyroProfile_At(&((GyroNoise_Model *)ctx)->profile, t, NULL, &temp);
+    return (float)temp;
+}
+
+void GyroNoise_MakeSource(GyroNoise_Model *model, Xv7Model_Source *source)
+{
+    source->rate_dps = GyroNoise_SourceRate;
+    source->temp_c = GyroNoise_SourceTemp;
+    source->ctx = model;
+}
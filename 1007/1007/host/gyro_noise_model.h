@@ -0,0 +1,116 @@
+#ifndef __GYRO_NOISE_MODEL_H
+#define __GYRO_NOISE_MODEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xv7001bb_model.h"
+#include <stdint.h>
+
+/*============================================================================
+ * 陀螺仪误差模型 (用于算法评估)
+ * 
+ * 输出 = (1 + 标度误差) × 真实角速度 + 零偏 + 角度随机游走噪声
+ * 零偏 = 初始零偏 + 一阶Gauss-Markov (零偏不稳定性) + 角速率随机游走
+ *        + 温度系数 × (T - 参考温度)
+ * 量化: 按灵敏度取整为24-bit计数并饱和
+ * 
+ * 各项噪声在读取时刻按两次读取的时间间隔精确离散化,
+ * 与采样率无关; 随机数生成器自带实现, 相同种子在任何平台输出相同.
+ *============================================================================*/
+
+/* 运动/温度剖面段: 段内角速度和温度线性变化, 最后一段之后保持末值 */
+typedef struct {
+    double duration_s;
+    double rate_start_dps;
+    double rate_end_dps;
+    double temp_start_c;
+    double temp_end_c;
+} GyroProfile_Segment;
+
+typedef struct {
+    const GyroProfile_Segment *segments;
+    int count;
+} GyroProfile;
+
+/* 误差参数 */
+typedef struct {
+    double arw_dps_rthz;            /* 角度随机游走 °/s/√Hz (= °/√h ÷ 60) */
+    double bias_instability_dps;    /* Gauss-Markov零偏标准差 °/s */
+    double bias_corr_time_s;        /* Gauss-Markov相关时间 */
+    double rrw_dps_rts;             /* 角速率随机游走 °/s/√s */
+    double initial_bias_dps;        /* 初始零偏 */
+    double temp_coeff_dps_c;        /* 零偏温度系数 °/s/°C */
+    double temp_ref_c;              /* 温度系数参考点 */
+    double scale_error_ppm;         /* 标度因数误差 */
+    double sensitivity_lsb;         /* 灵敏度 LSB/(°/s) */
+    uint64_t seed;
+} GyroNoise_Params;
+
+typedef struct {
+    GyroNoise_Params params;
+    GyroProfile profile;
+    uint64_t rng;
+    double gm_bias;
+    double rrw_bias;
+    double last_t;
+    double last_rate;               /* 同一时刻重复读取时返回相同值 */
+    double last_temp;
+    int has_last;
+    int seg_index;                  /* 剖面当前段 (t单调, 顺序推进) */
+    double seg_start;
+} GyroNoise_Model;
+
+/**
+ * @brief 默认参数 (XV7001BB量级的假设值, 使用前应按实测Allan方差标定)
+ */
+void GyroNoise_DefaultParams(GyroNoise_Params *params);
+
+/**
+ * @brief 初始化模型
+ * @param profile 运动剖面, NULL=静止25°C
+ */
+void GyroNoise_Init(GyroNoise_Model *model, const GyroNoise_Params *params, const GyroProfile *profile);
+
+/**
+ * @brief 时刻t的测量角速度 (°/s, 未量化), t须单调不减
+ */
+double GyroNoise_Rate(GyroNoise_Model *model, double t);
+
+/**
+ * @brief 时刻t的24-bit输出计数 (量化并饱和)
+ */
+int32_t GyroNoise_Raw(GyroNoise_Model *model, double t);
+
+/**
+ * @brief 最近一次读取时刻的真实零偏 (°/s, 不含白噪声与标度误差), 用于评估零偏估计
+ */
+double GyroNoise_Bias(const GyroNoise_Model *model);
+
+/**
+ * @brief 剖面在时刻t的真实角速度与温度
+ */
+void GyroProfile_At(const GyroProfile *profile, double t, double *rate_dps, double *temp_c);
+
+/**
+ * @brief 剖面从0到t的真实转角 (°)
+ */
+double GyroProfile_Angle(const GyroProfile *profile, double t);
+
+/**
+ * @brief 从文本文件加载剖面, 每行: 时长s 起始dps 结束dps 起始°C 结束°C ('#'开头为注释)
+ * @return 段数, -1=文件错误
+ */
+int GyroProfile_Load(const char *path, GyroProfile_Segment *segments, int max_segments);
+
+/**
+ * @brief 生成供XV7001BB设备模型使用的样本源
+ */
+void GyroNoise_MakeSource(GyroNoise_Model *model, Xv7Model_Source *source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GYRO_NOISE_MODEL_H */
@@ -0,0 +1,604 @@
+#include "stm32f1xx_hal.h"
+#include "freertos_host.h"
+#include "xv7001bb_model.h"
+#include "virtual_can.h"
+#include "spi.h"
+#include <string.h>
+
+/*============================================================================
+ * 主机构建用 HAL 实现
+ * GPIO: 记录输出电平, PB12 (XV7001BB片选) 的变化转发给设备模型
+ * SPI : 逐字节与设备模型交换, 每字节按分频消耗虚拟时间, 超时按HAL的节拍计数判断
+ * CAN : bxCAN行为子集, 发送立即完成, 接收3级FIFO, 接入虚拟总线
+ * FLASH: RAM数组模拟, 擦除置0xFF, 编程只能写1→0; 首次使用时整体擦除, HAL_Init不清除
+ *        (仿真程序可在启动固件前写入参数页)
+ * IWDG: 按LSI标称40kHz计算超时, 每节拍检查, 超时计数后重新计时 (不复位)
+ * BKP : 普通数组, HAL_Init不清除 (仿真程序可在启动固件前预置检查点)
+ *============================================================================*/
+
+uint32_t SystemCoreClock = 72000000U;
+
+DWT_Type host_dwt;
+CoreDebug_Type host_coredebug;
+GPIO_TypeDef host_gpioa;
+GPIO_TypeDef host_gpiob;
+SPI_TypeDef host_spi2;
+CAN_TypeDef host_can1;
+uint8_t host_flash[FLASH_SIZE_BYTES];
+IWDG_TypeDef host_iwdg;
+BKP_TypeDef host_bkp;
+uint32_t host_reset_flags = (1U << (RCC_FLAG_PORRST & 0x1FU)) | (1U << (RCC_FLAG_PINRST & 0x1FU));
+
+static volatile uint32_t uwTick;
+static bool s_flash_ready;                      /* host_flash已整体擦除 */
+
+static uint32_t s_iwdg_timeout_ms;              /* 0=未启动 */
+static uint32_t s_iwdg_refresh_tick;
+static uint32_t s_iwdg_expired;
+
+/*============================================================================
+ * HAL 基础
+ *============================================================================*/
+
+/**
+ * @brief 首次使用时整体擦除Flash (出厂状态)
+ */
+static void HostFlash_Prepare(void)
+{
+    if (!s_flash_ready)
+    {
+        memset(host_flash, 0xFF, sizeof(host_flash));
+        s_flash_ready = true;
+    }
+}
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    HostFlash_Prepare();
+    Xv7Model_Reset();
+    return HAL_OK;
+}
+
+void HAL_IncTick(void)
+{
+    uwTick++;
+    if (s_iwdg_timeout_ms != 0 && uwTick - s_iwdg_refresh_tick > s_iwdg_timeout_ms)
+    {
+        s_iwdg_expired++;
+        s_iwdg_refresh_tick = uwTick;
+    }
+}
+
+uint32_t HAL_GetTick(void)
+{
+    HostSim_Poll();
+    return uwTick;
+}
+
+/**
+ * @brief 延时 (与HAL一致, 至少延时Delay+1个节拍)
+ * 目标板上为忙等; 主机上调度器运行后改为阻塞, 低优先级任务可在此期间运行
+ */
+void HAL_Delay(uint32_t Delay)
+{
+    HostSim_Wait(Delay + 1U);
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)IRQn;
+    (void)PreemptPriority;
+    (void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    (void)IRQn;
+}
+
+/*============================================================================
+ * RCC
+ *============================================================================*/
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct)
+{
+    (void)RCC_OscInitStruct;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency)
+{
+    (void)RCC_ClkInitStruct;
+    (void)FLatency;
+    return HAL_OK;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return SystemCoreClock / 2U;
+}
+
+/*============================================================================
+ * GPIO
+ *============================================================================*/
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+/* 传感器片选 (与gyro_fusion.c的设备序号一致) */
+static const struct {
+    GPIO_TypeDef *port;
+    uint16_t pin;
+} s_cs[XV7_MODEL_MAX_DEVICES] = {
+    { SPI2_NSS_PORT, SPI2_NSS_PIN },
+    { SPI2_CS2_PORT, SPI2_CS2_PIN },
+    { SPI2_CS3_PORT, SPI2_CS3_PIN },
+    { SPI2_CS4_PORT, SPI2_CS4_PIN },
+};
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET)
+    {
+        GPIOx->ODR |= GPIO_Pin;
+    }
+    else
+    {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+    
+    /* 片选i → 模型设备i */
+    for (int i = 0; i < XV7_MODEL_MAX_DEVICES; i++)
+    {
+        if (GPIOx == s_cs[i].port && (GPIO_Pin & s_cs[i].pin))
+        {
+            Xv7Model_Select(i, PinState == GPIO_PIN_RESET);
+        }
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR ^= GPIO_Pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->ODR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/*============================================================================
+ * SPI
+ *============================================================================*/
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi)
+{
+    (void)hspi;
+    return HAL_OK;
+}
+
+/**
+ * @brief 一个字节的传输周期数: 8位 × 分频 (BaudRatePrescaler字段为log2(分频)-1) × HCLK/PCLK1(=2)
+ */
+static uint32_t HAL_SPI_ByteCycles(const SPI_HandleTypeDef *hspi)
+{
+    uint32_t div = 2U << (hspi->Init.BaudRatePrescaler >> 3);
+    return 8U * div * 2U;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                          uint16_t Size, uint32_t Timeout)
+{
+    uint32_t tickstart = HAL_GetTick();
+    
+    for (uint16_t i = 0; i < Size; i++)
+    {
+        HostSim_Busy(HAL_SPI_ByteCycles(hspi));
+        pRxData[i] = Xv7Model_Transfer(pTxData[i]);
+        
+        /* 与HAL相同: 等待期间节拍差达到Timeout即超时 (字节已移出, 接收值丢弃) */
+        if (Timeout != HAL_MAX_DELAY && (uwTick - tickstart) >= Timeout)
+        {
+            return HAL_TIMEOUT;
+        }
+    }
+    return Xv7Model_BusFault() ? HAL_TIMEOUT : HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hspi;
+    (void)Timeout;
+    
+    for (uint16_t i = 0; i < Size; i++)
+    {
+        Xv7Model_Transfer(pData[i]);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hspi;
+    (void)Timeout;
+    
+    for (uint16_t i = 0; i < Size; i++)
+    {
+        pData[i] = Xv7Model_Transfer(0xFF);
+    }
+    return HAL_OK;
+}
+
+/*============================================================================
+ * IWDG
+ *============================================================================*/
+
+HAL_StatusTypeDef HAL_IWDG_Init(IWDG_HandleTypeDef *hiwdg)
+{
+    uint32_t divider = 4U << hiwdg->Init.Prescaler;
+    
+    s_iwdg_timeout_ms = (hiwdg->Init.Reload + 1U) * divider / 40U;
+    s_iwdg_refresh_tick = uwTick;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_IWDG_Refresh(IWDG_HandleTypeDef *hiwdg)
+{
+    (void)hiwdg;
+    s_iwdg_refresh_tick = uwTick;
+    return HAL_OK;
+}
+
+uint32_t HostIwdg_Expired(void)
+{
+    return s_iwdg_expired;
+}
+
+/*============================================================================
+ * PWR
+ *============================================================================*/
+
+void HAL_PWR_EnableBkUpAccess(void)
+{
+}
+
+/*============================================================================
+ * FLASH
+ *============================================================================*/
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    HostFlash_Prepare();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uintptr_t Address, uint64_t Data)
+{
+    uint32_t bytes = (TypeProgram == FLASH_TYPEPROGRAM_HALFWORD) ? 2U : 4U;
+    
+    if (Address < FLASH_BASE || Address + bytes > FLASH_BASE + FLASH_SIZE_BYTES || (Address & 1U))
+    {
+        return HAL_ERROR;
+    }
+    
+    uint8_t *dst = (uint8_t *)Address;
+    for (uint32_t i = 0; i < bytes; i++)
+    {
+        dst[i] &= (uint8_t)(Data >> (8U * i));
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+    uintptr_t start = pEraseInit->PageAddress & ~(uintptr_t)(FLASH_PAGE_SIZE - 1U);
+    uintptr_t end = start + (uintptr_t)pEraseInit->NbPages * FLASH_PAGE_SIZE;
+    
+    *PageError = 0xFFFFFFFFU;
+    if (start < FLASH_BASE || end > FLASH_BASE + FLASH_SIZE_BYTES)
+    {
+        *PageError = (uint32_t)(start - FLASH_BASE);
+        return HAL_ERROR;
+    }
+    memset((void *)start, 0xFF, end - start);
+    return HAL_OK;
+}
+
+/*============================================================================
+ * CAN
+ *============================================================================*/
+#define HOST_CAN_FIFO_DEPTH     3
+
+typedef struct {
+    CAN_RxHeaderTypeDef header;
+    uint8_t data[8];
+} HostCan_RxEntry;
+
+static uint32_t s_can_active_its;
+static int s_can_node = -1;
+static HostCan_RxEntry s_rx_fifo[HOST_CAN_FIFO_DEPTH];
+static uint32_t s_rx_head;
+static uint32_t s_rx_count;
+static uint32_t s_last_tx_timestamp;
+
+/**
+ * @brief 控制器当前位速率 (由位时序推算)
+ */
+static uint32_t HostCan_Bitrate(const CAN_HandleTypeDef *hcan)
+{
+    uint32_t bs1 = ((hcan->Init.TimeSeg1 >> CAN_BTR_TS1_Pos) & 0x0FU) + 1U;
+    uint32_t bs2 = ((hcan->Init.TimeSeg2 >> CAN_BTR_TS2_Pos) & 0x07U) + 1U;
+    uint32_t tq = 1U + bs1 + bs2;
+    
+    return HAL_RCC_GetPCLK1Freq() / (hcan->Init.Prescaler * tq);
+}
+
+/**
+ * @brief 16-bit位时间计数器 (TTCM时间戳)
+ */
+static uint32_t HostCan_BusTime(const CAN_HandleTypeDef *hcan)
+{
+    return (uint32_t)(HostSim_Cycles() / (SystemCoreClock / HostCan_Bitrate(hcan))) & 0xFFFFU;
+}
+
+/**
+ * @brief 帧写入接收FIFO0
+ */
+static void HostCan_PushRx(CAN_HandleTypeDef *hcan, const VCan_Frame *frame)
+{
+    if (s_rx_count >= HOST_CAN_FIFO_DEPTH)
+    {
+        hcan->ErrorCode |= HAL_CAN_ERROR_RX_FOV0;
+        return;
+    }
+    
+    HostCan_RxEntry *e = &s_rx_fifo[(s_rx_head + s_rx_count) % HOST_CAN_FIFO_DEPTH];
+    memset(&e->header, 0, sizeof(e->header));
+    e->header.StdId = frame->id;
+    e->header.IDE = CAN_ID_STD;
+    e->header.RTR = CAN_RTR_DATA;
+    e->header.DLC = frame->dlc;
+    e->header.Timestamp = HostCan_BusTime(hcan);
+    memcpy(e->data, frame->data, 8);
+    s_rx_count++;
+    
+    /* 接收成功: LEC清零 */
+    hcan->Instance->ESR &= ~CAN_ESR_LEC;
+    
+    if (s_can_active_its & CAN_IT_RX_FIFO0_MSG_PENDING)
+    {
+        HAL_CAN_RxFifo0MsgPendingCallback(hcan);
+    }
+}
+
+/**
+ * @brief 虚拟总线接收回调
+ */
+static void HostCan_OnBusFrame(void *ctx, const VCan_Frame *frame, bool ok)
+{
+    CAN_HandleTypeDef *hcan = (CAN_HandleTypeDef *)ctx;
+    
+    /* 环回模式下RX与总线断开 */
+    if (hcan->State != HAL_CAN_STATE_LISTENING ||
+        hcan->Init.Mode == CAN_MODE_LOOPBACK || hcan->Init.Mode == CAN_MODE_SILENT_LOOPBACK)
+    {
+        return;
+    }
+    
+    if (!ok || HostCan_Bitrate(hcan) != VCan_GetBitrate())
+    {
+        /* 位速率不匹配: 填充错误, REC递增 */
+        uint32_t rec = (hcan->Instance->ESR & CAN_ESR_REC) >> CAN_ESR_REC_Pos;
+        if (rec < 255U)
+        {
+            rec++;
+        }
+        hcan->Instance->ESR = (hcan->Instance->ESR & ~(CAN_ESR_REC | CAN_ESR_LEC)) |
+                              (rec << CAN_ESR_REC_Pos) | (1U << CAN_ESR_LEC_Pos);
+        return;
+    }
+    
+    HostCan_PushRx(hcan, frame);
+}
+
+HAL_StatusTypeDef HAL_CAN_Init(CAN_HandleTypeDef *hcan)
+{
+    if (hcan->Init.Prescaler == 0)
+    {
+        return HAL_ERROR;
+    }
+    
+    if (s_can_node < 0)
+    {
+        s_can_node = VCan_Attach(HostCan_OnBusFrame, hcan);
+    }
+    
+    hcan->Instance->BTR = hcan->Init.Mode | hcan->Init.SyncJumpWidth | hcan->Init.TimeSeg1 |
+                          hcan->Init.TimeSeg2 | (hcan->Init.Prescaler - 1U);
+    hcan->ErrorCode = HAL_CAN_ERROR_NONE;
+    hcan->State = HAL_CAN_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_DeInit(CAN_HandleTypeDef *hcan)
+{
+    hcan->State = HAL_CAN_STATE_RESET;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef *hcan, CAN_FilterTypeDef *sFilterConfig)
+{
+    (void)hcan;
+    (void)sFilterConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef *hcan)
+{
+    if (hcan->State != HAL_CAN_STATE_READY)
+    {
+        return HAL_ERROR;
+    }
+    hcan->State = HAL_CAN_STATE_LISTENING;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_Stop(CAN_HandleTypeDef *hcan)
+{
+    if (hcan->State != HAL_CAN_STATE_LISTENING)
+    {
+        return HAL_ERROR;
+    }
+    hcan->State = HAL_CAN_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef *hcan, uint32_t ActiveITs)
+{
+    (void)hcan;
+    s_can_active_its |= ActiveITs;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_DeactivateNotification(CAN_HandleTypeDef *hcan, uint32_t InactiveITs)
+{
+    (void)hcan;
+    s_can_active_its &= ~InactiveITs;
+    return HAL_OK;
+}
+
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(CAN_HandleTypeDef *hcan)
+{
+    (void)hcan;
+    return 3;
+}
+
+/**
+ * @brief 发送 (立即完成)
+ * 环回模式回送到本机FIFO; 静默模式不上总线; TTCM且DLC=8时硬件写入[6-7]时间戳
+ */
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef *hcan, CAN_TxHeaderTypeDef *pHeader,
+                                       uint8_t aData[], uint32_t *pTxMailbox)
+{
+    VCan_Frame frame;
+    
+    if (hcan->State != HAL_CAN_STATE_LISTENING)
+    {
+        return HAL_ERROR;
+    }
+    
+    memset(&frame, 0, sizeof(frame));
+    frame.id = pHeader->StdId;
+    frame.dlc = (uint8_t)pHeader->DLC;
+    frame.cycles = HostSim_Cycles();
+    memcpy(frame.data, aData, pHeader->DLC);
+    
+    s_last_tx_timestamp = HostCan_BusTime(hcan);
+    if (hcan->Init.TimeTriggeredMode == ENABLE && pHeader->TransmitGlobalTime == ENABLE && frame.dlc == 8)
+    {
+        frame.data[6] = (uint8_t)(s_last_tx_timestamp & 0xFF);
+        frame.data[7] = (uint8_t)(s_last_tx_timestamp >> 8);
+    }
+    
+    if (hcan->Init.Mode == CAN_MODE_LOOPBACK || hcan->Init.Mode == CAN_MODE_SILENT_LOOPBACK)
+    {
+        HostCan_PushRx(hcan, &frame);
+    }
+    if (hcan->Init.Mode == CAN_MODE_NORMAL || hcan->Init.Mode == CAN_MODE_LOOPBACK)
+    {
+        VCan_Transmit(s_can_node, &frame, HostCan_Bitrate(hcan));
+    }
+    hcan->Instance->ESR &= ~CAN_ESR_LEC;        /* 发送成功: LEC清零 */
+    
+    *pTxMailbox = CAN_TX_MAILBOX0;
+    if (s_can_active_its & CAN_IT_TX_MAILBOX_EMPTY)
+    {
+        HAL_CAN_TxMailbox0CompleteCallback(hcan);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_AbortTxRequest(CAN_HandleTypeDef *hcan, uint32_t TxMailboxes)
+{
+    (void)hcan;
+    (void)TxMailboxes;
+    return HAL_OK;
+}
+
+uint32_t HAL_CAN_IsTxMessagePending(CAN_HandleTypeDef *hcan, uint32_t TxMailboxes)
+{
+    (void)hcan;
+    (void)TxMailboxes;
+    return 0;
+}
+
+uint32_t HAL_CAN_GetTxTimestamp(CAN_HandleTypeDef *hcan, uint32_t TxMailbox)
+{
+    (void)hcan;
+    (void)TxMailbox;
+    return s_last_tx_timestamp;
+}
+
+uint32_t HAL_CAN_GetRxFifoFillLevel(CAN_HandleTypeDef *hcan, uint32_t RxFifo)
+{
+    (void)hcan;
+    return (RxFifo == CAN_RX_FIFO0) ? s_rx_count : 0;
+}
+
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef *hcan, uint32_t RxFifo,
+                                       CAN_RxHeaderTypeDef *pHeader, uint8_t aData[])
+{
+    (void)hcan;
+    
+    if (RxFifo != CAN_RX_FIFO0 || s_rx_count == 0)
+    {
+        return HAL_ERROR;
+    }
+    
+    *pHeader = s_rx_fifo[s_rx_head].header;
+    memcpy(aData, s_rx_fifo[s_rx_head].data, 8);
+    s_rx_head = (s_rx_head + 1U) % HOST_CAN_FIFO_DEPTH;
+    s_rx_count--;
+    return HAL_OK;
+}
+
+HAL_CAN_StateTypeDef HAL_CAN_GetState(CAN_HandleTypeDef *hcan)
+{
+    return hcan->State;
+}
+
+uint32_t HAL_CAN_GetError(CAN_HandleTypeDef *hcan)
+{
+    return hcan->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_CAN_ResetError(CAN_HandleTypeDef *hcan)
+{
+    hcan->ErrorCode = HAL_CAN_ERROR_NONE;
+    return HAL_OK;
+}
+
+void HAL_CAN_IRQHandler(CAN_HandleTypeDef *hcan)
+{
+    (void)hcan;
+}
+
+/* 默认回调 (固件可覆盖) */
+__attribute__((weak)) void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan) { (void)hcan; }
+__attribute__((weak)) void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan) { (void)hcan; }
+__attribute__((weak)) void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan) { (void)hcan; }
+__attribute__((weak)) void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan) { (void)hcan; }
+__attribute__((weak)) void HAL_CAN_ErrorCallback(CAN_HandleTypeDef *hcan) { (void)hcan; }
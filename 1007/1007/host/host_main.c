@@ -0,0 +1,675 @@
+#include "firmware_entry.h"
+#include "freertos_host.h"
+#include "virtual_can.h"
+#include "xv7001bb_model.h"
+#include "gyro_noise_model.h"
+#include "can.h"
+#include "xvlog.h"
+#include "latency_hist.h"
+#include "angle_retain.h"
+#include "rate_filter.h"
+#include "acq_sched.h"
+#include "gyro_fusion.h"
+#include "config_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*============================================================================
+ * xv7_sim: 在主机上运行完整固件
+ * 
+ * 用法: xv7_sim [-s 秒] [-r 角速度dps] [-n] [-p 剖面文件] [-seed N] [-arw °/√h] [-v] [-o 记录.xvl] [-t 跟踪.xtr]
+ *               [-m 传感器数] [-k 序号:毫秒[:故障[:次数]]]... [-c 毫秒:十六进制数据]...
+ *   -s  仿真时长 (虚拟时间, 默认10秒)
+ *   -r  设备模型输入的恒定角速度
+ *   -n  启用陀螺仪误差模型 (默认参数, 见gyro_noise_model.h)
+ *   -p  运动/温度剖面文件 (隐含-n)
+ *   -seed 误差模型随机种子 (传感器i使用种子+i)
+ *   -arw 误差模型的角度随机游走 (°/√h, 隐含-n), 如 -arw 0.001 模拟低带宽DSP的低噪声输出
+ *   -m  SPI总线上装配的传感器数 (1~4, 默认1), 多个时固件融合输出;
+ *       状态应答 (0x332) 结束时按传感器打印
+ *   -k  在指定时刻向一个传感器注入故障, 如 -k 1:5000 (断开), -k 0:5000:jump:1 (一次尖峰);
+ *       故障: ones(默认, 断开) zeros stuck jump spi, 次数省略或0=持续 (见xv7001bb_model.h);
+ *       故障计数 (0x64) 的应答 (0x333) 结束时按传感器打印
+ *   -v  打印固件发出的每一帧
+ *   -o  启动时发送0x22开启采集流, 将收到的采集帧保存为记录文件 (xvlog.h)
+ *   -t  将收到的事件跟踪导出帧 (0x329) 原样保存, 由trace_decode -raw解码;
+ *       导出需用 -c 命令触发, 如 -c 5000:41
+ *       分段延迟直方图 (0x32B) 同样按需导出, 如 -c 5000:43, 结束时打印各分段摘要
+ *   -c  在指定时刻由主机节点发送命令帧, 如 -c 3000:01 表示3秒时角度清零
+ *       输出滤波配置 (0x60) 的应答 (0x32F) 结束时按节打印
+ *       采集调度 (0x62) 的应答 (0x331) 结束时按通道打印
+ *============================================================================*/
+#define SIM_MAX_COMMANDS    16
+#define SIM_HOST_CMD_ID     0x100
+#define SIM_MAX_SEGMENTS    64
+#define SIM_CAPTURE_RETRY_TICKS 10
+#define SIM_SYSMON_PAGES    8
+
+typedef struct {
+    TickType_t tick;
+    VCan_Frame frame;
+} Sim_Command;
+
+static Sim_Command s_commands[SIM_MAX_COMMANDS];
+static int s_command_count;
+static int s_node;
+static bool s_verbose;
+static float s_rate_dps;
+static uint32_t s_frames_by_id[0x800];
+static float s_last_value[3];               /* 0x321~0x323最新值 */
+static struct timespec s_real_start;
+static bool s_noise;
+static GyroNoise_Model s_noise_model;
+static GyroProfile_Segment s_segments[SIM_MAX_SEGMENTS];
+static GyroProfile s_profile;
+static FILE *s_capture;
+static uint32_t s_capture_records;
+static uint8_t s_sysmon[SIM_SYSMON_PAGES][8];  /* 0x328各页最新内容 */
+static bool s_sysmon_seen[SIM_SYSMON_PAGES];
+static uint8_t s_deadline[8];                  /* 0x32A最新内容 */
+static bool s_deadline_seen;
+static uint8_t s_power[8];                     /* 0x32C最新内容 */
+static uint8_t s_health[8];                    /* 0x324最新内容 */
+static uint8_t s_health2[8];                   /* 0x334最新内容 */
+static bool s_health_seen;
+static bool s_power_seen;
+static uint8_t s_boot[8];                      /* 0x32D最新内容 */
+static bool s_boot_seen;
+static uint32_t s_boot_frames;
+static uint8_t s_retain[8];                    /* 0x32E最新内容 */
+static bool s_retain_seen;
+static FILE *s_trace;
+static uint32_t s_trace_frames;
+static uint8_t s_latency[LATENCY_STAGE_COUNT][2][8];   /* 0x32B各分段页0/页1最新内容 */
+static bool s_latency_seen[LATENCY_STAGE_COUNT];
+static uint8_t s_filter[RATE_FILTER_SECTIONS][8];      /* 0x32F各节最新应答 */
+static bool s_filter_seen[RATE_FILTER_SECTIONS];
+static uint8_t s_acq[ACQ_CH_COUNT][8];                 /* 0x331各通道最新应答 */
+static bool s_acq_seen[ACQ_CH_COUNT];
+static uint8_t s_fusion[GYRO_FUSION_MAX_SENSORS][8];    /* 0x332各传感器最新应答 */
+static bool s_fusion_seen[GYRO_FUSION_MAX_SENSORS];
+static GyroNoise_Model s_sensor_models[GYRO_FUSION_MAX_SENSORS - 1];   /* 传感器1~3的误差模型 */
+static uint8_t s_faults[GYRO_FUSION_MAX_SENSORS][GYRO_SENSORS_FAULT_PAGES][8];   /* 0x333各传感器各页最新应答 */
+static bool s_faults_seen[GYRO_FUSION_MAX_SENSORS];
+
+typedef struct {
+    TickType_t tick;
+    int sensor;
+    uint8_t fault;
+    uint32_t count;
+} Sim_Fault;
+
+static Sim_Fault s_inject[SIM_MAX_COMMANDS];
+static int s_inject_count;
+
+/* 固件全局角度, 与回放结果逐位比较 */
+extern volatile float g_angle_deg;
+
+/**
+ * @brief 恒定角速度样本源
+ */
+static double Sim_Rate(void *ctx, double t)
+{
+    (void)t;
+    return *(const float *)ctx;
+}
+
+static float Sim_Temp(void *ctx, double t)
+{
+    (void)ctx;
+    (void)t;
+    return 25.0f;
+}
+
+/**
+ * @brief 主机节点接收固件发出的帧
+ */
+static void Sim_OnFrame(void *ctx, const VCan_Frame *frame, bool ok)
+{
+    (void)ctx;
+    
+    if (!ok)
+    {
+        return;
+    }
+    
+    s_frames_by_id[frame->id & 0x7FF]++;
+    if (frame->id >= CAN_ID_ANGLE && frame->id <= CAN_ID_GYRO_RATE)
+    {
+        memcpy(&s_last_value[frame->id - CAN_ID_ANGLE], frame->data, sizeof(float));
+    }
+    if (frame->id == CAN_ID_SYS_MONITOR && frame->dlc == 8 && frame->data[0] < SIM_SYSMON_PAGES)
+    {
+        memcpy(s_sysmon[frame->data[0]], frame->data, 8);
+        s_sysmon_seen[frame->data[0]] = true;
+    }
+    if (frame->id == CAN_ID_CAPTURE && s_capture != NULL && frame->dlc == XVLOG_RECORD_SIZE)
+    {
+        fwrite(frame->data, XVLOG_RECORD_SIZE, 1, s_capture);
+        s_capture_records++;
+    }
+    if (frame->id == CAN_ID_DEADLINE && frame->dlc == 8)
+    {
+        memcpy(s_deadline, frame->data, 8);
+        s_deadline_seen = true;
+    }
+    if (frame->id == CAN_ID_CAN_HEALTH && frame->dlc == 8)
+    {
+        memcpy(s_health, frame->data, 8);
+    }
+    if (frame->id == CAN_ID_CAN_HEALTH2 && frame->dlc == 8)
+    {
+        memcpy(s_health2, frame->data, 8);
+        s_health_seen = true;
+    }
+    if (frame->id == CAN_ID_POWER && frame->dlc == 8)
+    {
+        memcpy(s_power, frame->data, 8);
+        s_power_seen = true;
+    }
+    if (frame->id == CAN_ID_BOOT && frame->dlc == 8)
+    {
+        memcpy(s_boot, frame->data, 8);
+        s_boot_seen = true;
+        s_boot_frames++;
+    }
+    if (frame->id == CAN_ID_RETAIN && frame->dlc == 8)
+    {
+        memcpy(s_retain, frame->data, 8);
+        s_retain_seen = true;
+    }
+    if (frame->id == CAN_ID_LATENCY && frame->dlc == 8 && (frame->data[0] >> 4) < LATENCY_STAGE_COUNT
+        && (frame->data[0] & 0x0F) < 2)
+    {
+        memcpy(s_latency[frame->data[0] >> 4][frame->data[0] & 0x0F], frame->data, 8);
+        s_latency_seen[frame->data[0] >> 4] = true;
+    }
+    if (frame->id == CAN_ID_FILTER && frame->dlc == 8 && frame->data[0] < RATE_FILTER_SECTIONS)
+    {
+        memcpy(s_filter[frame->data[0]], frame->data, 8);
+        s_filter_seen[frame->data[0]] = true;
+    }
+    if (frame->id == CAN_ID_ACQ_SCHED && frame->dlc == 8 && frame->data[0] < ACQ_CH_COUNT)
+    {
+        memcpy(s_acq[frame->data[0]], frame->data, 8);
+        s_acq_seen[frame->data[0]] = true;
+    }
+    if (frame->id == CAN_ID_FUSION && frame->dlc == 8 && frame->data[0] < GYRO_FUSION_MAX_SENSORS)
+    {
+        memcpy(s_fusion[frame->data[0]], frame->data, 8);
+        s_fusion_seen[frame->data[0]] = true;
+    }
+    if (frame->id == CAN_ID_SENSOR_FAULT && frame->dlc == 8 && (frame->data[0] >> 4) < GYRO_FUSION_MAX_SENSORS
+        && (frame->data[0] & 0x0F) < GYRO_SENSORS_FAULT_PAGES)
+    {
+        memcpy(s_faults[frame->data[0] >> 4][frame->data[0] & 0x0F], frame->data, 8);
+        s_faults_seen[frame->data[0] >> 4] = true;
+    }
+    if (frame->id == CAN_ID_TRACE && s_trace != NULL && frame->dlc == 8)
+    {
+        fwrite(frame->data, 8, 1, s_trace);
+        s_trace_frames++;
+    }
+    
+    if (s_verbose)
+    {
+        printf("%10.4f %03X [%u]", (double)frame->cycles / SystemCoreClock, (unsigned)frame->id, frame->dlc);
+        for (int i = 0; i < frame->dlc; i++)
+        {
+            printf(" %02X", frame->data[i]);
+        }
+        printf("\n");
+    }
+}
+
+/**
+ * @brief 每节拍回调: 按时刻注入命令
+ */
+static void Sim_OnTick(TickType_t tick)
+{
+    /* 自动波特率检测期间的帧会被丢弃, 收到第一条采集记录前周期性重发0x22,
+       调度器启动后10ms内即可开启, 早于主任务开始启动校准 */
+    if (s_capture != NULL && s_capture_records == 0 && tick % SIM_CAPTURE_RETRY_TICKS == 0)
+    {
+        VCan_Frame start = { SIM_HOST_CMD_ID, 3, { 0x22, 0x00, 0x00 }, HostSim_Cycles() };
+        VCan_Transmit(s_node, &start, VCan_GetBitrate());
+    }
+    
+    for (int i = 0; i < s_inject_count; i++)
+    {
+        if (s_inject[i].tick == tick)
+        {
+            Xv7Model_Inject(s_inject[i].sensor, s_inject[i].fault, s_inject[i].count);
+        }
+    }
+    
+    for (int i = 0; i < s_command_count; i++)
+    {
+        if (s_commands[i].tick == tick)
+        {
+            s_commands[i].frame.cycles = HostSim_Cycles();
+            VCan_Transmit(s_node, &s_commands[i].frame, VCan_GetBitrate());
+        }
+    }
+}
+
+/**
+ * @brief 仿真结束: 打印统计
+ */
+static void Sim_OnEnd(void)
+{
+    struct timespec now;
+    VCan_Stats bus;
+    Xv7Model_Stats model;
+    
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double real_s = (double)(now.tv_sec - s_real_start.tv_sec) + (now.tv_nsec - s_real_start.tv_nsec) * 1e-9;
+    double sim_s = HostSim_Seconds();
+    VCan_GetStats(&bus);
+    Xv7Model_GetStats(&model);
+    
+    printf("sim_time_s     %.3f\n", sim_s);
+    printf("real_time_s    %.3f (x%.1f)\n", real_s, real_s > 0 ? sim_s / real_s : 0.0);
+    printf("bus_frames     %llu\n", (unsigned long long)bus.frames);
+    printf("bus_load       %.2f%%\n", sim_s > 0 ? 100.0 * (double)bus.bits / ((double)VCan_GetBitrate() * sim_s) : 0.0);
+    for (int id = 0; id < 0x800; id++)
+    {
+        if (s_frames_by_id[id] > 0)
+        {
+            printf("id_%03X         %u\n", id, s_frames_by_id[id]);
+        }
+    }
+    printf("angle_deg      %.4f\n", (double)s_last_value[0]);
+    if (s_noise)
+    {
+        printf("true_angle_deg %.4f\n", GyroProfile_Angle(&s_profile, sim_s));
+    }
+    printf("temp_c         %.2f\n", (double)s_last_value[1]);
+    printf("rate_dps       %.4f\n", (double)s_last_value[2]);
+    printf("spi_rate_reads %u\n", model.rate_reads);
+    printf("spi_temp_reads %u\n", model.temp_reads);
+    printf("spi_stat_reads %u\n", model.status_reads);
+    printf("spi_errors     %u\n", model.protocol_errors);
+    printf("iwdg_expired   %u\n", HostIwdg_Expired());
+    
+    if (s_deadline_seen)
+    {
+        printf("deadline       overruns %u missed %u worst %uus (flags 0x%02X)\n",
+               s_deadline[1] | s_deadline[2] << 8, s_deadline[3] | s_deadline[4] << 8,
+               s_deadline[5] | s_deadline[6] << 8, s_deadline[0]);
+    }
+    
+    if (s_boot_seen)
+    {
+        printf("boot           phase %u can %ums sensor %ums first_frame %ums (flags 0x%02X, %u frames)\n",
+               s_boot[0], s_boot[2] | s_boot[3] << 8, s_boot[4] | s_boot[5] << 8, s_boot[6] | s_boot[7] << 8,
+               s_boot[1], s_boot_frames);
+    }
+    
+    if (s_retain_seen)
+    {
+        float retained;
+        memcpy(&retained, &s_retain[4], sizeof(float));
+        printf("retain         result %u angle %.4f gap %.1fms (reset 0x%02X)\n", s_retain[0], (double)retained,
+               (s_retain[2] | s_retain[3] << 8) / 10.0, s_retain[1]);
+    }
+    
+    if (s_health_seen)
+    {
+        printf("can_health     tec %u rec %u bus_off %u passive %u tx_errors %u restarts %u recovery %ums (flags 0x%02X)\n",
+               s_health[0], s_health[1], s_health2[6] | s_health2[7] << 8, s_health[5],
+               s_health2[0] | s_health2[1] << 8, s_health2[2] | s_health2[3] << 8,
+               s_health2[4] | s_health2[5] << 8, s_health[2]);
+    }
+    
+    if (s_power_seen)
+    {
+        printf("power          state %u wake %.1fms (worst %.1fms, flags 0x%02X)\n", s_power[0],
+               (s_power[2] | s_power[3] << 8) / 10.0, (s_power[4] | s_power[5] << 8) / 10.0, s_power[1]);
+    }
+    
+    for (int section = 0; section < RATE_FILTER_SECTIONS; section++)
+    {
+        const uint8_t *f = s_filter[section];
+        if (s_filter_seen[section])
+        {
+            printf("filter_%d       type %u freq %.2fHz q %.3f (result %u, %u enabled)\n", section, f[1],
+                   (f[2] | f[3] << 8) / 100.0, (f[4] | f[5] << 8) / 1000.0, f[6], f[7]);
+        }
+    }
+    
+    for (int channel = 0; channel < ACQ_CH_COUNT; channel++)
+    {
+        const uint8_t *a = s_acq[channel];
+        if (s_acq_seen[channel])
+        {
+            printf("acq_%d          period %u phase %u reads %u (result %u)\n", channel, a[1], a[2],
+                   a[4] | a[5] << 8 | a[6] << 16 | (uint32_t)a[7] << 24, a[3]);
+        }
+    }
+    
+    for (int sensor = 0; sensor < GYRO_FUSION_MAX_SENSORS; sensor++)
+    {
+        const uint8_t *g = s_fusion[sensor];
+        if (s_fusion_seen[sensor])
+        {
+            printf("sensor_%d       state %u weight %u%% offset %.3fdps sigma %.4fdps (status 0x%02X)\n", sensor,
+                   g[1], g[2], (int16_t)(g[4] | g[5] << 8) / 1000.0, (g[6] | g[7] << 8) / 10000.0, g[3]);
+        }
+    }
+    
+    for (int sensor = 0; sensor < GYRO_FUSION_MAX_SENSORS; sensor++)
+    {
+        const uint8_t *f0 = s_faults[sensor][0];
+        const uint8_t *f1 = s_faults[sensor][1];
+        const uint8_t *f2 = s_faults[sensor][2];
+        if (s_faults_seen[sensor])
+        {
+            printf("fault_%d        spi %u ones %u zeros %u stuck %u jump %u retries %u rejected %u"
+                   " flagged %u latency %.1fms (worst %.1fms, last class %u)\n", sensor,
+                   f0[2] | f0[3] << 8, f0[4] | f0[5] << 8, f0[6] | f0[7] << 8, f1[2] | f1[3] << 8,
+                   f1[4] | f1[5] << 8, f1[6] | f1[7] << 8, f2[2] | f2[3] << 8, f2[1],
+                   (f2[4] | f2[5] << 8) / 10.0, (f2[6] | f2[7] << 8) / 10.0, f0[1]);
+        }
+    }
+    
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+    {
+        const uint8_t *p0 = s_latency[stage][0];
+        const uint8_t *p1 = s_latency[stage][1];
+        if (s_latency_seen[stage])
+        {
+            printf("latency_%d      n %u min %uus mean %uus p99 %uus max %uus\n", stage,
+                   p0[3] | p0[4] << 8 | p0[5] << 16, p1[1] | p1[2] << 8, p1[3] | p1[4] << 8,
+                   p1[5] | p1[6] << 8, p0[6] | p0[7] << 8);
+        }
+    }
+    
+    if (s_sysmon_seen[0])
+    {
+        const uint8_t *d = s_sysmon[0];
+        printf("cpu_load       %.2f%% (flags 0x%02X)\n", (d[2] | d[3] << 8) / 100.0, d[1]);
+        printf("heap_free      %u (min %u)\n", d[4] | d[5] << 8, d[6] | d[7] << 8);
+    }
+    for (int page = 1; page < SIM_SYSMON_PAGES; page++)
+    {
+        const uint8_t *d = s_sysmon[page];
+        if (s_sysmon_seen[page])
+        {
+            printf("task_%d         load %.2f%% stack %u/%u\n", page, (d[1] | d[2] << 8) / 100.0,
+                   d[3] | d[4] << 8, d[5] | d[6] << 8);
+        }
+    }
+    
+    float fw_angle = g_angle_deg;
+    uint32_t fw_bits;
+    memcpy(&fw_bits, &fw_angle, sizeof(float));
+    printf("fw_angle_deg   %.6f (0x%08X)\n", (double)fw_angle, fw_bits);
+    if (s_capture != NULL)
+    {
+        fclose(s_capture);
+        printf("capture_records %u\n", s_capture_records);
+    }
+    if (s_trace != NULL)
+    {
+        fclose(s_trace);
+        printf("trace_frames   %u\n", s_trace_frames);
+    }
+}
+
+/**
+ * @brief 创建记录文件 (开启采集流的命令由Sim_OnTick发送)
+ */
+static int Sim_OpenCapture(const char *path)
+{
+    XvLog_FileHeader header;
+    
+    if ((s_capture = fopen(path, "wb")) == NULL)
+    {
+        return -1;
+    }
+    
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, XVLOG_MAGIC, sizeof(header.magic));
+    header.version = XVLOG_VERSION;
+    header.record_size = XVLOG_RECORD_SIZE;
+    header.period_ms = 10;
+    fwrite(&header, sizeof(header), 1, s_capture);
+    
+    return 0;
+}
+
+/**
+ * @brief 解析 -k 序号:毫秒[:故障[:次数]]
+ */
+static int Sim_ParseFault(const char *arg)
+{
+    static const char *const names[] = { "none", "ones", "zeros", "stuck", "jump", "spi" };
+    Sim_Fault *f = &s_inject[s_inject_count];
+    char *end;
+    
+    if (s_inject_count >= SIM_MAX_COMMANDS)
+    {
+        return -1;
+    }
+    
+    memset(f, 0, sizeof(*f));
+    f->fault = XV7_MODEL_FAULT_ONES;
+    f->sensor = (int)strtol(arg, &end, 10);
+    if (f->sensor < 0 || f->sensor >= GYRO_FUSION_MAX_SENSORS || *end != ':')
+    {
+        return -1;
+    }
+    f->tick = (TickType_t)strtoul(end + 1, &end, 10);
+    if (*end == ':')
+    {
+        const char *name = end + 1;
+        size_t len = strcspn(name, ":");
+        int i;
+        for (i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++)
+        {
+            if (strlen(names[i]) == len && strncmp(name, names[i], len) == 0)
+            {
+                break;
+            }
+        }
+        if (i == (int)(sizeof(names) / sizeof(names[0])))
+        {
+            return -1;
+        }
+        f->fault = (uint8_t)i;
+        if (name[len] == ':')
+        {
+            f->count = (uint32_t)strtoul(name + len + 1, NULL, 10);
+        }
+    }
+    s_inject_count++;
+    return 0;
+}
+
+/**
+ * @brief 解析 -c 毫秒:十六进制数据
+ */
+static int Sim_ParseCommand(const char *arg)
+{
+    Sim_Command *cmd = &s_commands[s_command_count];
+    char *end;
+    
+    if (s_command_count >= SIM_MAX_COMMANDS)
+    {
+        return -1;
+    }
+    
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->tick = (TickType_t)strtoul(arg, &end, 10);
+    if (*end != ':')
+    {
+        return -1;
+    }
+    end++;
+    while (end[0] != '\0' && end[1] != '\0' && cmd->frame.dlc < 8)
+    {
+        char byte[3] = { end[0], end[1], '\0' };
+        cmd->frame.data[cmd->frame.dlc++] = (uint8_t)strtoul(byte, NULL, 16);
+        end += 2;
+    }
+    cmd->frame.id = SIM_HOST_CMD_ID;
+    s_command_count++;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = 10.0;
+    int sensors = 1;
+    bool blank = false;
+    static Xv7Model_Source source;
+    GyroNoise_Params params;
+    
+    GyroNoise_DefaultParams(&params);
+    
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            s_rate_dps = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-n") == 0)
+        {
+            s_noise = true;
+        }
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+        {
+            s_profile.count = GyroProfile_Load(argv[++i], s_segments, SIM_MAX_SEGMENTS);
+            s_profile.segments = s_segments;
+            if (s_profile.count < 0)
+            {
+                fprintf(stderr, "cannot read profile %s\n", argv[i]);
+                return 2;
+            }
+            s_noise = true;
+        }
+        else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+        {
+            params.seed = strtoull(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-arw") == 0 && i + 1 < argc)
+        {
+            params.arw_dps_rthz = atof(argv[++i]) / 60.0;
+            s_noise = true;
+        }
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            /* 看门狗复位后的热启动: 备份寄存器预置检查点 (角度[:零偏]) */
+            char *end;
+            float angle = strtof(argv[++i], &end);
+            float bias = (*end == ':') ? strtof(end + 1, NULL) : 0.0f;
+            AngleRetain_Checkpoint(angle, bias);
+            host_reset_flags = (1U << (RCC_FLAG_IWDGRST & 0x1FU)) | (1U << (RCC_FLAG_PINRST & 0x1FU));
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            sensors = atoi(argv[++i]);
+            if (sensors < 1 || sensors > GYRO_FUSION_MAX_SENSORS)
+            {
+                fprintf(stderr, "sensor count must be 1..%d\n", GYRO_FUSION_MAX_SENSORS);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+        {
+            if (Sim_ParseFault(argv[++i]) != 0)
+            {
+                fprintf(stderr, "bad -k %s\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "-blank") == 0)
+        {
+            blank = true;
+        }
+        else if (strcmp(argv[i], "-v") == 0)
+        {
+            s_verbose = true;
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc && Sim_ParseCommand(argv[++i]) == 0)
+        {
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+        {
+            if ((s_trace = fopen(argv[++i], "wb")) == NULL)
+            {
+                fprintf(stderr, "cannot write %s\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            if (Sim_OpenCapture(argv[++i]) != 0)
+            {
+                fprintf(stderr, "cannot write %s\n", argv[i]);
+                return 2;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-s seconds] [-r dps] [-n] [-p profile] [-seed N] [-arw deg/rth] [-v] [-o capture.xvl] [-t trace.xtr] [-w deg[:bias]] [-m sensors] [-k sensor:ms[:fault[:count]]]... [-c ms:hexbytes]... [-blank]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    
+    VCan_Reset(CAN_DEFAULT_BITRATE);
+    s_node = VCan_Attach(Sim_OnFrame, NULL);
+    
+    /* 参数页已保存总线速率 (已配置的设备); -blank为首次上电, 启动时先自动波特率检测 */
+    if (!blank)
+    {
+        ConfigStore_Load();
+        ConfigStore_SetCanBitrate(CAN_DEFAULT_BITRATE);
+    }
+    
+    if (s_noise)
+    {
+        /* 未给剖面时以-r的恒定角速度作为单段剖面 */
+        if (s_profile.count == 0)
+        {
+            s_segments[0] = (GyroProfile_Segment){ 1.0, s_rate_dps, s_rate_dps, 25.0, 25.0 };
+            s_profile.segments = s_segments;
+            s_profile.count = 1;
+        }
+        GyroNoise_Init(&s_noise_model, &params, &s_profile);
+        GyroNoise_MakeSource(&s_noise_model, &source);
+    }
+    else
+    {
+        source.rate_dps = Sim_Rate;
+        source.temp_c = Sim_Temp;
+        source.ctx = &s_rate_dps;
+    }
+    Xv7Model_SetSource(&source);
+    
+    /* 其他传感器: 误差模型各自独立 (种子不同, 初始零偏依次相差0.05°/s), 真实运动相同 */
+    Xv7Model_SetFitted((uint8_t)((1U << sensors) - 1U));
+    for (int i = 1; s_noise && i < sensors; i++)
+    {
+        Xv7Model_Source extra;
+        params.seed++;
+        params.initial_bias_dps += 0.05;
+        GyroNoise_Init(&s_sensor_models[i - 1], &params, &s_profile);
+        GyroNoise_MakeSource(&s_sensor_models[i - 1], &extra);
+        Xv7Model_SetDeviceSource(i, &extra);
+    }
+    
+    HostSim_SetTickCallback(Sim_OnTick);
+    HostSim_SetEndTick((TickType_t)(seconds * configTICK_RATE_HZ), Sim_OnEnd);
+    clock_gettime(CLOCK_MONOTONIC, &s_real_start);
+    
+    return Firmware_Main();
+}
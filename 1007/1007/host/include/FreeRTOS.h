@@ -0,0 +1,79 @@
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+/*============================================================================
+ * 主机构建用 FreeRTOS 替身 (POSIX线程 + 虚拟时钟, 见 freertos_host.c)
+ * 沿用固件的 FreeRTOSConfig.h, 使节拍频率等配置与目标板一致
+ *============================================================================*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t StackType_t;
+
+/* 与内核相同, 配置文件在extern "C"内包含 (其中声明的时基函数为C链接) */
+#include "FreeRTOSConfig.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#define pdFALSE             ((BaseType_t)0)
+#define pdTRUE              ((BaseType_t)1)
+#define pdPASS              (pdTRUE)
+#define pdFAIL              (pdFALSE)
+#define errQUEUE_EMPTY      ((BaseType_t)0)
+#define errQUEUE_FULL       ((BaseType_t)0)
+
+#define portMAX_DELAY       ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+
+#ifndef pdMS_TO_TICKS
+#define pdMS_TO_TICKS(xTimeInMs) \
+    ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000))
+#endif
+
+#define tskIDLE_PRIORITY    ((UBaseType_t)0U)
+
+/* 分配方式默认值 (与内核FreeRTOS.h相同) */
+#ifndef configSUPPORT_STATIC_ALLOCATION
+#define configSUPPORT_STATIC_ALLOCATION     0
+#endif
+#ifndef configSUPPORT_DYNAMIC_ALLOCATION
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+#endif
+
+/* 跟踪钩子默认为空 (与内核FreeRTOS.h相同) */
+#ifndef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN()
+#endif
+#ifndef traceTASK_SWITCHED_OUT
+#define traceTASK_SWITCHED_OUT()
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 静态分配的控制块 (大小取Cortex-M3上的近似值, 内容由主机替身另行管理) */
+typedef struct xSTATIC_TCB { uint8_t dummy[96]; } StaticTask_t;
+typedef struct xSTATIC_QUEUE { uint8_t dummy[80]; } StaticQueue_t;
+
+#if configSUPPORT_DYNAMIC_ALLOCATION
+/* heap_4 统计 (主机替身按目标板的分配量记账, 见freertos_host.c) */
+size_t xPortGetFreeHeapSize(void);
+size_t xPortGetMinimumEverFreeHeapSize(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_FREERTOS_H */
@@ -0,0 +1,6 @@
+#ifndef __STM32_HAL_LEGACY
+#define __STM32_HAL_LEGACY
+
+/* 主机构建: 固件未使用旧版HAL别名, 保留空头文件以兼容包含关系 */
+
+#endif /* __STM32_HAL_LEGACY */
@@ -0,0 +1,598 @@
+#ifndef __STM32F1xx_HAL_H
+#define __STM32F1xx_HAL_H
+
+/*============================================================================
+ * 主机构建用 STM32F1 HAL 替身
+ * 只声明固件实际用到的类型、常量与函数; 行为在 hal_stub.c 中实现,
+ * SPI 转发到 XV7001BB 设备模型, CAN 转发到进程内虚拟总线
+ *============================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define __IO    volatile
+#define __STATIC_INLINE static inline
+
+typedef enum
+{
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY   0xFFFFFFFFU
+
+typedef enum
+{
+    DISABLE = 0U,
+    ENABLE = !DISABLE
+} FunctionalState;
+
+typedef enum
+{
+    RESET = 0U,
+    SET = !RESET
+} FlagStatus, ITStatus;
+
+extern uint32_t SystemCoreClock;
+
+/*============================================================================
+ * 内核外设: DWT / CoreDebug / NVIC
+ *============================================================================*/
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_coredebug;
+#define DWT                         (&host_dwt)
+#define CoreDebug                   (&host_coredebug)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+typedef enum
+{
+    USB_HP_CAN1_TX_IRQn  = 19,
+    USB_LP_CAN1_RX0_IRQn = 20,
+    CAN1_RX1_IRQn        = 21,
+    CAN1_SCE_IRQn        = 22,
+    EXTI15_10_IRQn       = 40,
+    RTC_Alarm_IRQn       = 41,
+    TIM2_IRQn            = 28
+} IRQn_Type;
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+#define __disable_irq()     ((void)0)
+#define __enable_irq()      ((void)0)
+#define __get_PRIMASK()     (0U)
+#define __set_PRIMASK(x)    ((void)(x))
+#define __DSB()             ((void)0)
+#define __ISB()             ((void)0)
+#define __WFI()             ((void)0)
+#define __NOP()             ((void)0)
+
+/*============================================================================
+ * HAL 基础
+ *============================================================================*/
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/*============================================================================
+ * RCC
+ *============================================================================*/
+#define RCC_OSCILLATORTYPE_HSE      0x00000001U
+#define RCC_OSCILLATORTYPE_HSI      0x00000002U
+#define RCC_OSCILLATORTYPE_LSE      0x00000004U
+#define RCC_OSCILLATORTYPE_LSI      0x00000008U
+#define RCC_HSE_ON                  0x00010000U
+#define RCC_HSE_PREDIV_DIV1         0x00000000U
+#define RCC_LSI_ON                  0x00000001U
+#define RCC_PLL_NONE                0x00000000U
+#define RCC_PLL_ON                  0x00000002U
+#define RCC_PLLSOURCE_HSE           0x00010000U
+#define RCC_PLL_MUL9                0x001C0000U
+#define RCC_CLOCKTYPE_SYSCLK        0x00000001U
+#define RCC_CLOCKTYPE_HCLK          0x00000002U
+#define RCC_CLOCKTYPE_PCLK1         0x00000004U
+#define RCC_CLOCKTYPE_PCLK2         0x00000008U
+#define RCC_SYSCLKSOURCE_PLLCLK     0x00000002U
+#define RCC_SYSCLK_DIV1             0x00000000U
+#define RCC_HCLK_DIV1               0x00000000U
+#define RCC_HCLK_DIV2               0x00000400U
+#define FLASH_LATENCY_2             0x00000002U
+
+typedef struct
+{
+    uint32_t PLLState;
+    uint32_t PLLSource;
+    uint32_t PLLMUL;
+} RCC_PLLInitTypeDef;
+
+typedef struct
+{
+    uint32_t OscillatorType;
+    uint32_t HSEState;
+    uint32_t HSEPredivValue;
+    uint32_t LSEState;
+    uint32_t HSIState;
+    uint32_t HSICalibrationValue;
+    uint32_t LSIState;
+    RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct
+{
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+    uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *RCC_ClkInitStruct, uint32_t FLatency);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_AFIO_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_SPI2_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_CAN1_CLK_ENABLE()     ((void)0)
+
+#define __HAL_RCC_PWR_CLK_ENABLE()      ((void)0)
+#define __HAL_RCC_BKP_CLK_ENABLE()      ((void)0)
+
+/* 复位原因 (RCC_CSR位): 默认上电复位, 仿真程序可改写host_reset_flags模拟热复位 */
+#define RCC_FLAG_PINRST                 ((uint8_t)0x7A)
+#define RCC_FLAG_PORRST                 ((uint8_t)0x7B)
+#define RCC_FLAG_SFTRST                 ((uint8_t)0x7C)
+#define RCC_FLAG_IWDGRST                ((uint8_t)0x7D)
+#define RCC_FLAG_WWDGRST                ((uint8_t)0x7E)
+#define RCC_FLAG_LPWRRST                ((uint8_t)0x7F)
+extern uint32_t host_reset_flags;
+#define __HAL_RCC_GET_FLAG(flag)        ((host_reset_flags >> ((flag) & 0x1FU)) & 1U)
+#define __HAL_RCC_CLEAR_RESET_FLAGS()   (host_reset_flags = 0U)
+
+#define __HAL_DBGMCU_FREEZE_IWDG()      ((void)0)
+
+/*============================================================================
+ * PWR / BKP (备份寄存器为普通数组, 跨越仿真中的"复位"保持)
+ *============================================================================*/
+typedef struct
+{
+    uint32_t RESERVED0;
+    __IO uint32_t DR1;
+    __IO uint32_t DR2;
+    __IO uint32_t DR3;
+    __IO uint32_t DR4;
+    __IO uint32_t DR5;
+    __IO uint32_t DR6;
+    __IO uint32_t DR7;
+    __IO uint32_t DR8;
+    __IO uint32_t DR9;
+    __IO uint32_t DR10;
+    __IO uint32_t RTCCR;
+    __IO uint32_t CR;
+    __IO uint32_t CSR;
+} BKP_TypeDef;
+
+extern BKP_TypeDef host_bkp;
+#define BKP     (&host_bkp)
+
+void HAL_PWR_EnableBkUpAccess(void);
+
+/*============================================================================
+ * IWDG (主机上按节拍检查超时, 超时只计数不复位)
+ *============================================================================*/
+typedef struct
+{
+    uint32_t KR;
+} IWDG_TypeDef;
+
+extern IWDG_TypeDef host_iwdg;
+#define IWDG    (&host_iwdg)
+
+#define IWDG_PRESCALER_4    0x00000000U
+#define IWDG_PRESCALER_32   0x00000003U
+#define IWDG_PRESCALER_256  0x00000006U
+
+typedef struct
+{
+    uint32_t Prescaler;
+    uint32_t Reload;
+} IWDG_InitTypeDef;
+
+typedef struct
+{
+    IWDG_TypeDef *Instance;
+    IWDG_InitTypeDef Init;
+} IWDG_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_IWDG_Init(IWDG_HandleTypeDef *hiwdg);
+HAL_StatusTypeDef HAL_IWDG_Refresh(IWDG_HandleTypeDef *hiwdg);
+uint32_t HostIwdg_Expired(void);
+
+/*============================================================================
+ * GPIO
+ *============================================================================*/
+typedef struct
+{
+    uint32_t ODR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef host_gpioa;
+extern GPIO_TypeDef host_gpiob;
+#define GPIOA   (&host_gpioa)
+#define GPIOB   (&host_gpiob)
+
+#define GPIO_PIN_0      ((uint16_t)0x0001)
+#define GPIO_PIN_1      ((uint16_t)0x0002)
+#define GPIO_PIN_2      ((uint16_t)0x0004)
+#define GPIO_PIN_3      ((uint16_t)0x0008)
+#define GPIO_PIN_4      ((uint16_t)0x0010)
+#define GPIO_PIN_5      ((uint16_t)0x0020)
+#define GPIO_PIN_6      ((uint16_t)0x0040)
+#define GPIO_PIN_7      ((uint16_t)0x0080)
+#define GPIO_PIN_8      ((uint16_t)0x0100)
+#define GPIO_PIN_9      ((uint16_t)0x0200)
+#define GPIO_PIN_10     ((uint16_t)0x0400)
+#define GPIO_PIN_11     ((uint16_t)0x0800)
+#define GPIO_PIN_12     ((uint16_t)0x1000)
+#define GPIO_PIN_13     ((uint16_t)0x2000)
+#define GPIO_PIN_14     ((uint16_t)0x4000)
+#define GPIO_PIN_15     ((uint16_t)0x8000)
+
+#define GPIO_MODE_INPUT         0x00000000U
+#define GPIO_MODE_OUTPUT_PP     0x00000001U
+#define GPIO_MODE_AF_PP         0x00000002U
+#define GPIO_MODE_IT_FALLING    0x10210000U
+#define GPIO_NOPULL             0x00000000U
+#define GPIO_PULLUP             0x00000001U
+#define GPIO_SPEED_FREQ_LOW     0x00000002U
+#define GPIO_SPEED_FREQ_HIGH    0x00000003U
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+} GPIO_InitTypeDef;
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/*============================================================================
+ * SPI
+ *============================================================================*/
+typedef struct
+{
+    uint32_t CR1;
+    __IO uint32_t SR;
+    __IO uint32_t DR;
+} SPI_TypeDef;
+
+extern SPI_TypeDef host_spi2;
+#define SPI2    (&host_spi2)
+
+#define SPI_MODE_MASTER             0x00000104U
+#define SPI_DIRECTION_2LINES        0x00000000U
+#define SPI_DATASIZE_8BIT           0x00000000U
+#define SPI_POLARITY_HIGH           0x00000002U
+#define SPI_PHASE_2EDGE             0x00000001U
+#define SPI_NSS_SOFT                0x00000200U
+#define SPI_BAUDRATEPRESCALER_2     0x00000000U
+#define SPI_BAUDRATEPRESCALER_4     0x00000008U
+#define SPI_BAUDRATEPRESCALER_8     0x00000010U
+#define SPI_BAUDRATEPRESCALER_16    0x00000018U
+#define SPI_BAUDRATEPRESCALER_32    0x00000020U
+#define SPI_BAUDRATEPRESCALER_64    0x00000028U
+#define SPI_BAUDRATEPRESCALER_128   0x00000030U
+#define SPI_BAUDRATEPRESCALER_256   0x00000038U
+#define SPI_FIRSTBIT_MSB            0x00000000U
+#define SPI_TIMODE_DISABLE          0x00000000U
+#define SPI_CRCCALCULATION_DISABLE  0x00000000U
+#define SPI_FLAG_RXNE               0x00000001U
+#define SPI_FLAG_OVR                0x00000040U
+#define SPI_FLAG_BSY                0x00000080U
+
+#define __HAL_SPI_GET_FLAG(h, flag)     ((((h)->Instance->SR) & (flag)) == (flag))
+#define __HAL_SPI_CLEAR_OVRFLAG(h)      do { __IO uint32_t tmpreg_ovr = (h)->Instance->DR; \
+                                             tmpreg_ovr = (h)->Instance->SR; (void)tmpreg_ovr; } while (0)
+
+typedef struct
+{
+    uint32_t Mode;
+    uint32_t Direction;
+    uint32_t DataSize;
+    uint32_t CLKPolarity;
+    uint32_t CLKPhase;
+    uint32_t NSS;
+    uint32_t BaudRatePrescaler;
+    uint32_t FirstBit;
+    uint32_t TIMode;
+    uint32_t CRCCalculation;
+    uint32_t CRCPolynomial;
+} SPI_InitTypeDef;
+
+typedef struct
+{
+    SPI_TypeDef *Instance;
+    SPI_InitTypeDef Init;
+} SPI_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef *hspi);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData,
+                                          uint16_t Size, uint32_t Timeout);
+
+/*============================================================================
+ * FLASH (主机上由RAM数组模拟)
+ *============================================================================*/
+#define FLASH_SIZE_BYTES            0x10000U
+extern uint8_t host_flash[FLASH_SIZE_BYTES];
+#define FLASH_BASE                  ((uintptr_t)host_flash)
+#define FLASH_PAGE_SIZE             0x400U
+
+#define FLASH_TYPEERASE_PAGES       0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD  0x01U
+#define FLASH_TYPEPROGRAM_WORD      0x02U
+#define FLASH_BANK_1                0x01U
+
+typedef struct
+{
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uintptr_t PageAddress;
+    uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uintptr_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+
+/*============================================================================
+ * CAN (bxCAN)
+ *============================================================================*/
+typedef struct
+{
+    uint32_t MCR;
+    uint32_t MSR;
+    uint32_t TSR;
+    uint32_t ESR;
+    uint32_t BTR;
+} CAN_TypeDef;
+
+extern CAN_TypeDef host_can1;
+#define CAN1    (&host_can1)
+
+#define CAN_MODE_NORMAL             0x00000000U
+#define CAN_MODE_LOOPBACK           0x40000000U
+#define CAN_MODE_SILENT             0x80000000U
+#define CAN_MODE_SILENT_LOOPBACK    0xC0000000U
+
+#define CAN_BTR_TS1_Pos             16U
+#define CAN_BTR_TS2_Pos             20U
+#define CAN_BTR_SJW_Pos             24U
+
+#define CAN_SJW_1TQ                 0x00000000U
+#define CAN_SJW_2TQ                 0x01000000U
+#define CAN_SJW_3TQ                 0x02000000U
+#define CAN_SJW_4TQ                 0x03000000U
+
+#define CAN_BS1_1TQ                 0x00000000U
+#define CAN_BS1_2TQ                 0x00010000U
+#define CAN_BS1_3TQ                 0x00020000U
+#define CAN_BS1_4TQ                 0x00030000U
+#define CAN_BS1_5TQ                 0x00040000U
+#define CAN_BS1_6TQ                 0x00050000U
+#define CAN_BS1_7TQ                 0x00060000U
+#define CAN_BS1_8TQ                 0x00070000U
+#define CAN_BS1_9TQ                 0x00080000U
+#define CAN_BS1_10TQ                0x00090000U
+#define CAN_BS1_11TQ                0x000A0000U
+#define CAN_BS1_12TQ                0x000B0000U
+#define CAN_BS1_13TQ                0x000C0000U
+#define CAN_BS1_14TQ                0x000D0000U
+#define CAN_BS1_15TQ                0x000E0000U
+#define CAN_BS1_16TQ                0x000F0000U
+
+#define CAN_BS2_1TQ                 0x00000000U
+#define CAN_BS2_2TQ                 0x00100000U
+#define CAN_BS2_3TQ                 0x00200000U
+#define CAN_BS2_4TQ                 0x00300000U
+#define CAN_BS2_5TQ                 0x00400000U
+#define CAN_BS2_6TQ                 0x00500000U
+#define CAN_BS2_7TQ                 0x00600000U
+#define CAN_BS2_8TQ                 0x00700000U
+
+#define CAN_FILTERMODE_IDMASK       0x00000000U
+#define CAN_FILTERSCALE_32BIT       0x00000001U
+#define CAN_RX_FIFO0                0x00000000U
+#define CAN_RX_FIFO1                0x00000001U
+#define CAN_FILTER_FIFO0            0x00000000U
+
+#define CAN_ID_STD                  0x00000000U
+#define CAN_ID_EXT                  0x00000004U
+#define CAN_RTR_DATA                0x00000000U
+#define CAN_RTR_REMOTE              0x00000002U
+
+#define CAN_TX_MAILBOX0             0x00000001U
+#define CAN_TX_MAILBOX1             0x00000002U
+#define CAN_TX_MAILBOX2             0x00000004U
+
+/* TSR.CODE: 下一个空邮箱号 (主机替身发送立即完成, 恒为0) */
+#define CAN_TSR_CODE_Pos            (24U)
+#define CAN_TSR_CODE                (0x3UL << CAN_TSR_CODE_Pos)
+
+#define CAN_IT_TX_MAILBOX_EMPTY     0x00000001U
+#define CAN_IT_RX_FIFO0_MSG_PENDING 0x00000002U
+#define CAN_IT_RX_FIFO0_FULL        0x00000004U
+#define CAN_IT_RX_FIFO0_OVERRUN     0x00000008U
+#define CAN_IT_WAKEUP               0x00010000U
+#define CAN_IT_SLEEP_ACK            0x00020000U
+#define CAN_IT_ERROR_WARNING        0x00000100U
+#define CAN_IT_ERROR_PASSIVE        0x00000200U
+#define CAN_IT_BUSOFF               0x00000400U
+#define CAN_IT_LAST_ERROR_CODE      0x00000800U
+#define CAN_IT_ERROR                0x00008000U
+
+#define HAL_CAN_ERROR_NONE          0x00000000U
+#define HAL_CAN_ERROR_EWG           0x00000001U
+#define HAL_CAN_ERROR_EPV           0x00000002U
+#define HAL_CAN_ERROR_BOF           0x00000004U
+#define HAL_CAN_ERROR_STF           0x00000008U
+#define HAL_CAN_ERROR_FOR           0x00000010U
+#define HAL_CAN_ERROR_ACK           0x00000020U
+#define HAL_CAN_ERROR_BR            0x00000040U
+#define HAL_CAN_ERROR_BD            0x00000080U
+#define HAL_CAN_ERROR_CRC           0x00000100U
+#define HAL_CAN_ERROR_RX_FOV0       0x00000200U
+#define HAL_CAN_ERROR_RX_FOV1       0x00000400U
+#define HAL_CAN_ERROR_TX_ALST0      0x00000800U
+#define HAL_CAN_ERROR_TX_TERR0      0x00001000U
+#define HAL_CAN_ERROR_TX_ALST1      0x00002000U
+#define HAL_CAN_ERROR_TX_TERR1      0x00004000U
+#define HAL_CAN_ERROR_TX_ALST2      0x00008000U
+#define HAL_CAN_ERROR_TX_TERR2      0x00010000U
+#define HAL_CAN_ERROR_TIMEOUT       0x00020000U
+
+/* ESR 寄存器位 */
+#define CAN_ESR_EWGF                0x00000001U
+#define CAN_ESR_EPVF                0x00000002U
+#define CAN_ESR_BOFF                0x00000004U
+#define CAN_ESR_LEC_Pos             4U
+#define CAN_ESR_LEC                 0x00000070U
+#define CAN_ESR_TEC_Pos             16U
+#define CAN_ESR_TEC                 0x00FF0000U
+#define CAN_ESR_REC_Pos             24U
+#define CAN_ESR_REC                 0xFF000000U
+
+typedef struct
+{
+    uint32_t Prescaler;
+    uint32_t Mode;
+    uint32_t SyncJumpWidth;
+    uint32_t TimeSeg1;
+    uint32_t TimeSeg2;
+    FunctionalState TimeTriggeredMode;
+    FunctionalState AutoBusOff;
+    FunctionalState AutoWakeUp;
+    FunctionalState AutoRetransmission;
+    FunctionalState ReceiveFifoLocked;
+    FunctionalState TransmitFifoPriority;
+} CAN_InitTypeDef;
+
+typedef struct
+{
+    uint32_t FilterIdHigh;
+    uint32_t FilterIdLow;
+    uint32_t FilterMaskIdHigh;
+    uint32_t FilterMaskIdLow;
+    uint32_t FilterFIFOAssignment;
+    uint32_t FilterBank;
+    uint32_t FilterMode;
+    uint32_t FilterScale;
+    uint32_t FilterActivation;
+    uint32_t SlaveStartFilterBank;
+} CAN_FilterTypeDef;
+
+typedef struct
+{
+    uint32_t StdId;
+    uint32_t ExtId;
+    uint32_t IDE;
+    uint32_t RTR;
+    uint32_t DLC;
+    FunctionalState TransmitGlobalTime;
+} CAN_TxHeaderTypeDef;
+
+typedef struct
+{
+    uint32_t StdId;
+    uint32_t ExtId;
+    uint32_t IDE;
+    uint32_t RTR;
+    uint32_t DLC;
+    uint32_t Timestamp;
+    uint32_t FilterMatchIndex;
+} CAN_RxHeaderTypeDef;
+
+typedef enum
+{
+    HAL_CAN_STATE_RESET         = 0x00U,
+    HAL_CAN_STATE_READY         = 0x01U,
+    HAL_CAN_STATE_LISTENING     = 0x02U,
+    HAL_CAN_STATE_SLEEP_PENDING = 0x03U,
+    HAL_CAN_STATE_SLEEP_ACTIVE  = 0x04U,
+    HAL_CAN_STATE_ERROR         = 0x05U
+} HAL_CAN_StateTypeDef;
+
+typedef struct
+{
+    CAN_TypeDef *Instance;
+    CAN_InitTypeDef Init;
+    __IO HAL_CAN_StateTypeDef State;
+    __IO uint32_t ErrorCode;
+} CAN_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_CAN_Init(CAN_HandleTypeDef *hcan);
+HAL_StatusTypeDef HAL_CAN_DeInit(CAN_HandleTypeDef *hcan);
+HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef *hcan, CAN_FilterTypeDef *sFilterConfig);
+HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef *hcan);
+HAL_StatusTypeDef HAL_CAN_Stop(CAN_HandleTypeDef *hcan);
+HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef *hcan, uint32_t ActiveITs);
+HAL_StatusTypeDef HAL_CAN_DeactivateNotification(CAN_HandleTypeDef *hcan, uint32_t InactiveITs);
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(CAN_HandleTypeDef *hcan);
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef *hcan, CAN_TxHeaderTypeDef *pHeader,
+                                       uint8_t aData[], uint32_t *pTxMailbox);
+HAL_StatusTypeDef HAL_CAN_AbortTxRequest(CAN_HandleTypeDef *hcan, uint32_t TxMailboxes);
+uint32_t HAL_CAN_IsTxMessagePending(CAN_HandleTypeDef *hcan, uint32_t TxMailboxes);
+uint32_t HAL_CAN_GetTxTimestamp(CAN_HandleTypeDef *hcan, uint32_t TxMailbox);
+uint32_t HAL_CAN_GetRxFifoFillLevel(CAN_HandleTypeDef *hcan, uint32_t RxFifo);
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef *hcan, uint32_t RxFifo,
+                                       CAN_RxHeaderTypeDef *pHeader, uint8_t aData[]);
+HAL_CAN_StateTypeDef HAL_CAN_GetState(CAN_HandleTypeDef *hcan);
+uint32_t HAL_CAN_GetError(CAN_HandleTypeDef *hcan);
+HAL_StatusTypeDef HAL_CAN_ResetError(CAN_HandleTypeDef *hcan);
+void HAL_CAN_IRQHandler(CAN_HandleTypeDef *hcan);
+
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan);
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan);
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan);
+void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan);
+void HAL_CAN_ErrorCallback(CAN_HandleTypeDef *hcan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F1xx_HAL_H */
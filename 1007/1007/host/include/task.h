@@ -0,0 +1,78 @@
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef enum
+{
+    eRunning = 0,
+    eReady,
+    eBlocked,
+    eSuspended,
+    eDeleted,
+    eInvalid
+} eTaskState;
+
+/* 与内核相同的任务状态结构 (uxTaskGetSystemState) */
+typedef struct xTASK_STATUS
+{
+    TaskHandle_t xHandle;
+    const char *pcTaskName;
+    UBaseType_t xTaskNumber;
+    eTaskState eCurrentState;
+    UBaseType_t uxCurrentPriority;
+    UBaseType_t uxBasePriority;
+    uint32_t ulRunTimeCounter;
+    StackType_t *pxStackBase;
+    uint16_t usStackHighWaterMark;
+} TaskStatus_t;
+
+#if configSUPPORT_DYNAMIC_ALLOCATION
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char * const pcName, const uint16_t usStackDepth,
+                       void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask);
+#endif
+#if configSUPPORT_STATIC_ALLOCATION
+TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode, const char * const pcName, const uint32_t ulStackDepth,
+                               void * const pvParameters, UBaseType_t uxPriority, StackType_t * const puxStackBuffer,
+                               StaticTask_t * const pxTaskBuffer);
+#endif
+void vTaskDelete(TaskHandle_t xTaskToDelete);
+void vTaskDelay(const TickType_t xTicksToDelay);
+void vTaskDelayUntil(TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement);
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+void vTaskStartScheduler(void);
+UBaseType_t uxTaskGetNumberOfTasks(void);
+UBaseType_t uxTaskGetSystemState(TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize,
+                                 uint32_t * const pulTotalRunTime);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask);
+TaskHandle_t xTaskGetIdleTaskHandle(void);
+void vTaskSetTaskNumber(TaskHandle_t xTask, const UBaseType_t uxHandle);
+UBaseType_t uxTaskGetTaskNumber(TaskHandle_t xTask);
+void vTaskSuspendAll(void);
+BaseType_t xTaskResumeAll(void);
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+void vPortYield(void);
+
+#define taskENTER_CRITICAL()            vPortEnterCritical()
+#define taskEXIT_CRITICAL()             vPortExitCritical()
+#define taskENTER_CRITICAL_FROM_ISR()   (vPortEnterCritical(), (UBaseType_t)0)
+#define taskEXIT_CRITICAL_FROM_ISR(x)   ((void)(x), vPortExitCritical())
+#define taskDISABLE_INTERRUPTS()        ((void)0)
+#define taskENABLE_INTERRUPTS()         ((void)0)
+#define taskYIELD()                     vPortYield()
+#define portYIELD_FROM_ISR(x)           ((void)(x))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TASK_H */
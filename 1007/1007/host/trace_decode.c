@@ -0,0 +1,498 @@
+#include "trace.h"
+#include "can.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*============================================================================
+ * trace_decode: 解码事件跟踪导出 (CAN_ID_TRACE), 输出时间线与统计
+ *
+ * 用法: trace_decode [-raw] [-q] [-chrome 输出.json] 输入
+ *   输入默认为SocketCAN candump -L日志 (只取0x329且DLC=8的帧);
+ *   -raw 输入为原始8字节帧序列 (xv7_sim -t 的输出)
+ *   -q  不打印逐事件时间线, 只打印统计
+ *   -chrome 另存为Chrome跟踪格式 (chrome://tracing 或 Perfetto打开)
+ *
+ * 日志中有多次导出时解码最后一次完整导出.
+ *============================================================================*/
+#define DECODE_LINE_MAX     256
+#define DECODE_MAX_TASKS    8
+#define DECODE_MAX_IRQ      64
+
+/* 任务号对应的名称 (1007.cpp中SysMonitor_RegisterTask的登记顺序) */
+static const char *const s_task_names[DECODE_MAX_TASKS] = {
+    "IDLE", "Main", "CAN_TX", "CAN_RX", "LED", "task5", "task6", "task7"
+};
+
+typedef struct {
+    double t_us;                /* 相对第一个事件的时间 */
+    uint8_t type;
+    uint8_t arg8;
+    uint16_t arg16;
+} Decode_Event;
+
+/* 区间统计 */
+typedef struct {
+    uint32_t count;
+    double total_us;
+    double max_us;
+} Decode_Span;
+
+static Decode_Event *s_events;
+static uint32_t s_event_count;
+
+/**
+ * @brief 解析一行candump -L输出 (同xvlog_from_candump)
+ * @return true=解析成功
+ */
+static bool Decode_ParseLine(const char *line, uint32_t *id, uint8_t *data, int *dlc)
+{
+    double ts;
+    char iface[32];
+    char frame[64];
+    char *hash;
+    char *end;
+
+    if (sscanf(line, " (%lf) %31s %63s", &ts, iface, frame) != 3 || (hash = strchr(frame, '#')) == NULL)
+    {
+        return false;
+    }
+
+    *hash = '\0';
+    *id = (uint32_t)strtoul(frame, &end, 16);
+    if (*end != '\0')
+    {
+        return false;
+    }
+
+    *dlc = 0;
+    for (const char *p = hash + 1; p[0] != '\0' && p[1] != '\0' && *dlc < 8; p += 2)
+    {
+        char byte[3] = { p[0], p[1], '\0' };
+        data[(*dlc)++] = (uint8_t)strtoul(byte, NULL, 16);
+    }
+    return true;
+}
+
+/**
+ * @brief 读取下一导出帧
+ * @return true=data有效
+ */
+static bool Decode_NextFrame(FILE *in, bool raw, uint8_t data[8])
+{
+    if (raw)
+    {
+        return fread(data, 8, 1, in) == 1;
+    }
+
+    char line[DECODE_LINE_MAX];
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        uint32_t id;
+        int dlc;
+        if (Decode_ParseLine(line, &id, data, &dlc) && id == CAN_ID_TRACE && dlc == 8)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t Decode_U32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief 读入最后一次完整导出, 周期计数展开为微秒
+ * @return 导出次数 (0=无完整导出)
+ */
+static int Decode_Load(FILE *in, bool raw, uint32_t *total, uint32_t *mhz)
+{
+    uint8_t data[8];
+    uint32_t *cycles = malloc(sizeof(uint32_t) * 65536);
+    Decode_Event *events = malloc(sizeof(Decode_Event) * 65536);
+    uint32_t expected = 0;
+    uint32_t got = 0;
+    uint32_t head = 0;
+    uint32_t clock = 0;
+    int dumps = 0;
+
+    s_events = malloc(sizeof(Decode_Event) * 65536);
+    while (Decode_NextFrame(in, raw, data))
+    {
+        if (data[4] == TRACE_EV_HEADER)
+        {
+            head = Decode_U32(data);
+            clock = data[5];
+            expected = (uint32_t)data[6] | ((uint32_t)data[7] << 8);
+            got = 0;
+        }
+        else if (got < expected)
+        {
+            cycles[got] = Decode_U32(data);
+            events[got].type = data[4];
+            events[got].arg8 = data[5];
+            events[got].arg16 = (uint16_t)(data[6] | (data[7] << 8));
+            got++;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (got == expected && clock != 0)
+        {
+            /* 完整导出: 按无符号差值累加, 跨越32-bit回绕 */
+            double t = 0.0;
+            for (uint32_t i = 0; i < got; i++)
+            {
+                if (i > 0)
+                {
+                    t += (double)(uint32_t)(cycles[i] - cycles[i - 1]) / clock;
+                }
+                s_events[i] = events[i];
+                s_events[i].t_us = t;
+            }
+            s_event_count = got;
+            *total = head;
+            *mhz = clock;
+            dumps++;
+            expected = 0;
+            clock = 0;
+        }
+    }
+
+    free(cycles);
+    free(events);
+    return dumps;
+}
+
+static const char *Decode_TaskName(uint16_t number)
+{
+    static char name[16];
+
+    if (number < DECODE_MAX_TASKS)
+    {
+        return s_task_names[number];
+    }
+    snprintf(name, sizeof(name), "task%u", number);
+    return name;
+}
+
+static void Decode_SpanAdd(Decode_Span *span, double us)
+{
+    span->count++;
+    span->total_us += us;
+    if (us > span->max_us)
+    {
+        span->max_us = us;
+    }
+}
+
+static void Decode_SpanPrint(const char *name, const Decode_Span *span)
+{
+    if (span->count > 0)
+    {
+        printf("  %-14s n=%-6u avg=%9.2fus max=%9.2fus\n", name, span->count,
+               span->total_us / span->count, span->max_us);
+    }
+}
+
+/**
+ * @brief 逐事件时间线
+ */
+static void Decode_PrintTimeline(void)
+{
+    for (uint32_t i = 0; i < s_event_count; i++)
+    {
+        const Decode_Event *e = &s_events[i];
+        double dt = (i > 0) ? e->t_us - s_events[i - 1].t_us : 0.0;
+
+        printf("%12.2f %+10.2f  ", e->t_us, dt);
+        switch (e->type)
+        {
+        case TRACE_EV_TASK_IN:      printf("task_in    %s\n", Decode_TaskName(e->arg16)); break;
+        case TRACE_EV_TASK_OUT:     printf("task_out   %s\n", Decode_TaskName(e->arg16)); break;
+        case TRACE_EV_ISR_ENTER:    printf("isr_enter  irq %u\n", e->arg8); break;
+        case TRACE_EV_ISR_EXIT:     printf("isr_exit   irq %u\n", e->arg8); break;
+        case TRACE_EV_SPI_BEGIN:    printf("spi_begin  cmd 0x%02X\n", e->arg8); break;
+        case TRACE_EV_SPI_END:      printf("spi_end\n"); break;
+        case TRACE_EV_CAN_TX:       printf("can_tx     0x%03X [%u]\n", e->arg16, e->arg8); break;
+        case TRACE_EV_CAN_TX_DONE:  printf("can_tx_ok  mailbox %u\n", e->arg8); break;
+        case TRACE_EV_CAN_RX:       printf("can_rx     0x%03X [%u]\n", e->arg16, e->arg8); break;
+        case TRACE_EV_MARK:         printf("mark       %u (%u)\n", e->arg8, e->arg16); break;
+        default:                    printf("unknown    0x%02X %u %u\n", e->type, e->arg8, e->arg16); break;
+        }
+    }
+}
+
+/**
+ * @brief 统计: 任务运行时间, 中断/SPI/主循环耗时, CAN帧数
+ */
+static void Decode_PrintSummary(void)
+{
+    Decode_Span task_run[DECODE_MAX_TASKS];
+    Decode_Span isr[DECODE_MAX_IRQ];
+    Decode_Span spi = { 0 };
+    Decode_Span main_loop = { 0 };
+    Decode_Span main_period = { 0 };
+    double task_in_t[DECODE_MAX_TASKS];
+    double isr_t[DECODE_MAX_IRQ];
+    double spi_t = -1.0;
+    double main_begin_t = -1.0;
+    double main_min_period = 0.0;
+    uint32_t can_tx = 0;
+    uint32_t can_tx_done = 0;
+    uint32_t can_rx = 0;
+    double span_us = (s_event_count > 0) ? s_events[s_event_count - 1].t_us : 0.0;
+
+    memset(task_run, 0, sizeof(task_run));
+    memset(isr, 0, sizeof(isr));
+    for (int i = 0; i < DECODE_MAX_TASKS; i++)
+    {
+        task_in_t[i] = -1.0;
+    }
+    for (int i = 0; i < DECODE_MAX_IRQ; i++)
+    {
+        isr_t[i] = -1.0;
+    }
+
+    for (uint32_t i = 0; i < s_event_count; i++)
+    {
+        const Decode_Event *e = &s_events[i];
+        int task = (e->arg16 < DECODE_MAX_TASKS) ? e->arg16 : DECODE_MAX_TASKS - 1;
+        int irq = (e->arg8 < DECODE_MAX_IRQ) ? e->arg8 : DECODE_MAX_IRQ - 1;
+
+        switch (e->type)
+        {
+        case TRACE_EV_TASK_IN:
+            task_in_t[task] = e->t_us;
+            break;
+        case TRACE_EV_TASK_OUT:
+            if (task_in_t[task] >= 0.0)
+            {
+                Decode_SpanAdd(&task_run[task], e->t_us - task_in_t[task]);
+                task_in_t[task] = -1.0;
+            }
+            break;
+        case TRACE_EV_ISR_ENTER:
+            isr_t[irq] = e->t_us;
+            break;
+        case TRACE_EV_ISR_EXIT:
+            if (isr_t[irq] >= 0.0)
+            {
+                Decode_SpanAdd(&isr[irq], e->t_us - isr_t[irq]);
+                isr_t[irq] = -1.0;
+            }
+            break;
+        case TRACE_EV_SPI_BEGIN:
+            spi_t = e->t_us;
+            break;
+        case TRACE_EV_SPI_END:
+            if (spi_t >= 0.0)
+            {
+                Decode_SpanAdd(&spi, e->t_us - spi_t);
+                spi_t = -1.0;
+            }
+            break;
+        case TRACE_EV_CAN_TX:
+            can_tx++;
+            break;
+        case TRACE_EV_CAN_TX_DONE:
+            can_tx_done++;
+            break;
+        case TRACE_EV_CAN_RX:
+            can_rx++;
+            break;
+        case TRACE_EV_MARK:
+            if (e->arg8 == TRACE_MARK_MAIN_BEGIN)
+            {
+                if (main_begin_t >= 0.0)
+                {
+                    double period = e->t_us - main_begin_t;
+                    Decode_SpanAdd(&main_period, period);
+                    if (main_period.count == 1 || period < main_min_period)
+                    {
+                        main_min_period = period;
+                    }
+                }
+                main_begin_t = e->t_us;
+            }
+            else if (e->arg8 == TRACE_MARK_MAIN_END && main_begin_t >= 0.0)
+            {
+                Decode_SpanAdd(&main_loop, e->t_us - main_begin_t);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    printf("span_us        %.2f\n", span_us);
+    printf("tasks:\n");
+    for (int i = 0; i < DECODE_MAX_TASKS; i++)
+    {
+        if (task_run[i].count > 0)
+        {
+            printf("  %-14s run=%6.2f%% switches=%-5u max_slice=%9.2fus\n", Decode_TaskName((uint16_t)i),
+                   (span_us > 0.0) ? task_run[i].total_us * 100.0 / span_us : 0.0,
+                   task_run[i].count, task_run[i].max_us);
+        }
+    }
+    printf("spans:\n");
+    for (int i = 0; i < DECODE_MAX_IRQ; i++)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "isr_%d", i);
+        Decode_SpanPrint(name, &isr[i]);
+    }
+    Decode_SpanPrint("spi", &spi);
+    Decode_SpanPrint("main_loop", &main_loop);
+    Decode_SpanPrint("main_period", &main_period);
+    if (main_period.count > 0)
+    {
+        printf("  %-14s min=%9.2fus\n", "main_period", main_min_period);
+    }
+    printf("can_tx         %u (done %u)\n", can_tx, can_tx_done);
+    printf("can_rx         %u\n", can_rx);
+}
+
+/**
+ * @brief Chrome跟踪格式: 任务/中断/SPI为区间, CAN帧与标记为瞬时事件
+ */
+static int Decode_WriteChrome(const char *path)
+{
+    FILE *out = fopen(path, "w");
+    bool first = true;
+
+    if (out == NULL)
+    {
+        return -1;
+    }
+
+    fprintf(out, "{\"traceEvents\":[\n");
+    for (uint32_t i = 0; i < s_event_count; i++)
+    {
+        const Decode_Event *e = &s_events[i];
+        const char *ph = NULL;
+        char name[32];
+        int tid = 0;
+
+        switch (e->type)
+        {
+        case TRACE_EV_TASK_IN:
+        case TRACE_EV_TASK_OUT:
+            ph = (e->type == TRACE_EV_TASK_IN) ? "B" : "E";
+            snprintf(name, sizeof(name), "%s", Decode_TaskName(e->arg16));
+            tid = 1 + e->arg16;
+            break;
+        case TRACE_EV_ISR_ENTER:
+        case TRACE_EV_ISR_EXIT:
+            ph = (e->type == TRACE_EV_ISR_ENTER) ? "B" : "E";
+            snprintf(name, sizeof(name), "irq %u", e->arg8);
+            tid = 100;
+            break;
+        case TRACE_EV_SPI_BEGIN:
+        case TRACE_EV_SPI_END:
+            ph = (e->type == TRACE_EV_SPI_BEGIN) ? "B" : "E";
+            snprintf(name, sizeof(name), "spi");
+            tid = 101;
+            break;
+        case TRACE_EV_CAN_TX:
+        case TRACE_EV_CAN_RX:
+            ph = "i";
+            snprintf(name, sizeof(name), "%s 0x%03X", (e->type == TRACE_EV_CAN_TX) ? "tx" : "rx", e->arg16);
+            tid = 102;
+            break;
+        case TRACE_EV_MARK:
+            ph = "i";
+            snprintf(name, sizeof(name), "mark %u", e->arg8);
+            tid = 103;
+            break;
+        default:
+            break;
+        }
+        if (ph == NULL)
+        {
+            continue;
+        }
+
+        fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%d%s}",
+                first ? "" : ",\n", name, ph, e->t_us, tid, (ph[0] == 'i') ? ",\"s\":\"t\"" : "");
+        first = false;
+    }
+    fprintf(out, "\n]}\n");
+    fclose(out);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *in_path = NULL;
+    const char *chrome_path = NULL;
+    bool raw = false;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-raw") == 0)
+        {
+            raw = true;
+        }
+        else if (strcmp(argv[i], "-q") == 0)
+        {
+            quiet = true;
+        }
+        else if (strcmp(argv[i], "-chrome") == 0 && i + 1 < argc)
+        {
+            chrome_path = argv[++i];
+        }
+        else if (in_path == NULL)
+        {
+            in_path = argv[i];
+        }
+        else
+        {
+            in_path = NULL;
+            break;
+        }
+    }
+    if (in_path == NULL)
+    {
+        fprintf(stderr, "usage: %s [-raw] [-q] [-chrome out.json] trace.log|trace.xtr\n", argv[0]);
+        return 2;
+    }
+
+    FILE *in = fopen(in_path, raw ? "rb" : "r");
+    if (in == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", in_path);
+        return 2;
+    }
+
+    uint32_t total = 0;
+    uint32_t mhz = 0;
+    int dumps = Decode_Load(in, raw, &total, &mhz);
+    fclose(in);
+    if (dumps == 0)
+    {
+        fprintf(stderr, "no complete trace dump in %s\n", in_path);
+        return 1;
+    }
+
+    if (!quiet)
+    {
+        Decode_PrintTimeline();
+    }
+    printf("dumps          %d\n", dumps);
+    printf("events         %u (recorded %u, clock %u MHz)\n", s_event_count, total, mhz);
+    Decode_PrintSummary();
+
+    if (chrome_path != NULL && Decode_WriteChrome(chrome_path) != 0)
+    {
+        fprintf(stderr, "cannot write %s\n", chrome_path);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "virtual_can.h"
+#include <string.h>
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+typedef struct {
+    VCan_RxHandler handler;
+    void *ctx;
+} VCan_Node;
+
+static VCan_Node s_nodes[VCAN_MAX_NODES];
+static int s_node_count;
+static uint32_t s_bitrate = 500000;
+static VCan_Stats s_stats;
+
+/*============================================================================
+ * 公共函数实现
+ *============================================================================*/
+
+void VCan_Reset(uint32_t bitrate)
+{
+    memset(s_nodes, 0, sizeof(s_nodes));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_node_count = 0;
+    s_bitrate = bitrate;
+}
+
+uint32_t VCan_GetBitrate(void)
+{
+    return s_bitrate;
+}
+
+int VCan_Attach(VCan_RxHandler handler, void *ctx)
+{
+    if (s_node_count >= VCAN_MAX_NODES)
+    {
+        return -1;
+    }
+    s_nodes[s_node_count].handler = handler;
+    s_nodes[s_node_count].ctx = ctx;
+    return s_node_count++;
+}
+
+/**
+ * @brief 节点发送一帧
+ * 
+ * 帧长按标准数据帧计: 47 + 8×DLC 位 (不含填充位)
+ */
+void VCan_Transmit(int node, const VCan_Frame *frame, uint32_t bitrate)
+{
+    bool ok = (bitrate == s_bitrate);
+    
+    s_stats.frames++;
+    s_stats.bits += 47U + 8U * frame->dlc;
+    if (!ok)
+    {
+        s_stats.error_frames++;
+    }
+    
+    for (int i = 0; i < s_node_count; i++)
+    {
+        if (i != node && s_nodes[i].handler != NULL)
+        {
+            s_nodes[i].handler(s_nodes[i].ctx, frame, ok);
+        }
+    }
+}
+
+void VCan_GetStats(VCan_Stats *stats)
+{
+    *stats = s_stats;
+}
@@ -0,0 +1,70 @@
+#ifndef __VIRTUAL_CAN_H
+#define __VIRTUAL_CAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================
+ * 进程内虚拟CAN总线
+ * 
+ * 发送立即完成并同步投递给其他所有节点; 节点位速率与总线位速率不一致时
+ * 接收方只收到错误 (模拟位错误/填充错误), 用于验证自动波特率检测.
+ *============================================================================*/
+#define VCAN_MAX_NODES      8
+
+typedef struct {
+    uint32_t id;                /* 标准ID */
+    uint8_t dlc;
+    uint8_t data[8];
+    uint64_t cycles;            /* 发送时刻 (虚拟周期) */
+} VCan_Frame;
+
+/**
+ * @brief 接收回调
+ * @param ok false=位速率不匹配, 只能检测到错误
+ */
+typedef void (*VCan_RxHandler)(void *ctx, const VCan_Frame *frame, bool ok);
+
+typedef struct {
+    uint64_t frames;            /* 总线上的帧数 */
+    uint64_t bits;              /* 总线占用位数 (不含填充位) */
+    uint64_t error_frames;      /* 位速率不匹配的帧 */
+} VCan_Stats;
+
+/**
+ * @brief 复位总线 (断开所有节点, 清零统计)
+ */
+void VCan_Reset(uint32_t bitrate);
+
+/**
+ * @brief 总线位速率 (外部节点使用的速率)
+ */
+uint32_t VCan_GetBitrate(void);
+
+/**
+ * @brief 接入一个节点
+ * @return 节点号, -1=节点已满
+ */
+int VCan_Attach(VCan_RxHandler handler, void *ctx);
+
+/**
+ * @brief 节点发送一帧
+ * @param node 发送节点号
+ * @param bitrate 发送节点的位速率
+ */
+void VCan_Transmit(int node, const VCan_Frame *frame, uint32_t bitrate);
+
+/**
+ * @brief 获取总线统计
+ */
+void VCan_GetStats(VCan_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __VIRTUAL_CAN_H */
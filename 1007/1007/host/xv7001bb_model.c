@@ -0,0 +1,397 @@
+#include "xv7001bb_model.h"
+#include "freertos_host.h"
+#include "xv7001bb.h"
+#include <math.h>
+#include <string.h>
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+typedef struct {
+    uint8_t regs[0x20];
+    uint8_t state;
+    double ready_time;                      /* PROC_OK置位时刻 (秒) */
+    int32_t zero_offset;                    /* 零点校准锁存的偏移 (LSB) */
+    
+    bool selected;
+    uint32_t byte_index;                    /* 事务内字节序号 */
+    uint8_t command;
+    uint8_t shift[4];                       /* 读数据移位寄存器 */
+    uint32_t shift_len;
+    
+    Xv7Model_Source source;
+    uint32_t rate_count;                    /* 角速度读取次数 (输出抖动) */
+    double sample_t;                        /* 输出寄存器上次更新时刻 (秒, <0=未更新) */
+    double sample_dps;
+    
+    uint8_t fault;                          /* 注入的故障 XV7_MODEL_FAULT_* */
+    uint32_t fault_left;                    /* 剩余受影响次数, 0=持续 */
+    int32_t stuck_raw;                      /* STUCK: 冻结的输出 */
+    bool stuck_latched;
+} Xv7Model_Device;
+
+static Xv7Model_Device s_dev[XV7_MODEL_MAX_DEVICES];
+static uint8_t s_fitted = 0x01;             /* 装配位图 */
+static Xv7Model_Stats s_stats;
+
+/*============================================================================
+ * 默认样本源
+ *============================================================================*/
+static double Xv7Model_DefaultRate(void *ctx, double t)
+{
+    (void)ctx;
+    (void)t;
+    return 0.0;
+}
+
+static float Xv7Model_DefaultTemp(void *ctx, double t)
+{
+    (void)ctx;
+    (void)t;
+    return 25.0f;
+}
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+/**
+ * @brief 当前角速度输出 (LSB, 含零点校准偏移与饱和)
+ */
+static int32_t Xv7Model_RateRaw(Xv7Model_Device *d, double t)
+{
+    double lsb;
+    
+    /* 输出寄存器按内部更新周期刷新, 周期内重复读取得到同一样本 */
+    if (d->sample_t < 0.0 || t - d->sample_t >= XV7_MODEL_UPDATE_S)
+    {
+        d->sample_dps = d->source.rate_dps(d->source.ctx, t);
+        d->sample_t = t;
+    }
+    lsb = d->sample_dps * XV7_GYRO_SENSITIVITY_24BIT;
+    
+    /* 输出抖动1~2 LSB; 16-bit输出为24-bit值右移8位, 抖动被截去, 低噪声时读数可连续相同 */
+    lsb += 1.0 + (double)(d->rate_count & 1);
+    
+    lsb = floor(lsb + 0.5) - d->zero_offset;
+    if (lsb > XV7_MODEL_RAW_MAX)
+    {
+        lsb = XV7_MODEL_RAW_MAX;
+    }
+    if (lsb < -XV7_MODEL_RAW_MAX - 1)
+    {
+        lsb = -XV7_MODEL_RAW_MAX - 1;
+    }
+    return (int32_t)lsb;
+}
+
+/**
+ * @brief 注入的故障生效一次, 次数用完后恢复
+ */
+static void Xv7Model_FaultUsed(Xv7Model_Device *d)
+{
+    if (d->fault_left > 0 && --d->fault_left == 0)
+    {
+        d->fault = XV7_MODEL_FAULT_NONE;
+        d->stuck_latched = false;
+    }
+}
+
+/**
+ * @brief 状态寄存器值
+ */
+static uint8_t Xv7Model_Status(Xv7Model_Device *d, double t)
+{
+    uint8_t status = d->state & XV7_STATUS_STATE_MASK;
+    
+    if (t >= d->ready_time)
+    {
+        status |= XV7_STATUS_PROC_OK;
+    }
+    return status;
+}
+
+/**
+ * @brief 读命令: 锁存输出数据
+ */
+static void Xv7Model_LatchRead(Xv7Model_Device *d, uint8_t reg, double t)
+{
+    memset(d->shift, 0, sizeof(d->shift));
+    d->shift_len = 1;
+    
+    switch (reg)
+    {
+    case XV7_REG_STATUS:
+        d->shift[0] = Xv7Model_Status(d, t);
+        s_stats.status_reads++;
+        break;
+        
+    case XV7_REG_RATE_READ:
+    {
+        /* 非工作状态输出0 */
+        int32_t raw = (d->state == XV7_STATE_SLEEP_OUT && t >= d->ready_time) ? Xv7Model_RateRaw(d, t) : 0;
+        d->rate_count++;
+        if (d->fault == XV7_MODEL_FAULT_STUCK)
+        {
+            if (!d->stuck_latched)
+            {
+                d->stuck_raw = raw;
+                d->stuck_latched = true;
+            }
+            raw = d->stuck_raw;
+            Xv7Model_FaultUsed(d);
+        }
+        else if (d->fault == XV7_MODEL_FAULT_JUMP)
+        {
+            raw += (int32_t)(XV7_MODEL_JUMP_DPS * XV7_GYRO_SENSITIVITY_24BIT);
+            raw = (raw > XV7_MODEL_RAW_MAX) ? XV7_MODEL_RAW_MAX : raw;
+            Xv7Model_FaultUsed(d);
+        }
+        if (d->regs[XV7_REG_RATE_CTRL] & XV7_RATE_CTRL_24BIT)
+        {
+            d->shift[0] = (uint8_t)((raw >> 16) & 0xFF);
+            d->shift[1] = (uint8_t)((raw >> 8) & 0xFF);
+            d->shift[2] = (uint8_t)(raw & 0xFF);
+            d->shift_len = 3;
+        }
+        else
+        {
+            /* 16-bit: 24-bit值右移8位 (算术移位, 向负无穷截断) */
+            int32_t raw16 = raw >> XV7_RATE_16BIT_SHIFT;
+            d->shift[0] = (uint8_t)((raw16 >> 8) & 0xFF);
+            d->shift[1] = (uint8_t)(raw16 & 0xFF);
+            d->shift_len = 2;
+        }
+        s_stats.rate_reads++;
+        break;
+    }
+        
+    case XV7_REG_TEMP_READ:
+    {
+        /* 与驱动解码一致: T = raw/16 - 6, raw位于16-bit字的高10位 */
+        double code = ((double)d->source.temp_c(d->source.ctx, t) + 6.0) * 16.0;
+        uint16_t raw = (code < 0.0) ? 0 : (code > 1023.0) ? 1023 : (uint16_t)(code + 0.5);
+        uint16_t word = (uint16_t)(raw << 6);
+        d->shift[0] = (uint8_t)(word >> 8);
+        d->shift[1] = (uint8_t)(word & 0xFF);
+        d->shift_len = 2;
+        s_stats.temp_reads++;
+        break;
+    }
+        
+    default:
+        d->shift[0] = d->regs[reg & 0x1F];
+        break;
+    }
+}
+
+/**
+ * @brief 上电复位一个设备 (状态AFTER_POR, 寄存器清零; 软件复位同此)
+ */
+static void Xv7Model_PowerOn(Xv7Model_Device *d)
+{
+    memset(d->regs, 0, sizeof(d->regs));
+    d->regs[XV7_REG_RATE_CTRL] = XV7_RATE_CTRL_24BIT;  /* 与驱动假设一致: 默认24-bit输出 */
+    d->state = XV7_STATE_AFTER_POR;
+    d->ready_time = 0.0;
+    d->zero_offset = 0;
+    d->sample_t = -1.0;
+    d->byte_index = 0;
+    d->shift_len = 0;
+}
+
+/**
+ * @brief 写命令生效
+ */
+static void Xv7Model_Write(Xv7Model_Device *d, uint8_t reg, uint8_t data, double t)
+{
+    d->regs[reg & 0x1F] = data;
+    s_stats.writes++;
+    
+    switch (reg)
+    {
+    case XV7_REG_SLEEP_OUT:
+        if (d->state != XV7_STATE_SLEEP_OUT)
+        {
+            d->state = XV7_STATE_SLEEP_OUT;
+            d->ready_time = t + XV7_MODEL_WAKE_MS * 1e-3;
+        }
+        break;
+        
+    case XV7_REG_SLEEP_IN:
+        d->state = XV7_STATE_SLEEP;
+        break;
+        
+    case XV7_REG_STANDBY:
+        d->state = XV7_STATE_STANDBY;
+        break;
+        
+    case XV7_REG_SOFT_RST:
+        Xv7Model_PowerOn(d);
+        break;
+        
+    case XV7_REG_ZERO_CAL:
+        /* 以当前输出为零点 */
+        d->zero_offset += Xv7Model_RateRaw(d, t);
+        break;
+        
+    default:
+        break;
+    }
+}
+
+/*============================================================================
+ * 公共函数实现
+ *============================================================================*/
+
+void Xv7Model_Reset(void)
+{
+    for (int i = 0; i < XV7_MODEL_MAX_DEVICES; i++)
+    {
+        Xv7Model_PowerOn(&s_dev[i]);
+        s_dev[i].fault = XV7_MODEL_FAULT_NONE;
+        s_dev[i].stuck_latched = false;
+        if (s_dev[i].source.rate_dps == NULL)
+        {
+            Xv7Model_SetDeviceSource(i, NULL);
+        }
+    }
+}
+
+void Xv7Model_SetSource(const Xv7Model_Source *source)
+{
+    for (int i = 0; i < XV7_MODEL_MAX_DEVICES; i++)
+    {
+        Xv7Model_SetDeviceSource(i, source);
+    }
+}
+
+void Xv7Model_SetDeviceSource(int index, const Xv7Model_Source *source)
+{
+    Xv7Model_Device *d = &s_dev[index];
+    
+    if (source != NULL)
+    {
+        d->source = *source;
+    }
+    else
+    {
+        d->source.rate_dps = Xv7Model_DefaultRate;
+        d->source.temp_c = Xv7Model_DefaultTemp;
+        d->source.ctx = NULL;
+    }
+}
+
+void Xv7Model_SetFitted(uint8_t mask)
+{
+    s_fitted = mask & ((1U << XV7_MODEL_MAX_DEVICES) - 1U);
+}
+
+uint8_t Xv7Model_FittedMask(void)
+{
+    return s_fitted;
+}
+
+void Xv7Model_Inject(int index, uint8_t fault, uint32_t count)
+{
+    Xv7Model_Device *d = &s_dev[index];
+    
+    d->fault = fault;
+    d->fault_left = count;
+    d->stuck_latched = false;
+}
+
+bool Xv7Model_BusFault(void)
+{
+    for (int i = 0; i < XV7_MODEL_MAX_DEVICES; i++)
+    {
+        if (s_dev[i].selected && s_dev[i].fault == XV7_MODEL_FAULT_SPI)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Xv7Model_Select(int index, bool selected)
+{
+    Xv7Model_Device *d = &s_dev[index];
+    
+    if (selected && !d->selected)
+    {
+        d->byte_index = 0;
+    }
+    else if (!selected && d->selected && d->byte_index > 0)
+    {
+        s_stats.transactions++;
+        if (d->fault == XV7_MODEL_FAULT_ONES || d->fault == XV7_MODEL_FAULT_ZEROS ||
+            d->fault == XV7_MODEL_FAULT_SPI)
+        {
+            Xv7Model_FaultUsed(d);
+        }
+    }
+    d->selected = selected;
+}
+
+uint8_t Xv7Model_Transfer(uint8_t mosi)
+{
+    double t = HostSim_Seconds();
+    Xv7Model_Device *d = NULL;
+    uint8_t miso = 0xFF;
+    
+    for (int i = 0; i < XV7_MODEL_MAX_DEVICES; i++)
+    {
+        if (s_dev[i].selected)
+        {
+            if (d != NULL)
+            {
+                s_stats.protocol_errors++;  /* 多个片选同时有效 */
+                return 0xFF;
+            }
+            d = &s_dev[i];
+        }
+    }
+    if (d == NULL)
+    {
+        s_stats.protocol_errors++;
+        return 0xFF;
+    }
+    
+    /* 未装配, MISO悬空或SPI超时: 设备收不到命令, 读为0xFF */
+    if (!(s_fitted & (1U << (d - s_dev))) || d->fault == XV7_MODEL_FAULT_ONES || d->fault == XV7_MODEL_FAULT_SPI)
+    {
+        d->byte_index++;
+        return 0xFF;
+    }
+    
+    if (d->byte_index == 0)
+    {
+        d->command = mosi;
+        if (mosi & 0x80)
+        {
+            Xv7Model_LatchRead(d, mosi & 0x7F, t);
+        }
+    }
+    else if (d->command & 0x80)
+    {
+        uint32_t i = d->byte_index - 1;
+        miso = (i < d->shift_len) ? d->shift[i] : 0xFF;
+    }
+    else if (d->byte_index == 1)
+    {
+        Xv7Model_Write(d, d->command & 0x7F, mosi, t);
+    }
+    
+    d->byte_index++;
+    return (d->fault == XV7_MODEL_FAULT_ZEROS) ? 0x00 : miso;
+}
+
+uint8_t Xv7Model_PeekReg(int index, uint8_t reg)
+{
+    return s_dev[index].regs[reg & 0x1F];
+}
+
+void Xv7Model_GetStats(Xv7Model_Stats *stats)
+{
+    *stats = s_stats;
+}
@@ -0,0 +1,127 @@
+#ifndef __XV7001BB_MODEL_H
+#define __XV7001BB_MODEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================
+ * XV7001BB SPI设备模型
+ * 
+ * 按 xv7001bb.h 的寄存器映射逐字节响应SPI传输:
+ *   NSS下降沿开始事务, 首字节 bit7=1读/0写, bit6:0为寄存器地址
+ *   读: 命令字节时锁存输出数据, 之后每个dummy字节移出一字节 (高位在前)
+ *   写: 第二字节为数据, 命令类寄存器 (SLEEP_OUT/STANDBY/SOFT_RST...) 立即生效
+ *   RATE_CTRL选择16/24-bit角速度输出 (复位为24-bit); DSP_CTL1~3只保存 (可回读),
+ *   不模拟内部滤波
+ * 
+ * 总线上最多XV7_MODEL_MAX_DEVICES个设备 (设备i对应固件片选i, 见hal_stub.c),
+ * 各自有寄存器、状态与样本源; 装配位图之外的设备不驱动MISO (读为0xFF).
+ * 角速度与温度由可替换的样本源提供, 默认静止、25°C. 角速度输出叠加1~2 LSB的
+ * 交替抖动 (16-bit输出为0~1 LSB): 真实器件输出总带噪声, 恒定输入时不应被驱动
+ * 判为全0或输出冻结.
+ * 
+ * 故障注入 (Xv7Model_Inject): 持续或按次数生效, 用于验证驱动的故障检测.
+ * 时序参数 (唤醒时间等) 为模型假设值, 非数据手册值.
+ *============================================================================*/
+#define XV7_MODEL_WAKE_MS           80      /* SLEEP_OUT后到PROC_OK置位的时间 */
+#define XV7_MODEL_RAW_MAX           8388607 /* 24-bit输出饱和值 */
+#define XV7_MODEL_UPDATE_S          0.001   /* 输出寄存器内部更新周期 (周期内重读得同一样本) */
+#define XV7_MODEL_MAX_DEVICES       4
+#define XV7_MODEL_JUMP_DPS          100.0   /* JUMP故障叠加的角速度 (饱和) */
+
+/* 注入的故障 */
+#define XV7_MODEL_FAULT_NONE        0
+#define XV7_MODEL_FAULT_ONES        1       /* MISO悬空: 读为0xFF, 设备收不到命令 (断开) */
+#define XV7_MODEL_FAULT_ZEROS       2       /* MISO短路到地: 读为0x00 */
+#define XV7_MODEL_FAULT_STUCK       3       /* 角速度输出冻结在故障开始时的值 */
+#define XV7_MODEL_FAULT_JUMP        4       /* 角速度读数叠加XV7_MODEL_JUMP_DPS */
+#define XV7_MODEL_FAULT_SPI         5       /* SPI传输超时 (HAL返回HAL_TIMEOUT) */
+
+/* 样本源: 在时刻t(秒)的真实角速度与温度 */
+typedef struct {
+    double (*rate_dps)(void *ctx, double t);
+    float (*temp_c)(void *ctx, double t);
+    void *ctx;
+} Xv7Model_Source;
+
+/* 模型统计 */
+typedef struct {
+    uint32_t transactions;      /* 完整事务数 (片选低→高, 全部设备) */
+    uint32_t rate_reads;
+    uint32_t temp_reads;
+    uint32_t status_reads;
+    uint32_t writes;
+    uint32_t protocol_errors;   /* 无片选或多个片选有效时的传输等 */
+} Xv7Model_Stats;
+
+/**
+ * @brief 上电复位全部设备 (状态AFTER_POR, 寄存器清零, 清除注入的故障;
+ *        装配位图与样本源保持)
+ */
+void Xv7Model_Reset(void);
+
+/**
+ * @brief 设置全部设备的样本源, NULL=恢复默认
+ */
+void Xv7Model_SetSource(const Xv7Model_Source *source);
+
+/**
+ * @brief 设置一个设备的样本源, NULL=恢复默认
+ */
+void Xv7Model_SetDeviceSource(int index, const Xv7Model_Source *source);
+
+/**
+ * @brief 设置装配位图 (bit i=设备i存在, 默认0x01)
+ */
+void Xv7Model_SetFitted(uint8_t mask);
+
+/**
+ * @brief 装配位图 (主机构建的固件以此作为传感器装配位图)
+ */
+uint8_t Xv7Model_FittedMask(void);
+
+/**
+ * @brief 注入故障
+ * @param fault XV7_MODEL_FAULT_*, NONE=清除
+ * @param count 受影响的次数 (ONES/ZEROS/SPI为事务数, STUCK/JUMP为角速度读取数), 0=持续
+ */
+void Xv7Model_Inject(int index, uint8_t fault, uint32_t count);
+
+/**
+ * @brief 当前选中的设备是否注入了SPI超时 (HAL替身据此返回HAL_TIMEOUT)
+ */
+bool Xv7Model_BusFault(void);
+
+/**
+ * @brief 片选电平变化
+ * @param index 设备序号
+ * @param selected true=片选低 (选中)
+ */
+void Xv7Model_Select(int index, bool selected);
+
+/**
+ * @brief 交换一个字节
+ * @param mosi 主机发出的字节
+ * @return 设备返回的字节
+ */
+uint8_t Xv7Model_Transfer(uint8_t mosi);
+
+/**
+ * @brief 读取寄存器当前值 (测试用)
+ */
+uint8_t Xv7Model_PeekReg(int index, uint8_t reg);
+
+/**
+ * @brief 获取统计
+ */
+void Xv7Model_GetStats(Xv7Model_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __XV7001BB_MODEL_H */
@@ -0,0 +1,227 @@
+#include "xvlog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*============================================================================
+ * xvlog_replay: 以固件的GyroPipeline离线回放采集记录
+ * 
+ * 用法: xvlog_replay [-csv 输出.csv] [-every N] 记录.xvl
+ *   -csv   每N个样本输出一行: 时间s, 角度°, 校正后角速度°/s, 零偏°/s, 阶段
+ *   -every CSV抽取间隔 (默认1)
+ * 
+ * 记录文件以mmap顺序读取, 已处理的部分及时释放, 多天的记录也只占用
+ * 固定内存. 同一记录多次回放的输出 (含状态哈希) 逐位一致.
+ *============================================================================*/
+#define REPLAY_RELEASE_BYTES    (64u << 20)     /* 每处理64MB释放一次已读页 */
+
+/* 回放统计 */
+typedef struct {
+    uint64_t records;
+    uint64_t samples;
+    uint64_t commands;
+    uint64_t gaps;              /* 序号不连续次数 */
+    uint64_t lost;              /* 按序号估计的丢失记录数 */
+    uint64_t hash;              /* 每个样本后流水线输出的FNV-1a哈希 */
+} Replay_Stats;
+
+/**
+ * @brief FNV-1a累加一个32-bit值
+ */
+static uint64_t Replay_Hash(uint64_t hash, const void *value)
+{
+    const uint8_t *p = (const uint8_t *)value;
+    
+    for (int i = 0; i < 4; i++)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    const char *csv_path = NULL;
+    uint64_t every = 1;
+    FILE *csv = NULL;
+    
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-csv") == 0 && i + 1 < argc)
+        {
+            csv_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-every") == 0 && i + 1 < argc)
+        {
+            every = strtoull(argv[++i], NULL, 0);
+            if (every == 0)
+            {
+                every = 1;
+            }
+        }
+        else if (argv[i][0] != '-' && path == NULL)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            path = NULL;
+            break;
+        }
+    }
+    if (path == NULL)
+    {
+        fprintf(stderr, "usage: %s [-csv out.csv] [-every N] capture.xvl\n", argv[0]);
+        return 2;
+    }
+    
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(XvLog_FileHeader))
+    {
+        fprintf(stderr, "cannot read %s\n", path);
+        return 2;
+    }
+    
+    size_t size = (size_t)st.st_size;
+    const uint8_t *base = (const uint8_t *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED)
+    {
+        fprintf(stderr, "cannot map %s\n", path);
+        return 2;
+    }
+    madvise((void *)base, size, MADV_SEQUENTIAL);
+    
+    XvLog_FileHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, XVLOG_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != XVLOG_VERSION || header.record_size != XVLOG_RECORD_SIZE)
+    {
+        fprintf(stderr, "%s: not a version %d capture\n", path, XVLOG_VERSION);
+        return 2;
+    }
+    double period_s = (header.period_ms ? header.period_ms : 10) * 1e-3;
+    
+    if (csv_path != NULL)
+    {
+        if ((csv = fopen(csv_path, "w")) == NULL)
+        {
+            fprintf(stderr, "cannot write %s\n", csv_path);
+            return 2;
+        }
+        fprintf(csv, "t_s,angle_deg,rate_dps,bias_dps,phase\n");
+    }
+    
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    
+    GyroPipeline pipe;
+    GyroPipeline_Sample sample;
+    Replay_Stats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.hash = 0xCBF29CE484222325ULL;
+    GyroPipeline_Init(&pipe);
+    
+    size_t offset = sizeof(XvLog_FileHeader);
+    size_t released = 0;
+    uint8_t expected_seq = 0;
+    uint32_t state[GYRO_PIPELINE_STATE_WORDS];
+    uint32_t state_mask = 0;
+    
+    for (; offset + XVLOG_RECORD_SIZE <= size; offset += XVLOG_RECORD_SIZE)
+    {
+        const uint8_t *rec = base + offset;
+        uint8_t seq = XvLog_Seq(rec);
+        
+        if (stats.records > 0 && seq != expected_seq)
+        {
+            stats.gaps++;
+            stats.lost += (uint8_t)(seq - expected_seq) & XVLOG_SEQ_MASK;
+        }
+        expected_seq = (uint8_t)((seq + 1) & XVLOG_SEQ_MASK);
+        stats.records++;
+        
+        if (XvLog_Type(rec) == XVLOG_TYPE_COMMAND)
+        {
+            XvLog_ApplyCommand(&pipe, rec);
+            stats.commands++;
+            continue;
+        }
+        if (XvLog_Type(rec) == XVLOG_TYPE_STATE)
+        {
+            /* 一组状态字收齐后整体恢复, 中间丢失则忽略该组 */
+            if (rec[1] < GYRO_PIPELINE_STATE_WORDS)
+            {
+                state[rec[1]] = XvLog_CommandArg(rec);
+                state_mask = (rec[1] == 0) ? 1u : state_mask | (1u << rec[1]);
+                if (state_mask == (1u << GYRO_PIPELINE_STATE_WORDS) - 1)
+                {
+                    GyroPipeline_LoadState(&pipe, state);
+                }
+            }
+            continue;
+        }
+        if (XvLog_Type(rec) != XVLOG_TYPE_SAMPLE)
+        {
+            continue;
+        }
+        
+        XvLog_DecodeSample(rec, &sample);
+        GyroPipeline_Step(&pipe, &sample);
+        stats.samples++;
+        stats.hash = Replay_Hash(stats.hash, &pipe.angle);
+        stats.hash = Replay_Hash(stats.hash, &pipe.gyro_bias);
+        
+        if (csv != NULL && stats.samples % every == 0)
+        {
+            fprintf(csv, "%.2f,%.6f,%.6f,%.6f,%d\n", (double)stats.samples * period_s, (double)pipe.angle,
+                    (double)pipe.corrected_dps, (double)pipe.gyro_bias, (int)pipe.phase);
+        }
+        
+        /* 释放已处理的页, 保持常驻内存不随文件增长 */
+        if (offset - released >= REPLAY_RELEASE_BYTES)
+        {
+            size_t page = (size_t)sysconf(_SC_PAGESIZE);
+            size_t end = offset & ~(page - 1);
+            madvise((void *)(base + released), end - released, MADV_DONTNEED);
+            released = end;
+        }
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double real_s = (double)(t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    double log_s = (double)stats.samples * period_s;
+    uint32_t angle_bits;
+    memcpy(&angle_bits, &pipe.angle, sizeof(float));
+    
+    printf("records        %llu\n", (unsigned long long)stats.records);
+    printf("samples        %llu\n", (unsigned long long)stats.samples);
+    printf("commands       %llu\n", (unsigned long long)stats.commands);
+    printf("gaps           %llu (lost %llu)\n", (unsigned long long)stats.gaps, (unsigned long long)stats.lost);
+    if (offset != size)
+    {
+        printf("trailing_bytes %zu\n", size - offset);
+    }
+    printf("log_time_s     %.2f\n", log_s);
+    printf("real_time_s    %.3f (x%.0f)\n", real_s, real_s > 0 ? log_s / real_s : 0.0);
+    printf("samples_per_s  %.0f\n", real_s > 0 ? (double)stats.samples / real_s : 0.0);
+    printf("angle_deg      %.6f (0x%08X)\n", (double)pipe.angle, angle_bits);
+    printf("bias_dps       %.6f\n", (double)pipe.gyro_bias);
+    printf("bias_ready     %d\n", (int)pipe.bias_ready);
+    printf("state_hash     %016llx\n", (unsigned long long)stats.hash);
+    
+    if (csv != NULL)
+    {
+        fclose(csv);
+    }
+    munmap((void *)base, size);
+    close(fd);
+    return 0;
+}
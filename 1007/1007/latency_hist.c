@@ -0,0 +1,201 @@
+#include "latency_hist.h"
+#include "stm32f1xx_hal.h"
+#include "ramfunc.h"
+#include <string.h>
+
+/*============================================================================
+ * 直方图
+ *============================================================================*/
+
+void LatencyHist_Init(LatencyHist *hist, uint32_t base, uint32_t width)
+{
+    hist->base = base;
+    hist->width = (width > 0) ? width : 1;
+    LatencyHist_Reset(hist);
+}
+
+void LatencyHist_Reset(LatencyHist *hist)
+{
+    hist->count = 0;
+    hist->min = 0xFFFFFFFFu;
+    hist->max = 0;
+    hist->sum = 0;
+    memset(hist->buckets, 0, sizeof(hist->buckets));
+}
+
+RAMFUNC void LatencyHist_Add(LatencyHist *hist, uint32_t value)
+{
+    uint32_t index = (value > hist->base) ? (value - hist->base) / hist->width : 0;
+
+    if (index >= LATENCY_HIST_BUCKETS)
+    {
+        index = LATENCY_HIST_BUCKETS - 1;
+    }
+    hist->buckets[index]++;
+    hist->count++;
+    hist->sum += value;
+    if (value < hist->min)
+    {
+        hist->min = value;
+    }
+    if (value > hist->max)
+    {
+        hist->max = value;
+    }
+}
+
+uint32_t LatencyHist_Percentile(const LatencyHist *hist, uint32_t permille)
+{
+    uint64_t target = ((uint64_t)hist->count * permille + 999U) / 1000U;
+    uint64_t seen = 0;
+
+    if (hist->count == 0)
+    {
+        return 0;
+    }
+    for (uint32_t i = 0; i < LATENCY_HIST_BUCKETS - 1; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen >= target)
+        {
+            uint32_t upper = hist->base + (i + 1) * hist->width;
+            return (upper < hist->max) ? upper : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+uint32_t LatencyHist_Mean(const LatencyHist *hist)
+{
+    return (hist->count > 0) ? (uint32_t)(hist->sum / hist->count) : 0;
+}
+
+/*============================================================================
+ * 固件分段统计
+ *============================================================================*/
+
+/* 默认桶宽 (µs), 超出16桶范围的样本计入末桶 */
+static const uint16_t s_default_width[LATENCY_STAGE_COUNT] = {
+    10,         /* capture→integrate: SPI读出后的流水线处理, 数十µs */
+    1000,       /* integrate→publish: 发送任务10ms轮询 */
+    100,        /* publish→ack: 500kbps下8字节帧约250µs, 加邮箱排队 */
+    1000,       /* capture→ack */
+    2000,       /* fault→flag: 连续3个采样周期无效 (约20ms) */
+};
+
+static LatencyHist s_hist[LATENCY_STAGE_COUNT];
+
+/* 导出状态 (仅由发送任务访问) */
+static int s_dump_stage = -1;                  /* -1=未在导出 */
+static uint8_t s_dump_page;
+static LatencyHist s_dump_snapshot;            /* 当前分段的快照 */
+
+static void Latency_Put16(uint8_t *dst, uint32_t value)
+{
+    if (value > 0xFFFF)
+    {
+        value = 0xFFFF;
+    }
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+static void Latency_Put24(uint8_t *dst, uint32_t value)
+{
+    if (value > 0xFFFFFF)
+    {
+        value = 0xFFFFFF;
+    }
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)((value >> 8) & 0xFF);
+    dst[2] = (uint8_t)(value >> 16);
+}
+
+void Latency_Init(void)
+{
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++)
+    {
+        LatencyHist_Init(&s_hist[i], 0, s_default_width[i]);
+    }
+}
+
+RAMFUNC void Latency_Record(uint8_t stage, uint32_t cycles)
+{
+    if (stage < LATENCY_STAGE_COUNT)
+    {
+        LatencyHist_Add(&s_hist[stage], cycles / (SystemCoreClock / 1000000U));
+    }
+}
+
+void Latency_Reset(void)
+{
+    /* 分段2、3在中断中更新, 关中断清除 */
+    __disable_irq();
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++)
+    {
+        LatencyHist_Reset(&s_hist[i]);
+    }
+    __enable_irq();
+}
+
+void Latency_GetHist(uint8_t stage, LatencyHist *hist)
+{
+    if (stage < LATENCY_STAGE_COUNT)
+    {
+        __disable_irq();
+        *hist = s_hist[stage];
+        __enable_irq();
+    }
+}
+
+void Latency_StartDump(void)
+{
+    s_dump_stage = 0;
+    s_dump_page = 0;
+}
+
+bool Latency_NextDumpFrame(uint8_t *data)
+{
+    const LatencyHist *h = &s_dump_snapshot;
+
+    if (s_dump_stage < 0)
+    {
+        return false;
+    }
+    if (s_dump_page == 0)
+    {
+        Latency_GetHist((uint8_t)s_dump_stage, &s_dump_snapshot);
+    }
+
+    memset(data, 0, 8);
+    data[0] = (uint8_t)((s_dump_stage << 4) | s_dump_page);
+    if (s_dump_page == 0)
+    {
+        Latency_Put16(&data[1], h->width);
+        Latency_Put24(&data[3], h->count);
+        Latency_Put16(&data[6], h->max);
+    }
+    else if (s_dump_page == 1)
+    {
+        Latency_Put16(&data[1], (h->count > 0) ? h->min : 0);
+        Latency_Put16(&data[3], LatencyHist_Mean(h));
+        Latency_Put16(&data[5], LatencyHist_Percentile(h, 990));
+        data[7] = LATENCY_HIST_BUCKETS;
+    }
+    else
+    {
+        uint32_t bucket = (uint32_t)(s_dump_page - 2) * 2;
+        Latency_Put24(&data[1], h->buckets[bucket]);
+        Latency_Put24(&data[4], h->buckets[bucket + 1]);
+    }
+
+    if (++s_dump_page >= LATENCY_DUMP_PAGES)
+    {
+        s_dump_page = 0;
+        if (++s_dump_stage >= LATENCY_STAGE_COUNT)
+        {
+            s_dump_stage = -1;
+        }
+    }
+    return true;
+}
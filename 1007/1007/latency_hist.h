@@ -0,0 +1,121 @@
+#ifndef __LATENCY_HIST_H
+#define __LATENCY_HIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================
+ * 固定桶直方图 + 采样到总线确认的分段延迟统计
+ *
+ * LatencyHist: 线性等宽桶, 最后一桶兼作溢出桶, 另记最小/最大/总和.
+ * 添加样本为一次除法和几次比较 (O(1)), 不依赖硬件, 固件与主机基准测试共用;
+ * 数值单位由使用者决定 (固件为µs, bench_cycles为计时器周期).
+ *
+ * 固件中的分段 (单位µs):
+ *   0 capture→integrate   读出角速度 → 流水线处理完成          (Task_Main)
+ *   1 integrate→publish   流水线处理完成 → 角度帧提交发送邮箱   (Task_Can_Tx)
+ *   2 publish→ack         提交发送邮箱 → 发送完成中断          (CAN TX中断)
+ *   3 capture→ack         读出角速度 → 发送完成中断 (端到端)    (CAN TX中断)
+ *   4 fault→flag          首次检测到读数故障 → 传感器标记为FAILED (Task_Main)
+ * 分段2统计CAN_TransmitStamped发出的遥测帧 (角度/温度/角速度); 分段3只统计角度与角速度帧,
+ * 温度帧的采样时刻是最近一次读温度 (按调度最多早数百ms), 不代表角速度数据的端到端延迟.
+ *
+ * 导出经CAN_ID_LATENCY, 每个直方图LATENCY_DUMP_PAGES帧, [0]=分段<<4 | 页:
+ *   页0: [1-2]=桶宽(µs) [3-5]=样本数(饱和) [6-7]=最大值(µs, 饱和)
+ *   页1: [1-2]=最小值 [3-4]=平均值 [5-6]=99%分位 (桶上限, µs) [7]=桶数
+ *   页2~9: [1-3]/[4-6]=桶(2n-4)/(2n-3)的计数 (uint24, 饱和)
+ *============================================================================*/
+#define LATENCY_HIST_BUCKETS    16
+
+/* 固件分段 */
+#define LATENCY_CAPTURE_TO_INTEGRATE    0
+#define LATENCY_INTEGRATE_TO_PUBLISH    1
+#define LATENCY_PUBLISH_TO_ACK          2
+#define LATENCY_CAPTURE_TO_ACK          3
+#define LATENCY_FAULT_TO_FLAG           4
+#define LATENCY_STAGE_COUNT             5
+
+#define LATENCY_DUMP_PAGES      (2 + LATENCY_HIST_BUCKETS / 2)
+
+/* 直方图 */
+typedef struct {
+    uint32_t base;              /* 第0桶下限 */
+    uint32_t width;             /* 桶宽 */
+    uint32_t count;             /* 样本数 */
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t buckets[LATENCY_HIST_BUCKETS];
+} LatencyHist;
+
+/**
+ * @brief 初始化 (桶n覆盖[base + n*width, base + (n+1)*width), 末桶含其后全部)
+ */
+void LatencyHist_Init(LatencyHist *hist, uint32_t base, uint32_t width);
+
+/**
+ * @brief 清除样本, 保留桶配置
+ */
+void LatencyHist_Reset(LatencyHist *hist);
+
+/**
+ * @brief 添加一个样本
+ */
+void LatencyHist_Add(LatencyHist *hist, uint32_t value);
+
+/**
+ * @brief 分位数 (所在桶的上限, 落在溢出桶时为最大值)
+ * @param permille 千分位, 如990=99%
+ */
+uint32_t LatencyHist_Percentile(const LatencyHist *hist, uint32_t permille);
+
+/**
+ * @brief 平均值 (无样本时为0)
+ */
+uint32_t LatencyHist_Mean(const LatencyHist *hist);
+
+/*----------------------------------------------------------------------------
+ * 固件分段统计
+ *----------------------------------------------------------------------------*/
+
+/**
+ * @brief 按默认桶宽初始化全部分段
+ */
+void Latency_Init(void);
+
+/**
+ * @brief 记录一个分段延迟 (任务或中断中调用, 每个分段只由一处调用)
+ * @param cycles DWT周期差
+ */
+void Latency_Record(uint8_t stage, uint32_t cycles);
+
+/**
+ * @brief 清除全部分段 (任意任务调用)
+ */
+void Latency_Reset(void);
+
+/**
+ * @brief 开始导出全部分段 (快照后逐帧发送, 导出期间的新样本不影响本次导出)
+ */
+void Latency_StartDump(void);
+
+/**
+ * @brief 取下一导出帧
+ * @return true=data有效
+ */
+bool Latency_NextDumpFrame(uint8_t *data);
+
+/**
+ * @brief 获取分段快照
+ */
+void Latency_GetHist(uint8_t stage, LatencyHist *hist);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LATENCY_HIST_H */
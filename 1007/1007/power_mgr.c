@@ -0,0 +1,263 @@
+#include "power_mgr.h"
+#include "gyro_fusion.h"
+#include "timestamp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+#define POWER_REQUEST_NONE          0xFF
+
+/* CAN接收任务写, Task_Main读 */
+static volatile uint8_t s_request = POWER_REQUEST_NONE;
+static volatile uint32_t s_request_cycles;     /* 唤醒请求时刻 */
+static volatile TickType_t s_last_activity;
+static volatile TickType_t s_timeout_ticks = POWER_INACTIVITY_TIMEOUT_S * configTICK_RATE_HZ;
+
+/* Task_Main写, 其他任务读 */
+static volatile uint8_t s_state = POWER_STATE_ACTIVE;
+static volatile uint8_t s_flags;
+static volatile uint32_t s_wake_last_cycles;
+static volatile uint32_t s_wake_worst_cycles;
+
+/* 以下仅由Task_Main访问 */
+static uint32_t s_wake_start_cycles;
+static TickType_t s_wake_sent_tick;             /* 最近一次发送唤醒命令的节拍 */
+
+/* 睡眠统计 (空闲任务关中断更新, 发送任务在临界区内读取) */
+static uint32_t s_sleep_cycles;                 /* 当前窗口累计睡眠周期 */
+static uint32_t s_window_start;                 /* 当前窗口开始的周期计数 */
+
+#if configUSE_TICKLESS_IDLE && !defined(HOST_BUILD)
+static uint32_t s_pre_systick;                  /* 睡眠前SysTick计数值 */
+static uint32_t s_pre_cycles;                   /* 睡眠前DWT计数值 */
+#endif
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+static void PowerMgr_Put16(uint8_t *dst, uint32_t value)
+{
+    if (value > 0xFFFF)
+    {
+        value = 0xFFFF;
+    }
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief 发送传感器唤醒命令
+ */
+static void PowerMgr_SendWake(void)
+{
+    GyroSensors_Wake();
+    s_wake_sent_tick = xTaskGetTickCount();
+}
+
+/**
+ * @brief 唤醒中: 查询各传感器状态, 全部就绪时记录唤醒延迟
+ * 超时后未就绪的传感器标记为失效, 其余传感器继续工作
+ */
+static void PowerMgr_PollWake(void)
+{
+    bool ready = (GyroSensors_PollReady() == XV7_OK);
+    bool timeout = (xTaskGetTickCount() - s_wake_sent_tick) >= pdMS_TO_TICKS(POWER_WAKE_TIMEOUT_MS);
+
+    if (!ready && timeout)
+    {
+        taskENTER_CRITICAL();
+        s_flags |= POWER_FLAG_WAKE_TIMEOUT;
+        taskEXIT_CRITICAL();
+        ready = (GyroSensors_DropUnready() > 0);
+        if (!ready)
+        {
+            PowerMgr_SendWake();
+        }
+    }
+
+    if (ready)
+    {
+        uint32_t latency = Timestamp_Now() - s_wake_start_cycles;
+
+        taskENTER_CRITICAL();
+        s_wake_last_cycles = latency;
+        if (latency > s_wake_worst_cycles)
+        {
+            s_wake_worst_cycles = latency;
+        }
+        s_state = POWER_STATE_ACTIVE;
+        taskEXIT_CRITICAL();
+    }
+}
+
+/*============================================================================
+ * 公共函数
+ *============================================================================*/
+
+void PowerMgr_Init(void)
+{
+    s_last_activity = xTaskGetTickCount();
+    s_window_start = Timestamp_Now();
+#if configUSE_TICKLESS_IDLE && !defined(HOST_BUILD)
+    s_flags |= POWER_FLAG_TICKLESS;
+#endif
+}
+
+void PowerMgr_Request(uint8_t state)
+{
+    taskENTER_CRITICAL();
+    if (state == POWER_STATE_ACTIVE)
+    {
+        s_request_cycles = Timestamp_Now();
+    }
+    s_request = state;
+    s_flags &= (uint8_t)~POWER_FLAG_AUTO_WAKE;
+    taskEXIT_CRITICAL();
+}
+
+void PowerMgr_SetInactivityTimeout(uint32_t seconds)
+{
+    if (seconds > POWER_INACTIVITY_TIMEOUT_MAX_S)
+    {
+        seconds = POWER_INACTIVITY_TIMEOUT_MAX_S;
+    }
+    // 直接换算为节拍: pdMS_TO_TICKS(秒*1000)在约71分钟以上溢出32位
+    s_timeout_ticks = (TickType_t)(seconds * configTICK_RATE_HZ);
+    s_last_activity = xTaskGetTickCount();
+}
+
+void PowerMgr_NotifyActivity(void)
+{
+    s_last_activity = xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+    if ((s_flags & POWER_FLAG_AUTO_WAKE) && s_request == POWER_REQUEST_NONE)
+    {
+        s_request_cycles = Timestamp_Now();
+        s_request = POWER_STATE_ACTIVE;
+        s_flags &= (uint8_t)~POWER_FLAG_AUTO_WAKE;
+    }
+    taskEXIT_CRITICAL();
+}
+
+bool PowerMgr_Step(void)
+{
+    uint8_t request;
+    uint32_t request_cycles;
+
+    taskENTER_CRITICAL();
+    request = s_request;
+    request_cycles = s_request_cycles;
+    s_request = POWER_REQUEST_NONE;
+    taskEXIT_CRITICAL();
+
+    // 无总线活动超时: 自动待机, 收到任意帧唤醒
+    if (request == POWER_REQUEST_NONE && s_state == POWER_STATE_ACTIVE && s_timeout_ticks != 0 &&
+        (xTaskGetTickCount() - s_last_activity) >= s_timeout_ticks)
+    {
+        request = POWER_STATE_STANDBY;
+        taskENTER_CRITICAL();
+        s_flags |= POWER_FLAG_AUTO_WAKE;
+        taskEXIT_CRITICAL();
+    }
+
+    if (request == POWER_STATE_STANDBY || request == POWER_STATE_SLEEP)
+    {
+        GyroSensors_Command((request == POWER_STATE_STANDBY) ? XV7_REG_STANDBY : XV7_REG_SLEEP_IN, 0x00);
+        s_state = request;
+    }
+    else if (request == POWER_STATE_ACTIVE && s_state != POWER_STATE_ACTIVE)
+    {
+        if (s_state != POWER_STATE_WAKING)
+        {
+            s_wake_start_cycles = request_cycles;
+            s_state = POWER_STATE_WAKING;
+            PowerMgr_SendWake();
+        }
+    }
+
+    if (s_state == POWER_STATE_WAKING)
+    {
+        PowerMgr_PollWake();
+    }
+    return s_state == POWER_STATE_ACTIVE;
+}
+
+bool PowerMgr_IsActive(void)
+{
+    return s_state == POWER_STATE_ACTIVE;
+}
+
+void PowerMgr_Encode(uint8_t *data)
+{
+    uint32_t now = Timestamp_Now();
+
+    taskENTER_CRITICAL();
+    uint32_t sleep = s_sleep_cycles;
+    uint32_t window = now - s_window_start;
+    uint32_t wake_last = s_wake_last_cycles;
+    uint32_t wake_worst = s_wake_worst_cycles;
+    s_sleep_cycles = 0;
+    s_window_start = now;
+    taskEXIT_CRITICAL();
+
+    data[0] = s_state;
+    data[1] = s_flags;
+    PowerMgr_Put16(&data[2], Timestamp_CyclesToUs(wake_last) / 100U);
+    PowerMgr_Put16(&data[4], Timestamp_CyclesToUs(wake_worst) / 100U);
+    PowerMgr_Put16(&data[6], (window > 0) ? (uint32_t)(((uint64_t)sleep * 10000U) / window) : 0);
+}
+
+/*============================================================================
+ * tickless睡眠钩子
+ *============================================================================*/
+
+void PowerMgr_PreSleep(uint32_t *idle_ticks)
+{
+#if configUSE_TICKLESS_IDLE && !defined(HOST_BUILD)
+    s_pre_systick = SysTick->VAL;
+    s_pre_cycles = DWT->CYCCNT;
+#endif
+    (void)idle_ticks;
+}
+
+void PowerMgr_PostSleep(uint32_t expected_ticks)
+{
+    (void)expected_ticks;
+#if configUSE_TICKLESS_IDLE && !defined(HOST_BUILD)
+    uint32_t systick = SysTick->VAL;
+    uint32_t cycles = DWT->CYCCNT - s_pre_cycles;
+    uint32_t elapsed;
+
+    // SysTick以内核时钟递减, 睡眠期间照常计数; 到期唤醒时已重装一次 (中断挂起)
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        elapsed = s_pre_systick + (SysTick->LOAD + 1U - systick);
+    }
+    else
+    {
+        elapsed = s_pre_systick - systick;
+    }
+
+    // 睡眠模式下内核时钟停止, DWT不计数: 补上差额
+    if (elapsed > cycles)
+    {
+        DWT->CYCCNT += elapsed - cycles;
+    }
+    s_sleep_cycles += elapsed;
+#endif
+}
+
+void PowerMgr_StepTick(uint32_t ticks)
+{
+#if configUSE_TICKLESS_IDLE && !defined(HOST_BUILD)
+    // 内核跳过的节拍不经过节拍钩子 (HAL_IncTick), 同样补给HAL时基; uwTick本身
+    // 由节拍钩子驱动, 调度器挂起时照常递增, HAL超时与HAL_Delay在挂起期间仍有效
+    uwTick += ticks;
+#else
+    (void)ticks;
+#endif
+}
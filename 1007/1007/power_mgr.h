@@ -0,0 +1,105 @@
+#ifndef __POWER_MGR_H
+#define __POWER_MGR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================
+ * 功耗管理 (MCU tickless睡眠 + 传感器待机/睡眠)
+ *
+ * MCU: configUSE_TICKLESS_IDLE=1, 空闲时由内核停止节拍并执行WFI (睡眠模式),
+ * 由下一个任务唤醒时刻或任意中断唤醒. 睡眠前后钩子补偿睡眠期间停止计数的
+ * DWT周期计数器 (按SysTick计数, 每次误差数个周期), 并把内核跳过的节拍补给
+ * HAL时基uwTick (traceINCREASE_TICK_COUNT). HAL_GetTick仍返回uwTick: 它由节拍
+ * 钩子递增, 调度器挂起 (vTaskSuspendAll) 期间不停止, 内核节拍计数则会停止.
+ *
+ * 传感器: 由Task_Main执行状态切换 (SPI只在该任务中访问):
+ *   ACTIVE  正常采样
+ *   STANDBY 写XV7_REG_STANDBY, 不采样
+ *   SLEEP   写XV7_REG_SLEEP_IN, 功耗最低, 唤醒较慢
+ *   WAKING  已写XV7_REG_SLEEP_OUT, 每周期查询状态寄存器直到就绪;
+ *           超过POWER_WAKE_TIMEOUT_MS未就绪则重发唤醒命令
+ * 唤醒延迟 = 唤醒请求 (命令或总线活动) 到第一个有效采样.
+ * 待机期间不积分, 角度保持进入待机时的值.
+ *
+ * 超过设定时间没有收到CAN帧时自动进入STANDBY, 此后收到任意帧自动唤醒;
+ * 命令进入的待机/睡眠只由唤醒命令退出.
+ *
+ * 状态经CAN_ID_POWER每秒发送:
+ *   [0]=状态 [1]=标志 [2-3]=最近唤醒延迟(0.1ms) [4-5]=最长唤醒延迟(0.1ms)
+ *   [6-7]=最近窗口MCU睡眠时间占比(0.01%)
+ *============================================================================*/
+#define POWER_INACTIVITY_TIMEOUT_S  0       /* 默认无总线活动自动待机时间 (s), 0=不自动待机 */
+#define POWER_INACTIVITY_TIMEOUT_MAX_S 65535U /* 上限 (命令字段uint16), 超出按上限 */
+#define POWER_WAKE_TIMEOUT_MS       500     /* 唤醒命令后等待就绪的时间 */
+
+/* 状态 */
+#define POWER_STATE_ACTIVE          0
+#define POWER_STATE_STANDBY         1
+#define POWER_STATE_SLEEP           2
+#define POWER_STATE_WAKING          3
+
+/* 标志 */
+#define POWER_FLAG_TICKLESS         0x01    /* MCU tickless睡眠已启用 */
+#define POWER_FLAG_AUTO_WAKE        0x02    /* 因无总线活动进入待机, 收到任意帧唤醒 */
+#define POWER_FLAG_WAKE_TIMEOUT     0x04    /* 曾经唤醒超时 (已重发唤醒命令) */
+
+/**
+ * @brief 初始化 (调度器启动前调用)
+ */
+void PowerMgr_Init(void);
+
+/**
+ * @brief 请求传感器状态 (CAN接收任务调用, 由Task_Main下一周期执行)
+ * @param state POWER_STATE_ACTIVE=唤醒, POWER_STATE_STANDBY/POWER_STATE_SLEEP=进入
+ */
+void PowerMgr_Request(uint8_t state);
+
+/**
+ * @brief 设置无总线活动自动待机时间 (s), 0=不自动待机, 超过POWER_INACTIVITY_TIMEOUT_MAX_S按上限
+ */
+void PowerMgr_SetInactivityTimeout(uint32_t seconds);
+
+/**
+ * @brief 收到CAN帧 (CAN接收任务调用): 刷新活动时刻, 自动待机时唤醒
+ */
+void PowerMgr_NotifyActivity(void);
+
+/**
+ * @brief 执行待处理的状态切换并推进唤醒 (Task_Main每周期采样前调用)
+ * @return true=传感器就绪, 本周期正常采样
+ */
+bool PowerMgr_Step(void);
+
+/**
+ * @brief 传感器是否处于正常采样状态
+ */
+bool PowerMgr_IsActive(void);
+
+/**
+ * @brief 打包8字节状态帧并开始新的睡眠统计窗口 (发送任务调用)
+ */
+void PowerMgr_Encode(uint8_t *data);
+
+/**
+ * @brief tickless睡眠前后钩子 (FreeRTOSConfig.h中configPRE/POST_SLEEP_PROCESSING, 关中断调用)
+ * @param idle_ticks 预计空闲节拍数, 置0则本次不睡眠
+ */
+void PowerMgr_PreSleep(uint32_t *idle_ticks);
+void PowerMgr_PostSleep(uint32_t expected_ticks);
+
+/**
+ * @brief 内核在tickless睡眠后补记节拍时调用 (traceINCREASE_TICK_COUNT, 关中断)
+ * @param ticks 跳过的节拍数
+ */
+void PowerMgr_StepTick(uint32_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __POWER_MGR_H */
@@ -0,0 +1,28 @@
+#include "ramfunc.h"
+#include "stm32f1xx_hal.h"
+#include <string.h>
+
+#if RAMFUNC_ENABLE && !defined(HOST_BUILD)
+/* 链接脚本定义: 运行地址范围与加载地址 */
+extern uint8_t _sramfunc[];
+extern uint8_t _eramfunc[];
+extern const uint8_t _siramfunc[];
+#endif
+
+void RamFunc_Init(void)
+{
+#if RAMFUNC_ENABLE && !defined(HOST_BUILD)
+    memcpy(_sramfunc, _siramfunc, (size_t)(_eramfunc - _sramfunc));
+    __DSB();
+    __ISB();                                        /* 复制完成后再取指 */
+#endif
+}
+
+uint32_t RamFunc_Size(void)
+{
+#if RAMFUNC_ENABLE && !defined(HOST_BUILD)
+    return (uint32_t)(_eramfunc - _sramfunc);
+#else
+    return 0;
+#endif
+}
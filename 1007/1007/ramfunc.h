@@ -0,0 +1,48 @@
+#ifndef __RAMFUNC_H
+#define __RAMFUNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*============================================================================
+ * SRAM常驻热路径代码
+ *
+ * 72MHz下Flash为2等待周期, 预取缓冲只覆盖顺序取指, 跳转与中断入口仍要等待.
+ * 以RAMFUNC标记的函数放入.ramfunc段 (STM32F103C8_ramfunc.lds), 链接在SRAM开头,
+ * 加载地址紧随中断向量表, 由RamFunc_Init在main开始时复制. 链接脚本另把
+ * HAL的SPI收发/CAN发送与中断、libgcc软件浮点的单精度运算放入同一段.
+ *
+ * 段大小受RAMFUNC区域 (RAMFUNC_BUDGET) 限制, 超出时链接失败;
+ * 链接时--print-memory-usage打印RAMFUNC区域占用.
+ *
+ * 注意: F103从SRAM取指经系统总线, 与数据访问共用, 访存密集的代码未必更快;
+ * 以CYCLE_BENCH=1分别构建RAMFUNC_ENABLE=1/0两个版本对比 (见手册4.4).
+ *============================================================================*/
+#ifndef RAMFUNC_ENABLE
+#define RAMFUNC_ENABLE      1       /* 0=全部代码在Flash执行 (需同时改回BSP默认链接脚本) */
+#endif
+
+#if RAMFUNC_ENABLE && !defined(HOST_BUILD)
+#define RAMFUNC             __attribute__((section(".ramfunc"), noinline))
+#else
+#define RAMFUNC
+#endif
+
+/**
+ * @brief 将.ramfunc段从Flash复制到SRAM (main开始时, 调用任何RAMFUNC之前)
+ */
+void RamFunc_Init(void);
+
+/**
+ * @brief SRAM常驻代码字节数 (RAMFUNC_ENABLE=0或主机构建为0)
+ */
+uint32_t RamFunc_Size(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RAMFUNC_H */
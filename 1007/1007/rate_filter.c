@@ -0,0 +1,269 @@
+#include "rate_filter.h"
+#include "gyro_pipeline.h"
+#include "ramfunc.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+#include <math.h>
+
+#define RATE_FILTER_ONE             (1L << RATE_FILTER_COEF_SHIFT)
+#define RATE_FILTER_DATA_SCALE      ((float)(1L << RATE_FILTER_DATA_SHIFT))
+#define RATE_FILTER_DATA_LIMIT      32767.0f
+
+/*============================================================================
+ * 二阶节
+ *============================================================================*/
+
+static int32_t Biquad_ToQ29(float value)
+{
+    return (int32_t)lrintf(value * (float)RATE_FILTER_ONE);
+}
+
+uint8_t Biquad_Design(int32_t *coef, uint8_t type, float freq_hz, float q, float sample_rate_hz)
+{
+    if ((type != RATE_FILTER_LOWPASS && type != RATE_FILTER_NOTCH) ||
+        !(freq_hz > 0.0f) || !(freq_hz < sample_rate_hz * 0.5f) || !(q > 0.0f))
+    {
+        return RATE_FILTER_ERR_PARAM;
+    }
+
+    float w0 = 2.0f * 3.14159265f * freq_hz / sample_rate_hz;
+    float cw = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+
+    if (type == RATE_FILTER_LOWPASS)
+    {
+        coef[RATE_FILTER_B0] = Biquad_ToQ29((1.0f - cw) * 0.5f / a0);
+        coef[RATE_FILTER_B1] = Biquad_ToQ29((1.0f - cw) / a0);
+        coef[RATE_FILTER_B2] = coef[RATE_FILTER_B0];
+    }
+    else
+    {
+        coef[RATE_FILTER_B0] = Biquad_ToQ29(1.0f / a0);
+        coef[RATE_FILTER_B1] = Biquad_ToQ29(-2.0f * cw / a0);
+        coef[RATE_FILTER_B2] = coef[RATE_FILTER_B0];
+    }
+    coef[RATE_FILTER_A1] = Biquad_ToQ29(-2.0f * cw / a0);
+    coef[RATE_FILTER_A2] = Biquad_ToQ29((1.0f - alpha) / a0);
+    return RATE_FILTER_OK;
+}
+
+bool Biquad_IsStable(const int32_t *coef)
+{
+    int64_t a1 = coef[RATE_FILTER_A1];
+    int64_t a2 = coef[RATE_FILTER_A2];
+
+    return a2 < RATE_FILTER_ONE && a2 > -RATE_FILTER_ONE &&
+           (a1 < 0 ? -a1 : a1) < RATE_FILTER_ONE + a2;
+}
+
+void BiquadCascade_Init(BiquadCascade *f)
+{
+    memset(f, 0, sizeof(BiquadCascade));
+}
+
+void BiquadCascade_SetSection(BiquadCascade *f, uint8_t index, const int32_t *coef)
+{
+    Biquad_Section *s = &f->sections[index];
+    int32_t in = f->last_in;
+
+    if (coef == NULL)
+    {
+        f->active &= (uint8_t)~(1U << index);
+        return;
+    }
+
+    // 该节的输入为前面最后一个启用节的输出
+    for (int i = 0; i < index; i++)
+    {
+        if (f->active & (1U << i))
+        {
+            in = f->sections[i].y1;
+        }
+    }
+    memcpy(s->coef, coef, sizeof(s->coef));
+    s->x1 = s->x2 = s->y1 = s->y2 = in;
+    f->active |= (uint8_t)(1U << index);
+}
+
+RAMFUNC int32_t BiquadCascade_Process(BiquadCascade *f, int32_t x)
+{
+    f->last_in = x;
+    for (int i = 0; i < RATE_FILTER_SECTIONS; i++)
+    {
+        if (!(f->active & (1U << i)))
+        {
+            continue;
+        }
+
+        Biquad_Section *s = &f->sections[i];
+        int64_t acc = (int64_t)s->coef[RATE_FILTER_B0] * x +
+                      (int64_t)s->coef[RATE_FILTER_B1] * s->x1 +
+                      (int64_t)s->coef[RATE_FILTER_B2] * s->x2 -
+                      (int64_t)s->coef[RATE_FILTER_A1] * s->y1 -
+                      (int64_t)s->coef[RATE_FILTER_A2] * s->y2;
+        acc = (acc + (1LL << (RATE_FILTER_COEF_SHIFT - 1))) >> RATE_FILTER_COEF_SHIFT;
+        int32_t y = (acc > INT32_MAX) ? INT32_MAX : (acc < INT32_MIN) ? INT32_MIN : (int32_t)acc;
+
+        s->x2 = s->x1;
+        s->x1 = x;
+        s->y2 = s->y1;
+        s->y1 = y;
+        x = y;
+    }
+    return x;
+}
+
+/*============================================================================
+ * 固件角速度滤波
+ *============================================================================*/
+
+/* 各节配置 (由Task_Can_Rx修改, 应答由Task_Can_Tx读取) */
+typedef struct {
+    uint8_t type;
+    uint16_t freq_centi_hz;
+    uint16_t q_milli;
+    int32_t staged[RATE_FILTER_COEFS];
+} RateFilter_Slot;
+
+static BiquadCascade s_filter;                  /* 由Task_Main运算, 修改时进入临界区 */
+static RateFilter_Slot s_slot[RATE_FILTER_SECTIONS];
+static volatile uint8_t s_result;
+static volatile int s_report_section = -1;     /* -1=未在应答 */
+
+static void RateFilter_Put16(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief 替换一节系数 (Task_Main优先级更高, 在临界区内整体替换)
+ */
+static void RateFilter_Apply(uint8_t section, const int32_t *coef)
+{
+    taskENTER_CRITICAL();
+    BiquadCascade_SetSection(&s_filter, section, coef);
+    taskEXIT_CRITICAL();
+}
+
+void RateFilter_Init(void)
+{
+    BiquadCascade_Init(&s_filter);
+    memset(s_slot, 0, sizeof(s_slot));
+    s_result = RATE_FILTER_OK;
+}
+
+RAMFUNC float RateFilter_Process(float dps)
+{
+    float clamped = (dps > RATE_FILTER_DATA_LIMIT) ? RATE_FILTER_DATA_LIMIT :
+                    (dps < -RATE_FILTER_DATA_LIMIT) ? -RATE_FILTER_DATA_LIMIT : dps;
+    int32_t y = BiquadCascade_Process(&s_filter, (int32_t)lrintf(clamped * RATE_FILTER_DATA_SCALE));
+
+    if (s_filter.active == 0)
+    {
+        return dps;
+    }
+    return (float)y / RATE_FILTER_DATA_SCALE;
+}
+
+void RateFilter_Bypass(void)
+{
+    for (uint8_t i = 0; i < RATE_FILTER_SECTIONS; i++)
+    {
+        s_slot[i].type = RATE_FILTER_OFF;
+        RateFilter_Apply(i, NULL);
+    }
+    s_result = RATE_FILTER_OK;
+}
+
+uint8_t RateFilter_Configure(uint8_t section, uint8_t type, uint16_t freq_centi_hz, uint16_t q_milli)
+{
+    int32_t coef[RATE_FILTER_COEFS];
+    uint8_t result = RATE_FILTER_ERR_PARAM;
+
+    if (section < RATE_FILTER_SECTIONS && type == RATE_FILTER_OFF)
+    {
+        s_slot[section].type = RATE_FILTER_OFF;
+        RateFilter_Apply(section, NULL);
+        result = RATE_FILTER_OK;
+    }
+    else if (section < RATE_FILTER_SECTIONS)
+    {
+        result = Biquad_Design(coef, type, freq_centi_hz * 0.01f, q_milli * 0.001f,
+                               (float)GYRO_PIPELINE_RATE_HZ);
+        if (result == RATE_FILTER_OK)
+        {
+            s_slot[section].type = type;
+            s_slot[section].freq_centi_hz = freq_centi_hz;
+            s_slot[section].q_milli = q_milli;
+            RateFilter_Apply(section, coef);
+        }
+    }
+    s_result = result;
+    return result;
+}
+
+uint8_t RateFilter_StageCoef(uint8_t section, uint8_t index, int32_t value)
+{
+    uint8_t result = RATE_FILTER_ERR_PARAM;
+
+    if (section < RATE_FILTER_SECTIONS && index < RATE_FILTER_COEFS)
+    {
+        s_slot[section].staged[index] = value;
+        result = RATE_FILTER_OK;
+    }
+    s_result = result;
+    return result;
+}
+
+uint8_t RateFilter_ApplyStaged(uint8_t section)
+{
+    uint8_t result = RATE_FILTER_ERR_PARAM;
+
+    if (section < RATE_FILTER_SECTIONS)
+    {
+        result = RATE_FILTER_ERR_UNSTABLE;
+        if (Biquad_IsStable(s_slot[section].staged))
+        {
+            s_slot[section].type = RATE_FILTER_CUSTOM;
+            s_slot[section].freq_centi_hz = 0;
+            s_slot[section].q_milli = 0;
+            RateFilter_Apply(section, s_slot[section].staged);
+            result = RATE_FILTER_OK;
+        }
+    }
+    s_result = result;
+    return result;
+}
+
+void RateFilter_StartReport(void)
+{
+    s_report_section = 0;
+}
+
+bool RateFilter_NextReportFrame(uint8_t *data)
+{
+    int section = s_report_section;
+    uint8_t enabled = 0;
+
+    if (section < 0)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < RATE_FILTER_SECTIONS; i++)
+    {
+        enabled += (s_slot[i].type != RATE_FILTER_OFF) ? 1 : 0;
+    }
+    data[0] = (uint8_t)section;
+    data[1] = s_slot[section].type;
+    RateFilter_Put16(&data[2], s_slot[section].freq_centi_hz);
+    RateFilter_Put16(&data[4], s_slot[section].q_milli);
+    data[6] = s_result;
+    data[7] = enabled;
+
+    s_report_section = (section + 1 < RATE_FILTER_SECTIONS) ? section + 1 : -1;
+    return true;
+}
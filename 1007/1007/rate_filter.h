@@ -0,0 +1,149 @@
+#ifndef __RATE_FILTER_H
+#define __RATE_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*============================================================================
+ * 角速度输出滤波 (定点二阶节级联)
+ *
+ * 只作用于发布的角速度 (g_gyro_dps, CAN_ID_GYRO_RATE): Task_Main在流水线
+ * 校正之后、发布之前调用RateFilter_Process; 积分器仍使用未滤波的角速度,
+ * 角度不受滤波相位延迟影响.
+ *
+ * 每节为直接I型二阶节:
+ *   y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2
+ * 系数为Q2.29 (范围±4), 数据为Q15.16 (°/s, 范围±32767), 乘积在int64中
+ * 累加后右移29位 (舍入并饱和). M3上每节5次SMULL/SMLAL, 无浮点运算;
+ * 浮点只在入口/出口换算各一次. 未启用任何节时直接返回输入 (无量化).
+ *
+ * 节的配置 (CAN命令0x60, 由Task_Can_Rx调用):
+ *   设计: 低通或陷波, 由中心/截止频率与Q值在片上计算 (RBJ公式, 采样率
+ *         GYRO_PIPELINE_RATE_HZ), 直流增益为1
+ *   自定义: 逐个写入系数到暂存区, 再整体生效 (检查极点在单位圆内)
+ * 修改某节时关中断整体替换系数, 并以该节当前输入预置状态 (直流增益1时无阶跃).
+ *
+ * 配置经CAN_ID_FILTER应答 (每次配置命令后及查询时, 每节一帧):
+ *   [0]=节号 [1]=类型 [2-3]=频率(0.01Hz) [4-5]=Q(0.001) [6]=最近命令结果 [7]=启用节数
+ *============================================================================*/
+#define RATE_FILTER_SECTIONS        4       /* 最大级联节数 */
+#define RATE_FILTER_COEF_SHIFT      29      /* 系数Q2.29 */
+#define RATE_FILTER_DATA_SHIFT      16      /* 数据Q15.16 (°/s) */
+
+/* 节类型 */
+#define RATE_FILTER_OFF             0       /* 直通 (不参与运算) */
+#define RATE_FILTER_LOWPASS         1
+#define RATE_FILTER_NOTCH           2
+#define RATE_FILTER_CUSTOM          3       /* 自定义系数 */
+
+/* 系数序号 */
+#define RATE_FILTER_B0              0
+#define RATE_FILTER_B1              1
+#define RATE_FILTER_B2              2
+#define RATE_FILTER_A1              3
+#define RATE_FILTER_A2              4
+#define RATE_FILTER_COEFS           5
+
+/* 配置结果 */
+#define RATE_FILTER_OK              0
+#define RATE_FILTER_ERR_PARAM       1       /* 节号/类型/频率/Q超出范围 */
+#define RATE_FILTER_ERR_UNSTABLE    2       /* 自定义系数极点不在单位圆内 */
+
+/* 一个二阶节 */
+typedef struct {
+    int32_t coef[RATE_FILTER_COEFS];    /* Q2.29 */
+    int32_t x1, x2, y1, y2;             /* Q15.16 */
+} Biquad_Section;
+
+/* 级联 (按节号顺序运算active中置位的节) */
+typedef struct {
+    uint8_t active;                     /* 启用节位掩码 */
+    int32_t last_in;                    /* 最近输入 (预置新节状态) */
+    Biquad_Section sections[RATE_FILTER_SECTIONS];
+} BiquadCascade;
+
+/**
+ * @brief 由频率与Q值计算系数 (RBJ公式, 直流增益1)
+ * @param type RATE_FILTER_LOWPASS/RATE_FILTER_NOTCH
+ * @return RATE_FILTER_OK或RATE_FILTER_ERR_PARAM (频率须在0与奈奎斯特频率之间)
+ */
+uint8_t Biquad_Design(int32_t *coef, uint8_t type, float freq_hz, float q, float sample_rate_hz);
+
+/**
+ * @brief 系数是否稳定 (a2与a1满足二阶稳定三角形)
+ */
+bool Biquad_IsStable(const int32_t *coef);
+
+/**
+ * @brief 清空级联
+ */
+void BiquadCascade_Init(BiquadCascade *f);
+
+/**
+ * @brief 设置一节 (coef为NULL时关闭)
+ * 以该节当前输入 (前级输出) 预置状态, 直流增益为1时输出无阶跃
+ */
+void BiquadCascade_SetSection(BiquadCascade *f, uint8_t index, const int32_t *coef);
+
+/**
+ * @brief 处理一个Q15.16样本
+ */
+int32_t BiquadCascade_Process(BiquadCascade *f, int32_t x);
+
+/*----------------------------------------------------------------------------
+ * 固件角速度滤波
+ *----------------------------------------------------------------------------*/
+
+/**
+ * @brief 初始化 (全部节关闭)
+ */
+void RateFilter_Init(void);
+
+/**
+ * @brief 滤波一个角速度样本 (Task_Main每个有效样本调用)
+ */
+float RateFilter_Process(float dps);
+
+/**
+ * @brief 关闭全部节
+ */
+void RateFilter_Bypass(void);
+
+/**
+ * @brief 设计并启用一节
+ * @param type RATE_FILTER_OFF关闭该节
+ * @param freq_centi_hz 截止/中心频率 (0.01Hz)
+ * @param q_milli Q值 (0.001)
+ */
+uint8_t RateFilter_Configure(uint8_t section, uint8_t type, uint16_t freq_centi_hz, uint16_t q_milli);
+
+/**
+ * @brief 写入暂存系数 (Q2.29)
+ */
+uint8_t RateFilter_StageCoef(uint8_t section, uint8_t index, int32_t value);
+
+/**
+ * @brief 以暂存系数启用一节
+ */
+uint8_t RateFilter_ApplyStaged(uint8_t section);
+
+/**
+ * @brief 开始发送配置应答
+ */
+void RateFilter_StartReport(void);
+
+/**
+ * @brief 取下一应答帧
+ * @return true=data有效
+ */
+bool RateFilter_NextReportFrame(uint8_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RATE_FILTER_H */
@@ -0,0 +1,252 @@
+#include "raw_stream.h"
+#include "can.h"
+#include "xvlog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include <string.h>
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+static QueueHandle_t s_queue = NULL;
+static StaticQueue_t s_queue_cb;
+static uint8_t s_queue_storage[RAW_STREAM_QUEUE_LEN * 8];
+static volatile bool s_active = false;
+static volatile RawStream_Mode s_mode = RAW_STREAM_MODE_RAW;
+static TickType_t s_start_tick;
+static TickType_t s_duration_ticks;            /* 0=不限时 */
+static volatile bool s_capture_start = false;  /* 采集已开始, 待输出状态记录 */
+
+/* 以下仅由采集任务访问 */
+static bool s_have_pending = false;            /* 已有半帧 */
+static int32_t s_pending_raw;
+static uint16_t s_sequence;
+static uint8_t s_record_seq;
+
+static volatile uint32_t s_frames_sent;
+static volatile uint32_t s_frames_dropped;
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+/**
+ * @brief 24-bit有符号数按小端写入3字节
+ */
+static void RawStream_Put24(uint8_t *dst, int32_t value)
+{
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)((value >> 8) & 0xFF);
+    dst[2] = (uint8_t)((value >> 16) & 0xFF);
+}
+
+/**
+ * @brief 持续时间到则自动停止
+ * @return true=仍在发送
+ */
+static bool RawStream_CheckActive(RawStream_Mode mode)
+{
+    if (!s_active || s_mode != mode || s_queue == NULL)
+    {
+        return false;
+    }
+    
+    if (s_duration_ticks != 0 && (xTaskGetTickCount() - s_start_tick) >= s_duration_ticks)
+    {
+        s_active = false;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 切换模式并开始计时 (模式改变时丢弃队列中另一模式的帧)
+ */
+static void RawStream_Begin(RawStream_Mode mode, TickType_t duration_ticks)
+{
+    if (s_queue == NULL)
+    {
+        return;
+    }
+    
+    if (s_mode != mode)
+    {
+        s_active = false;
+        xQueueReset(s_queue);
+    }
+    
+    taskENTER_CRITICAL();
+    s_start_tick = xTaskGetTickCount();
+    s_duration_ticks = duration_ticks;
+    s_mode = mode;
+    s_active = true;
+    taskEXIT_CRITICAL();
+}
+
+/*============================================================================
+ * 公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 创建帧队列
+ */
+HAL_StatusTypeDef RawStream_Init(void)
+{
+    s_queue = xQueueCreateStatic(RAW_STREAM_QUEUE_LEN, 8, s_queue_storage, &s_queue_cb);
+    return (s_queue != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief 开始流式发送
+ */
+void RawStream_Start(uint32_t duration_ms)
+{
+    if (duration_ms == 0)
+    {
+        duration_ms = RAW_STREAM_DEFAULT_DURATION_MS;
+    }
+    if (duration_ms > RAW_STREAM_MAX_DURATION_MS)
+    {
+        duration_ms = RAW_STREAM_MAX_DURATION_MS;
+    }
+    
+    RawStream_Begin(RAW_STREAM_MODE_RAW, pdMS_TO_TICKS(duration_ms));
+}
+
+/**
+ * @brief 开始采集模式
+ */
+void RawStream_StartCapture(uint32_t duration_s)
+{
+    if (duration_s > RAW_STREAM_MAX_CAPTURE_S)
+    {
+        duration_s = RAW_STREAM_MAX_CAPTURE_S;
+    }
+    
+    /* 采集中重复开启只更新持续时间, 不再输出状态记录 */
+    bool restart = !(s_active && s_mode == RAW_STREAM_MODE_CAPTURE);
+    RawStream_Begin(RAW_STREAM_MODE_CAPTURE, pdMS_TO_TICKS(duration_s * 1000U));
+    if (restart)
+    {
+        s_capture_start = true;
+    }
+}
+
+/**
+ * @brief 采集是否刚刚开始
+ */
+bool RawStream_TakeCaptureStart(void)
+{
+    bool start = s_capture_start;
+    s_capture_start = false;
+    return start;
+}
+
+/**
+ * @brief 停止流式发送
+ */
+void RawStream_Stop(void)
+{
+    s_active = false;
+    if (s_queue != NULL)
+    {
+        xQueueReset(s_queue);
+    }
+}
+
+/**
+ * @brief 提交一个原始样本
+ * 
+ * 两个样本拼成一帧后以零等待方式入队, 队列满时丢弃该帧并计数,
+ * 保证采集任务不会因CAN总线繁忙而阻塞
+ */
+void RawStream_Push(int32_t raw)
+{
+    uint8_t frame[8];
+    
+    if (!RawStream_CheckActive(RAW_STREAM_MODE_RAW))
+    {
+        s_have_pending = false;
+        return;
+    }
+    
+    if (!s_have_pending)
+    {
+        s_pending_raw = raw;
+        s_have_pending = true;
+        return;
+    }
+    
+    RawStream_Put24(&frame[0], s_pending_raw);
+    RawStream_Put24(&frame[3], raw);
+    frame[6] = (uint8_t)(s_sequence & 0xFF);
+    frame[7] = (uint8_t)(s_sequence >> 8);
+    s_sequence++;
+    s_have_pending = false;
+    
+    if (xQueueSend(s_queue, frame, 0) != pdTRUE)
+    {
+        s_frames_dropped++;
+    }
+}
+
+/**
+ * @brief 提交一条采集记录
+ * 
+ * 序号在入队前分配, 队列满丢弃的记录同样占用序号, 回放端据此统计丢失
+ */
+void RawStream_PushRecord(uint8_t *record)
+{
+    if (!RawStream_CheckActive(RAW_STREAM_MODE_CAPTURE))
+    {
+        return;
+    }
+    
+    record[0] = (uint8_t)((record[0] & ~XVLOG_SEQ_MASK) | (s_record_seq & XVLOG_SEQ_MASK));
+    s_record_seq++;
+    
+    if (xQueueSend(s_queue, record, 0) != pdTRUE)
+    {
+        s_frames_dropped++;
+    }
+}
+
+/**
+ * @brief 发送队列中的帧
+ */
+void RawStream_Drain(uint32_t max_frames)
+{
+    uint8_t frame[8];
+    uint32_t id;
+    
+    if (s_queue == NULL)
+    {
+        return;
+    }
+    
+    id = (s_mode == RAW_STREAM_MODE_CAPTURE) ? CAN_ID_CAPTURE : CAN_ID_RAW_STREAM;
+    while (max_frames-- > 0 && xQueueReceive(s_queue, frame, 0) == pdTRUE)
+    {
+        if (CAN_TransmitWithId(id, frame, 8) == HAL_OK)
+        {
+            s_frames_sent++;
+        }
+        else
+        {
+            s_frames_dropped++;
+        }
+    }
+}
+
+/**
+ * @brief 获取流状态
+ */
+void RawStream_GetStats(RawStream_Stats *stats)
+{
+    stats->active = s_active;
+    stats->mode = s_mode;
+    stats->sequence = s_sequence;
+    stats->frames_sent = s_frames_sent;
+    stats->frames_dropped = s_frames_dropped;
+}
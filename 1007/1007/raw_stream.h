@@ -0,0 +1,98 @@
+#ifndef __RAW_STREAM_H
+#define __RAW_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f1xx_hal.h"
+#include <stdbool.h>
+
+/*============================================================================
+ * 原始采样流 (诊断模式)
+ * 以采集速率发送XV7_GyroData.raw, 用于振动/噪声分析
+ * 
+ * 帧格式 (ID=CAN_ID_RAW_STREAM, DLC=8):
+ *   [0-2] 样本n   24-bit有符号, 小端
+ *   [3-5] 样本n+1 24-bit有符号, 小端
+ *   [6-7] 帧序号  uint16, 小端 (队列满丢帧时序号照常递增, 接收端据此发现丢帧)
+ * 
+ * 采集模式 (ID=CAN_ID_CAPTURE, DLC=8):
+ *   每帧一条xvlog记录 (见xvlog.h), 包含每周期的状态/角速度/温度原始值及命令,
+ *   主机保存后可离线回放. 两种模式共用帧队列, 同一时刻只有一种有效.
+ *============================================================================*/
+#define RAW_STREAM_QUEUE_LEN            16      /* 帧队列深度 (160ms@100Hz采样) */
+#define RAW_STREAM_DEFAULT_DURATION_MS  10000   /* 未指定时长时的默认值 */
+#define RAW_STREAM_MAX_DURATION_MS      60000   /* 最长持续时间, 超时自动停止 */
+#define RAW_STREAM_TX_BURST             4       /* 每次发送任务循环最多发送帧数 */
+#define RAW_STREAM_MAX_CAPTURE_S        65535   /* 采集模式最长持续时间 (秒) */
+
+/* 流模式 */
+typedef enum {
+    RAW_STREAM_MODE_RAW = 0,        /* 原始角速度样本 */
+    RAW_STREAM_MODE_CAPTURE = 1     /* xvlog采集记录 */
+} RawStream_Mode;
+
+/* 流状态 */
+typedef struct {
+    bool active;
+    RawStream_Mode mode;
+    uint16_t sequence;          /* 下一帧序号 */
+    uint32_t frames_sent;
+    uint32_t frames_dropped;    /* 队列满丢弃的帧 */
+} RawStream_Stats;
+
+/**
+ * @brief 创建帧队列 (调度器启动前调用)
+ */
+HAL_StatusTypeDef RawStream_Init(void);
+
+/**
+ * @brief 开始流式发送
+ * @param duration_ms 持续时间, 0=默认值, 超过上限时截断
+ */
+void RawStream_Start(uint32_t duration_ms);
+
+/**
+ * @brief 开始采集模式
+ * @param duration_s 持续时间 (秒), 0=直到RawStream_Stop
+ */
+void RawStream_StartCapture(uint32_t duration_s);
+
+/**
+ * @brief 停止流式发送并丢弃未发送的帧
+ */
+void RawStream_Stop(void);
+
+/**
+ * @brief 提交一个原始样本 (采集任务调用, 不阻塞)
+ */
+void RawStream_Push(int32_t raw);
+
+/**
+ * @brief 提交一条采集记录 (采集任务调用, 不阻塞, 序号由本模块填写)
+ * @param record XVLOG_RECORD_SIZE字节
+ */
+void RawStream_PushRecord(uint8_t *record);
+
+/**
+ * @brief 采集是否刚刚开始 (读取后清除, 采集任务据此输出状态记录)
+ */
+bool RawStream_TakeCaptureStart(void);
+
+/**
+ * @brief 发送队列中的帧 (CAN发送任务调用)
+ * @param max_frames 本次最多发送帧数
+ */
+void RawStream_Drain(uint32_t max_frames);
+
+/**
+ * @brief 获取流状态
+ */
+void RawStream_GetStats(RawStream_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RAW_STREAM_H */
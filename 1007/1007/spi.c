@@ -37,14 +37,15 @@ void MX_SPI2_Init(void)
     GPIO_InitStruct.Pull = GPIO_NOPULL;
     HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
     
-    /* NSS: GPIO输出 (软件控制) */
-    GPIO_InitStruct.Pin = SPI2_NSS_PIN;
+    /* NSS与附加片选: GPIO输出 (软件控制) */
+    GPIO_InitStruct.Pin = SPI2_NSS_PIN | SPI2_CS2_PIN | SPI2_CS3_PIN | SPI2_CS4_PIN;
     GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
     GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
     HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
     
-    /* NSS默认高电平 (未选中) */
+    /* 片选默认高电平 (未选中) */
     SPI2_NSS_HIGH();
+    HAL_GPIO_WritePin(GPIOB, SPI2_CS2_PIN | SPI2_CS3_PIN | SPI2_CS4_PIN, GPIO_PIN_SET);
     
     /* SPI2配置 */
     hspi2.Instance = SPI2;
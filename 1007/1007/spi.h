@@ -17,6 +17,14 @@ extern "C" {
 #define SPI2_NSS_PIN        GPIO_PIN_12
 #define SPI2_NSS_PORT       GPIOB
 
+/* 附加传感器片选 (多陀螺仪, 见gyro_fusion.h), 未装配的片选保持高电平 */
+#define SPI2_CS2_PIN        GPIO_PIN_0
+#define SPI2_CS2_PORT       GPIOB
+#define SPI2_CS3_PIN        GPIO_PIN_1
+#define SPI2_CS3_PORT       GPIOB
+#define SPI2_CS4_PIN        GPIO_PIN_10
+#define SPI2_CS4_PORT       GPIOB
+
 /* NSS 软件控制宏 */
 #define SPI2_NSS_LOW()      HAL_GPIO_WritePin(SPI2_NSS_PORT, SPI2_NSS_PIN, GPIO_PIN_RESET)
 #define SPI2_NSS_HIGH()     HAL_GPIO_WritePin(SPI2_NSS_PORT, SPI2_NSS_PIN, GPIO_PIN_SET)
@@ -0,0 +1,287 @@
+#include "sys_monitor.h"
+#include "trace.h"
+#include <string.h>
+
+#ifdef HOST_BUILD
+#include "freertos_host.h"
+#endif
+
+/*============================================================================
+ * 私有变量
+ *============================================================================*/
+static TaskHandle_t s_handles[SYS_MONITOR_MAX_TASKS];
+static uint16_t s_stack_sizes[SYS_MONITOR_MAX_TASKS];
+static uint8_t s_count;
+
+/* 以下仅由发送任务访问 */
+static TaskStatus_t s_status[SYS_MONITOR_MAX_TASKS + 2];
+static uint32_t s_prev_run[SYS_MONITOR_MAX_TASKS + 1];
+static uint32_t s_prev_total;
+static uint32_t s_last_ms;
+static int s_next_page = -1;                   /* -1=无待发送页 */
+static SysMonitor_Stats s_stats;
+
+static volatile uint32_t s_period_ms = SYS_MONITOR_PERIOD_MS;
+static volatile bool s_requested = false;
+
+#if configSUPPORT_STATIC_ALLOCATION
+/* 空闲任务静态内存 (vApplicationGetIdleTaskMemory) */
+static StackType_t s_idle_stack[configMINIMAL_STACK_SIZE];
+static StaticTask_t s_idle_tcb;
+#endif
+
+#ifdef HOST_BUILD
+static uint64_t s_timer_base;                  /* 时基启动时的虚拟周期数 */
+#else
+static volatile uint32_t s_timer_high;         /* TIM2溢出次数 (计数高16位) */
+#endif
+
+/* 栈溢出的任务名 (溢出钩子停机前写入, 由调试器读取) */
+volatile char g_stack_overflow_task[configMAX_TASK_NAME_LEN];
+
+/*============================================================================
+ * 私有函数
+ *============================================================================*/
+
+static void SysMonitor_Put16(uint8_t *dst, uint32_t value)
+{
+    if (value > 0xFFFF)
+    {
+        value = 0xFFFF;
+    }
+    dst[0] = (uint8_t)(value & 0xFF);
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief 在任务状态表中查找任务
+ */
+static const TaskStatus_t *SysMonitor_Find(TaskHandle_t task, UBaseType_t n)
+{
+    for (UBaseType_t i = 0; i < n; i++)
+    {
+        if (s_status[i].xHandle == task)
+        {
+            return &s_status[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 采样: 以上次采样以来的时间为窗口计算占用率, 刷新栈与堆余量
+ */
+static void SysMonitor_Sample(uint32_t now_ms)
+{
+    uint32_t total = 0;
+    UBaseType_t n = uxTaskGetSystemState(s_status, sizeof(s_status) / sizeof(s_status[0]), &total);
+    uint32_t window = total - s_prev_total;
+    uint8_t flags = 0;
+
+    s_stats.task_count = (uint8_t)(s_count + 1);
+    for (uint8_t i = 0; i < s_stats.task_count; i++)
+    {
+        bool idle = (i == s_count);
+        const TaskStatus_t *st = SysMonitor_Find(idle ? xTaskGetIdleTaskHandle() : s_handles[i], n);
+        SysMonitor_Task *t = &s_stats.tasks[i];
+
+        t->stack_size = idle ? configMINIMAL_STACK_SIZE : s_stack_sizes[i];
+        if (st == NULL)
+        {
+            t->name = "?";
+            continue;
+        }
+
+        uint32_t run = st->ulRunTimeCounter - s_prev_run[i];
+        s_prev_run[i] = st->ulRunTimeCounter;
+        t->name = st->pcTaskName;
+        t->load_permyriad = (window > 0) ? (uint16_t)(((uint64_t)run * 10000U) / window) : 0;
+        t->stack_free = (uint16_t)st->usStackHighWaterMark;
+        if (t->stack_free < SYS_MONITOR_STACK_WARN)
+        {
+            flags |= SYS_MONITOR_FLAG_STACK_LOW;
+        }
+    }
+
+    uint16_t idle_load = s_stats.tasks[s_count].load_permyriad;
+    s_stats.cpu_load_permyriad = (idle_load < 10000U) ? (uint16_t)(10000U - idle_load) : 0;
+#if configSUPPORT_DYNAMIC_ALLOCATION
+    s_stats.heap_free = xPortGetFreeHeapSize();
+    s_stats.heap_min_free = xPortGetMinimumEverFreeHeapSize();
+#endif
+    s_stats.flags = flags;
+    s_stats.window_ms = now_ms - s_last_ms;
+
+    s_prev_total = total;
+    s_last_ms = now_ms;
+    s_next_page = 0;
+}
+
+/*============================================================================
+ * 运行时间统计时基
+ *============================================================================*/
+
+/**
+ * @brief TIM2: 10kHz递增, 溢出中断扩展高16位
+ *
+ * APB1为2分频, TIM2时钟为2×PCLK1 = HCLK. 计数约119小时回绕,
+ * 内核与本模块均只使用差值, 回绕不影响占用率.
+ */
+void SysMonitor_TimerInit(void)
+{
+#ifdef HOST_BUILD
+    s_timer_base = HostSim_Cycles();
+#else
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    TIM2->CR1 = 0;
+    TIM2->PSC = SystemCoreClock / SYS_MONITOR_TIMER_HZ - 1;
+    TIM2->ARR = 0xFFFF;
+    TIM2->EGR = TIM_EGR_UG;                     /* 立即装载预分频 */
+    TIM2->SR = 0;
+    TIM2->DIER = TIM_DIER_UIE;
+    HAL_NVIC_SetPriority(TIM2_IRQn, 15, 0);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+    TIM2->CR1 = TIM_CR1_CEN;
+#endif
+}
+
+uint32_t SysMonitor_TimerCount(void)
+{
+#ifdef HOST_BUILD
+    return (uint32_t)((HostSim_Cycles() - s_timer_base) / (SystemCoreClock / SYS_MONITOR_TIMER_HZ));
+#else
+    uint32_t high;
+    uint32_t low;
+    bool pending;
+
+    // 读取期间溢出中断执行过则重读; 溢出已发生但中断尚未执行 (关中断期间) 时补上一次
+    do
+    {
+        high = s_timer_high;
+        low = TIM2->CNT;
+        pending = (TIM2->SR & TIM_SR_UIF) != 0;
+    } while (high != s_timer_high);
+    if (pending && low < 0x8000U)
+    {
+        high++;
+    }
+
+    return (high << 16) | low;
+#endif
+}
+
+#ifndef HOST_BUILD
+void TIM2_IRQHandler(void)
+{
+    TRACE_ISR_ENTER(TIM2_IRQn);
+    if (TIM2->SR & TIM_SR_UIF)
+    {
+        TIM2->SR = ~TIM_SR_UIF;
+        s_timer_high++;
+    }
+    TRACE_ISR_EXIT(TIM2_IRQn);
+}
+#endif
+
+/*============================================================================
+ * FreeRTOS钩子
+ *============================================================================*/
+
+#if configSUPPORT_STATIC_ALLOCATION
+/**
+ * @brief 空闲任务内存 (vTaskStartScheduler创建空闲任务时调用)
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &s_idle_tcb;
+    *ppxIdleTaskStackBuffer = s_idle_stack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+#endif
+
+/**
+ * @brief 栈溢出 (任务切换时检测, configCHECK_FOR_STACK_OVERFLOW=2)
+ *
+ * 检测到时相邻内存可能已被改写, 继续运行没有意义: 记下任务名后停机
+ */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
+{
+    (void)xTask;
+
+    taskDISABLE_INTERRUPTS();
+    for (int i = 0; i < configMAX_TASK_NAME_LEN - 1 && pcTaskName[i] != '\0'; i++)
+    {
+        g_stack_overflow_task[i] = pcTaskName[i];
+    }
+    for (;;) {}
+}
+
+/*============================================================================
+ * 公共函数
+ *============================================================================*/
+
+void SysMonitor_RegisterTask(TaskHandle_t task, uint16_t stack_size)
+{
+    if (task != NULL && s_count < SYS_MONITOR_MAX_TASKS)
+    {
+        s_handles[s_count] = task;
+        s_stack_sizes[s_count] = stack_size;
+        s_count++;
+        vTaskSetTaskNumber(task, s_count);      /* 事件跟踪中的任务号与页号一致 */
+    }
+}
+
+void SysMonitor_Update(uint32_t now_ms)
+{
+    uint32_t period = s_period_ms;
+
+    if (s_requested || (period != 0 && (now_ms - s_last_ms) >= period))
+    {
+        s_requested = false;
+        SysMonitor_Sample(now_ms);
+    }
+}
+
+void SysMonitor_Request(void)
+{
+    s_requested = true;
+}
+
+void SysMonitor_SetPeriod(uint32_t period_ms)
+{
+    s_period_ms = period_ms;
+}
+
+bool SysMonitor_NextFrame(uint8_t *data)
+{
+    if (s_next_page < 0)
+    {
+        return false;
+    }
+
+    memset(data, 0, 8);
+    data[0] = (uint8_t)s_next_page;
+    if (s_next_page == 0)
+    {
+        data[1] = s_stats.flags;
+        SysMonitor_Put16(&data[2], s_stats.cpu_load_permyriad);
+        SysMonitor_Put16(&data[4], s_stats.heap_free);
+        SysMonitor_Put16(&data[6], s_stats.heap_min_free);
+    }
+    else
+    {
+        const SysMonitor_Task *t = &s_stats.tasks[s_next_page - 1];
+        SysMonitor_Put16(&data[1], t->load_permyriad);
+        SysMonitor_Put16(&data[3], t->stack_free);
+        SysMonitor_Put16(&data[5], t->stack_size);
+    }
+
+    s_next_page = (s_next_page < s_stats.task_count) ? s_next_page + 1 : -1;
+    return true;
+}
+
+void SysMonitor_GetStats(SysMonitor_Stats *stats)
+{
+    *stats = s_stats;
+}
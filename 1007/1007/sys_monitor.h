@@ -0,0 +1,97 @@
+#ifndef __SYS_MONITOR_H
+#define __SYS_MONITOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f1xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdbool.h>
+
+/*============================================================================
+ * 系统监视 (任务CPU占用、栈余量、堆余量)
+ *
+ * TIM2作为FreeRTOS运行时间统计时基 (10kHz, 16-bit计数 + 溢出中断扩展为32-bit),
+ * 每个统计窗口由uxTaskGetSystemState取各任务运行时间, 与上一窗口相减得到占用率;
+ * 栈余量为uxTaskGetStackHighWaterMark (历史最小剩余), 堆为heap_4当前/历史最小剩余
+ * (configSUPPORT_DYNAMIC_ALLOCATION=0时不链接堆, 堆字段为0).
+ *
+ * 结果经CAN_ID_SYS_MONITOR分页发送 (每页8字节):
+ *   页0:  [0]=0 [1]=标志 [2-3]=CPU占用(0.01%) [4-5]=堆剩余(B) [6-7]=堆历史最小剩余(B)
+ *   页n:  [0]=n [1-2]=任务占用(0.01%) [3-4]=栈历史最小剩余(字) [5-6]=栈大小(字) [7]=0
+ * 页1起依次为SysMonitor_RegisterTask注册的任务, 最后一页为空闲任务.
+ *============================================================================*/
+#define SYS_MONITOR_TIMER_HZ        10000   /* 运行时间统计计数频率 (节拍频率的10倍) */
+#define SYS_MONITOR_PERIOD_MS       1000    /* 默认统计窗口/发送周期 */
+#define SYS_MONITOR_MAX_TASKS       6       /* 注册任务数上限 (不含空闲任务) */
+#define SYS_MONITOR_STACK_WARN      32      /* 栈剩余低于该字数时置告警标志 */
+
+/* 页0标志 */
+/* 0x01保留 (原堆分配失败标志; 全部静态分配, 不再有堆) */
+#define SYS_MONITOR_FLAG_STACK_LOW      0x02    /* 有任务栈剩余低于SYS_MONITOR_STACK_WARN */
+
+/* 单个任务统计 */
+typedef struct {
+    const char *name;
+    uint16_t load_permyriad;    /* 最近窗口CPU占用 (0.01%) */
+    uint16_t stack_free;        /* 栈历史最小剩余 (字) */
+    uint16_t stack_size;        /* 栈大小 (字) */
+} SysMonitor_Task;
+
+/* 系统统计 */
+typedef struct {
+    uint32_t window_ms;         /* 最近窗口长度 */
+    uint16_t cpu_load_permyriad;/* 100% - 空闲任务占用 */
+    uint32_t heap_free;         /* 堆当前剩余 (B) */
+    uint32_t heap_min_free;     /* 堆历史最小剩余 (B) */
+    uint8_t flags;              /* SYS_MONITOR_FLAG_xxx */
+    uint8_t task_count;         /* 含空闲任务 */
+    SysMonitor_Task tasks[SYS_MONITOR_MAX_TASKS + 1];
+} SysMonitor_Stats;
+
+/**
+ * @brief 运行时间统计时基 (FreeRTOSConfig.h中portCONFIGURE_TIMER_FOR_RUN_TIME_STATS/
+ *        portGET_RUN_TIME_COUNTER_VALUE, 由内核调用)
+ */
+void SysMonitor_TimerInit(void);
+uint32_t SysMonitor_TimerCount(void);
+
+/**
+ * @brief 注册需要监视的任务 (创建后调用, 注册顺序即页号, 同时设为事件跟踪的任务号)
+ * @param stack_size 创建时的栈大小 (字)
+ */
+void SysMonitor_RegisterTask(TaskHandle_t task, uint16_t stack_size);
+
+/**
+ * @brief 周期维护: 窗口到期时更新统计并安排发送全部页 (发送任务调用)
+ */
+void SysMonitor_Update(uint32_t now_ms);
+
+/**
+ * @brief 立即发送全部页 (栈与堆为当前值, 占用率为最近窗口)
+ */
+void SysMonitor_Request(void);
+
+/**
+ * @brief 设置周期发送间隔 (ms), 0=只在请求时发送
+ */
+void SysMonitor_SetPeriod(uint32_t period_ms);
+
+/**
+ * @brief 取下一待发送页
+ * @return true=data有效
+ */
+bool SysMonitor_NextFrame(uint8_t *data);
+
+/**
+ * @brief 获取最近一次统计
+ */
+void SysMonitor_GetStats(SysMonitor_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SYS_MONITOR_H */
@@ -0,0 +1,14 @@
+#include "timestamp.h"
+
+/**
+ * @brief 使能DWT周期计数器
+ *
+ * CYCCNT由内核时钟驱动, 读取只需一条LDR指令,
+ * 用于采样时间戳、CAN时间换算等需要亚微秒分辨率的场合
+ */
+void Timestamp_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
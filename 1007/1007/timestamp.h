@@ -0,0 +1,49 @@
+#ifndef __TIMESTAMP_H
+#define __TIMESTAMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f1xx_hal.h"
+
+/*============================================================================
+ * DWT周期计数器时间基准
+ * 72MHz下32-bit计数约59.6秒回绕, 差值运算使用无符号减法即可
+ *============================================================================*/
+
+/**
+ * @brief 使能DWT周期计数器 (上电后调用一次)
+ */
+void Timestamp_Init(void);
+
+/**
+ * @brief 读取当前周期计数
+ */
+#ifdef HOST_BUILD
+uint64_t HostSim_Cycles(void);
+
+static inline uint32_t Timestamp_Now(void)
+{
+    return (uint32_t)HostSim_Cycles();     /* 主机构建: 虚拟时钟 */
+}
+#else
+static inline uint32_t Timestamp_Now(void)
+{
+    return DWT->CYCCNT;
+}
+#endif
+
+/**
+ * @brief 周期数转换为微秒
+ */
+static inline uint32_t Timestamp_CyclesToUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000U);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMESTAMP_H */
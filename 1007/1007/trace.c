@@ -0,0 +1,117 @@
+#include "trace.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+
+/*============================================================================
+ * 全局变量
+ *============================================================================*/
+Trace_Buffer g_trace;
+
+/*============================================================================
+ * 私有变量 (仅由发送任务访问)
+ *============================================================================*/
+static bool s_dumping = false;
+static uint32_t s_dump_first;                  /* 导出起点 (累计序号) */
+static uint32_t s_dump_count;                  /* 导出事件数 */
+static int32_t s_dump_index = -1;              /* -1=头帧, 其余为已发送事件数 */
+
+/*============================================================================
+ * FreeRTOS钩子
+ *============================================================================*/
+
+/**
+ * @brief 任务切入 (vTaskSwitchContext选出新任务后, 调度器临界区内)
+ */
+void Trace_TaskSwitchedIn(void *tcb)
+{
+#if TRACE_ENABLE
+    TRACE_EVENT(TRACE_EV_TASK_IN, 0, uxTaskGetTaskNumber((TaskHandle_t)tcb));
+#else
+    (void)tcb;
+#endif
+}
+
+/**
+ * @brief 任务切出 (vTaskSwitchContext选择新任务前)
+ */
+void Trace_TaskSwitchedOut(void *tcb)
+{
+#if TRACE_ENABLE
+    TRACE_EVENT(TRACE_EV_TASK_OUT, 0, uxTaskGetTaskNumber((TaskHandle_t)tcb));
+#else
+    (void)tcb;
+#endif
+}
+
+/*============================================================================
+ * 公共函数
+ *============================================================================*/
+
+void Trace_StartDump(void)
+{
+    if (s_dumping)
+    {
+        return;
+    }
+
+    __disable_irq();
+    g_trace.frozen = true;
+    __enable_irq();
+
+    uint32_t head = g_trace.head;
+    s_dump_count = (head < TRACE_EVENT_COUNT) ? head : TRACE_EVENT_COUNT;
+    s_dump_first = head - s_dump_count;
+    s_dump_index = -1;
+    s_dumping = true;
+}
+
+void Trace_Rearm(void)
+{
+    __disable_irq();
+    g_trace.head = 0;
+    g_trace.frozen = false;
+    __enable_irq();
+
+    s_dumping = false;
+}
+
+bool Trace_NextDumpFrame(uint8_t *data)
+{
+    if (!s_dumping)
+    {
+        return false;
+    }
+
+    if (s_dump_index < 0)
+    {
+        uint32_t head = g_trace.head;
+        data[0] = (uint8_t)(head & 0xFF);
+        data[1] = (uint8_t)((head >> 8) & 0xFF);
+        data[2] = (uint8_t)((head >> 16) & 0xFF);
+        data[3] = (uint8_t)(head >> 24);
+        data[4] = TRACE_EV_HEADER;
+        data[5] = (uint8_t)(SystemCoreClock / 1000000U);
+        data[6] = (uint8_t)(s_dump_count & 0xFF);
+        data[7] = (uint8_t)(s_dump_count >> 8);
+    }
+    else
+    {
+        const Trace_Event *e = &g_trace.events[(s_dump_first + (uint32_t)s_dump_index) & (TRACE_EVENT_COUNT - 1)];
+        data[0] = (uint8_t)(e->cycles & 0xFF);
+        data[1] = (uint8_t)((e->cycles >> 8) & 0xFF);
+        data[2] = (uint8_t)((e->cycles >> 16) & 0xFF);
+        data[3] = (uint8_t)(e->cycles >> 24);
+        data[4] = e->type;
+        data[5] = e->arg8;
+        data[6] = (uint8_t)(e->arg16 & 0xFF);
+        data[7] = (uint8_t)(e->arg16 >> 8);
+    }
+
+    s_dump_index++;
+    if ((uint32_t)s_dump_index >= s_dump_count)
+    {
+        s_dumping = false;
+    }
+    return true;
+}
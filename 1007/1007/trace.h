@@ -0,0 +1,124 @@
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32f1xx_hal.h"
+#include "timestamp.h"
+#include <stdbool.h>
+
+/*============================================================================
+ * 事件跟踪 (任务切换、中断进出、SPI传输、CAN收发)
+ *
+ * 事件以DWT周期计数打时间戳写入RAM环形缓冲, 满后覆盖最旧事件.
+ * 记录为内联的关中断写入 (约20~30周期), 不调用其他函数, 可在中断与
+ * FreeRTOS切换钩子中使用. TRACE_ENABLE=0时全部记录宏为空.
+ *
+ * 导出时冻结缓冲, 经CAN_ID_TRACE逐帧发送 (由发送任务限速):
+ *   头帧: [0-3]=累计事件数 [4]=0xFF [5]=CPU主频(MHz) [6-7]=随后事件帧数
+ *   事件: [0-3]=周期计数 [4]=类型 [5]=参数8 [6-7]=参数16  (小端, 最旧在前)
+ * 主机端由host/trace_decode解码为时间线.
+ *============================================================================*/
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE            1
+#endif
+#define TRACE_EVENT_COUNT       128     /* 事件数 (2的幂, 每个8字节) */
+
+/* 事件类型 */
+#define TRACE_EV_TASK_IN        0x01    /* 任务切入, 参数16=任务号 */
+#define TRACE_EV_TASK_OUT       0x02    /* 任务切出, 参数16=任务号 */
+#define TRACE_EV_ISR_ENTER      0x03    /* 中断进入, 参数8=IRQn */
+#define TRACE_EV_ISR_EXIT       0x04    /* 中断退出, 参数8=IRQn */
+#define TRACE_EV_SPI_BEGIN      0x05    /* SPI传输开始 (NSS拉低), 参数8=命令字节 */
+#define TRACE_EV_SPI_END        0x06    /* SPI传输结束 (NSS拉高) */
+#define TRACE_EV_CAN_TX         0x07    /* CAN帧提交发送, 参数8=DLC, 参数16=ID */
+#define TRACE_EV_CAN_TX_DONE    0x08    /* CAN发送完成, 参数8=邮箱 */
+#define TRACE_EV_CAN_RX         0x09    /* CAN帧读出, 参数8=DLC, 参数16=ID */
+#define TRACE_EV_MARK           0x0A    /* 用户标记, 参数8=标记号, 参数16=自定义 */
+#define TRACE_EV_HEADER         0xFF    /* 导出头帧 (不写入缓冲) */
+
+/* 任务号 (vTaskSetTaskNumber, 由SysMonitor_RegisterTask按登记顺序分配; 0=空闲或未登记) */
+#define TRACE_TASK_IDLE         0
+
+/* 用户标记号 */
+#define TRACE_MARK_MAIN_BEGIN   1       /* 主任务一次循环开始 */
+#define TRACE_MARK_MAIN_END     2       /* 主任务一次循环结束 (进入周期等待) */
+#define TRACE_MARK_OVERRUN      3       /* 主任务超过截止时刻, 参数16=执行时间(µs) */
+
+/* 单个事件 (8字节) */
+typedef struct {
+    uint32_t cycles;
+    uint8_t type;
+    uint8_t arg8;
+    uint16_t arg16;
+} Trace_Event;
+
+/* 缓冲状态 (仅供内联记录函数访问) */
+typedef struct {
+    Trace_Event events[TRACE_EVENT_COUNT];
+    volatile uint32_t head;     /* 累计写入事件数, 写位置为head % TRACE_EVENT_COUNT */
+    volatile bool frozen;       /* 冻结后不再记录 */
+} Trace_Buffer;
+
+extern Trace_Buffer g_trace;
+
+/**
+ * @brief 记录一个事件 (任务与中断中均可调用)
+ */
+static inline void Trace_Record(uint8_t type, uint8_t arg8, uint16_t arg16)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (!g_trace.frozen)
+    {
+        Trace_Event *e = &g_trace.events[g_trace.head & (TRACE_EVENT_COUNT - 1)];
+        e->cycles = Timestamp_Now();
+        e->type = type;
+        e->arg8 = arg8;
+        e->arg16 = arg16;
+        g_trace.head++;
+    }
+    __set_PRIMASK(primask);
+}
+
+#if TRACE_ENABLE
+#define TRACE_EVENT(type, arg8, arg16)  Trace_Record((type), (uint8_t)(arg8), (uint16_t)(arg16))
+#else
+#define TRACE_EVENT(type, arg8, arg16)  ((void)0)
+#endif
+
+#define TRACE_ISR_ENTER(irqn)           TRACE_EVENT(TRACE_EV_ISR_ENTER, (irqn), 0)
+#define TRACE_ISR_EXIT(irqn)            TRACE_EVENT(TRACE_EV_ISR_EXIT, (irqn), 0)
+#define TRACE_MARK(id, value)           TRACE_EVENT(TRACE_EV_MARK, (id), (value))
+
+/**
+ * @brief 任务切换钩子 (FreeRTOSConfig.h中traceTASK_SWITCHED_IN/OUT, 由内核调用)
+ * @param tcb 当前任务控制块 (pxCurrentTCB)
+ */
+void Trace_TaskSwitchedIn(void *tcb);
+void Trace_TaskSwitchedOut(void *tcb);
+
+/**
+ * @brief 冻结缓冲并开始导出 (已在导出中则忽略)
+ */
+void Trace_StartDump(void);
+
+/**
+ * @brief 清空缓冲并恢复记录 (中止未完成的导出)
+ */
+void Trace_Rearm(void);
+
+/**
+ * @brief 取下一导出帧
+ * @return true=data有效; 全部发送完后返回false, 缓冲保持冻结直到Trace_Rearm
+ */
+bool Trace_NextDumpFrame(uint8_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRACE_H */
@@ -1,102 +1,242 @@
 #include "xv7001bb.h"
 #include "spi.h"
+#include "trace.h"
+#include "timestamp.h"
+#include "ramfunc.h"
 
-/*============================================================================
- * 私有变量
- *============================================================================*/
-static float g_temp_bias = 0.0f;    /* 温度偏置 */
+/* 片选控制 */
+#define XV7_CS_LOW(dev)     HAL_GPIO_WritePin((dev)->cs_port, (dev)->cs_pin, GPIO_PIN_RESET)
+#define XV7_CS_HIGH(dev)    HAL_GPIO_WritePin((dev)->cs_port, (dev)->cs_pin, GPIO_PIN_SET)
 
 /*============================================================================
  * 私有函数
  *============================================================================*/
 
 /**
- * @brief SPI传输一个字节
+ * @brief HAL中止后等当前字节移位完成 (最多XV7_SPI_DRAIN_US), 清除残留的RXNE/OVR
  */
-static uint8_t SPI_TransferByte(uint8_t tx)
+RAMFUNC static void SPI_Drain(void)
 {
-    uint8_t rx = 0;
-    HAL_SPI_TransmitReceive(&hspi2, &tx, &rx, 1, 100);
-    return rx;
+    uint32_t start = Timestamp_Now();
+    uint32_t limit = XV7_SPI_DRAIN_US * (SystemCoreClock / 1000000U);
+    
+    while (__HAL_SPI_GET_FLAG(&hspi2, SPI_FLAG_BSY) && (Timestamp_Now() - start) < limit)
+    {
+    }
+    __HAL_SPI_CLEAR_OVRFLAG(&hspi2);
 }
 
-/*============================================================================
- * 公共函数实现
- *============================================================================*/
+/**
+ * @brief SPI传输len个字节 (逐字节收发), 第一次HAL错误即中止
+ * @return true=全部字节传输成功
+ */
+RAMFUNC static bool SPI_Transfer(const uint8_t *tx, uint8_t *rx, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (HAL_SPI_TransmitReceive(&hspi2, (uint8_t *)&tx[i], &rx[i], 1, XV7_SPI_TIMEOUT_MS) != HAL_OK)
+        {
+            SPI_Drain();
+            return false;
+        }
+    }
+    return true;
+}
 
 /**
- * @brief 初始化XV7001BB传感器
+ * @brief 一次读事务: 命令字节后读len个数据字节 (发送dummy字节)
  */
-XV7_Status XV7001bb_Init(void)
+RAMFUNC static XV7_Status XV7001bb_Read(XV7_Device *dev, uint8_t reg, uint8_t *buf, uint8_t len)
 {
-    XV7_StatusReg status;
-    uint32_t timeout = 1000;  /* 1秒超时 */
+    static const uint8_t dummy[4] = { 0xFF, 0xFF, 0xFF, 0xFF };
+    uint8_t cmd = reg | 0x80;  /* bit7=1 表示读 */
+    uint8_t rx;
+    bool ok;
+    
+    TRACE_EVENT(TRACE_EV_SPI_BEGIN, cmd, 0);
+    XV7_CS_LOW(dev);
+    ok = SPI_Transfer(&cmd, &rx, 1) && SPI_Transfer(dummy, buf, len);
+    XV7_CS_HIGH(dev);
+    TRACE_EVENT(TRACE_EV_SPI_END, 0, 0);
     
-    /* 等待一段时间让传感器稳定 */
-    HAL_Delay(100);
+    dev->fault = ok ? XV7_FAULT_NONE : XV7_FAULT_SPI;
+    return ok ? XV7_OK : XV7_ERR_SPI;
+}
+
+/**
+ * @brief 全部字节为value
+ */
+RAMFUNC static bool XV7001bb_AllBytes(const uint8_t *buf, uint8_t len, uint8_t value)
+{
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (buf[i] != value)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 角速度读数的STUCK/JUMP检查, 接受时更新参考值
+ */
+RAMFUNC static XV7_Status XV7001bb_CheckRate(XV7_Device *dev, int32_t raw)
+{
+    const int32_t full = (dev->rate_bits == 24) ? 0x7FFFFF : (0x7FFF << XV7_RATE_16BIT_SHIFT);
+    uint32_t now = HAL_GetTick();
+    uint32_t periods = (now - dev->read_tick + XV7_FAULT_JUMP_PERIOD_MS - 1) / XV7_FAULT_JUMP_PERIOD_MS;
     
-    /* 发送唤醒命令 (SLEEP_OUT) */
-    XV7001bb_WriteData(XV7_REG_SLEEP_OUT, 0x00);
-    HAL_Delay(100);
+    /* 门限按与上次读取的间隔放宽 (4份已超过满量程, 长时间未读即不再比较) */
+    periods = (periods < 1) ? 1 : (periods > 4) ? 4 : periods;
+    const int32_t jump = (int32_t)(XV7_FAULT_JUMP_DPS * XV7_GYRO_SENSITIVITY_24BIT) * (int32_t)periods;
+    dev->read_tick = now;
     
-    /* 等待传感器就绪 */
-    while (timeout > 0)
+    if (dev->check & 0x01)
     {
-        if (XV7001bb_ReadStatus(&status) == XV7_OK)
+        int32_t d = raw - dev->last_raw;
+        bool saturated = (raw >= full || raw <= -0x800000);
+        
+        if (d == 0 && !saturated && dev->rate_bits == 24)
         {
-            if (status.proc_ok && status.state == XV7_STATE_SLEEP_OUT)
+            if (++dev->repeats >= XV7_FAULT_STUCK_READS - 1)
+            {
+                dev->repeats = XV7_FAULT_STUCK_READS - 1;
+                dev->fault = XV7_FAULT_STUCK;
+                return XV7_ERR_DATA;
+            }
+        }
+        else if (d > jump || d < -jump)
+        {
+            /* 新水平须持续XV7_FAULT_JUMP_PERSIST_MS (读数之间也不跳变) 才接受 */
+            int32_t dj = raw - dev->jump_raw;
+            if (!(dev->check & 0x02) || dj > jump || dj < -jump)
+            {
+                dev->jump_tick = now;
+                dev->check |= 0x02;
+            }
+            dev->jump_raw = raw;
+            if (now - dev->jump_tick < XV7_FAULT_JUMP_PERSIST_MS)
             {
-                return XV7_OK;
+                dev->fault = XV7_FAULT_JUMP;
+                return XV7_ERR_DATA;
             }
         }
-        HAL_Delay(10);
-        timeout -= 10;
+        if (d != 0 || dev->rate_bits != 24)
+        {
+            dev->repeats = 0;
+        }
+    }
+    
+    dev->last_raw = raw;
+    dev->check = 0x01;
+    return XV7_OK;
+}
+
+/*============================================================================
+ * 公共函数实现
+ *============================================================================*/
+
+/**
+ * @brief 初始化XV7001BB传感器 (阻塞, 按退避间隔查询就绪)
+ */
+XV7_Status XV7001bb_Init(XV7_Device *dev)
+{
+    uint32_t elapsed = 0;
+    uint32_t delay = XV7_READY_POLL_MIN_MS;
+    XV7_Status ret;
+    
+    /* 发送唤醒命令 (SLEEP_OUT), 不再固定等待 */
+    XV7001bb_Wake(dev);
+    
+    /* 等待传感器就绪: 间隔从1ms倍增, 就绪后最多多等一个间隔 */
+    for (;;)
+    {
+        ret = XV7001bb_PollReady(dev);
+        if (ret == XV7_OK)
+        {
+            return XV7_OK;
+        }
+        if (elapsed >= XV7_READY_TIMEOUT_MS)
+        {
+            return XV7_ERR_TIMEOUT;
+        }
+        HAL_Delay(delay);
+        elapsed += delay;
+        delay = (delay * 2 > XV7_READY_POLL_MAX_MS) ? XV7_READY_POLL_MAX_MS : delay * 2;
     }
+}
+
+/**
+ * @brief 发送唤醒命令 (SLEEP_OUT), 立即返回
+ */
+XV7_Status XV7001bb_Wake(XV7_Device *dev)
+{
+    dev->check = 0;     /* 唤醒前的读数不再作为参考 */
+    dev->repeats = 0;
+    return XV7001bb_WriteData(dev, XV7_REG_SLEEP_OUT, 0x00);
+}
+
+/**
+ * @brief 查询一次是否已唤醒就绪
+ * 状态码不是SLEEP_OUT说明唤醒命令未生效 (如上电复位未完成时发出), 重发唤醒命令
+ */
+XV7_Status XV7001bb_PollReady(XV7_Device *dev)
+{
+    XV7_StatusReg status;
+    XV7_Status ret;
     
-    return XV7_ERR_TIMEOUT;
+    ret = XV7001bb_ReadStatus(dev, &status);
+    if (ret != XV7_OK)
+    {
+        return ret;
+    }
+    if (status.state != XV7_STATE_SLEEP_OUT)
+    {
+        XV7001bb_Wake(dev);
+        return XV7_ERR_NOT_READY;
+    }
+    return status.proc_ok ? XV7_OK : XV7_ERR_NOT_READY;
 }
 
 /**
  * @brief 写入寄存器数据
  * 写操作: [0][地址6:0] [数据7:0]
  */
-XV7_Status XV7001bb_WriteData(uint8_t reg, uint8_t data)
+XV7_Status XV7001bb_WriteData(XV7_Device *dev, uint8_t reg, uint8_t data)
 {
-    uint8_t cmd = reg & 0x7F;  /* bit7=0 表示写 */
+    uint8_t tx[2] = { (uint8_t)(reg & 0x7F), data };  /* bit7=0 表示写 */
+    uint8_t rx[2];
+    bool ok;
     
-    SPI2_NSS_LOW();
-    SPI_TransferByte(cmd);
-    SPI_TransferByte(data);
-    SPI2_NSS_HIGH();
+    TRACE_EVENT(TRACE_EV_SPI_BEGIN, tx[0], 0);
+    XV7_CS_LOW(dev);
+    ok = SPI_Transfer(tx, rx, 2);
+    XV7_CS_HIGH(dev);
+    TRACE_EVENT(TRACE_EV_SPI_END, 0, 0);
     
-    return XV7_OK;
+    dev->fault = ok ? XV7_FAULT_NONE : XV7_FAULT_SPI;
+    return ok ? XV7_OK : XV7_ERR_SPI;
 }
 
 /**
  * @brief 读取寄存器数据
  * 读操作: [1][地址6:0] -> [数据7:0]
  */
-XV7_Status XV7001bb_ReadReg(uint8_t reg, uint8_t *data)
+RAMFUNC XV7_Status XV7001bb_ReadReg(XV7_Device *dev, uint8_t reg, uint8_t *data)
 {
-    uint8_t cmd = reg | 0x80;  /* bit7=1 表示读 */
-    
     if (data == NULL)
     {
         return XV7_ERR_SPI;
     }
     
-    SPI2_NSS_LOW();
-    SPI_TransferByte(cmd);
-    *data = SPI_TransferByte(0xFF);  /* 发送dummy字节读取数据 */
-    SPI2_NSS_HIGH();
-    
-    return XV7_OK;
+    return XV7001bb_Read(dev, reg, data, 1);
 }
 
 /**
  * @brief 读取状态寄存器
  */
-XV7_Status XV7001bb_ReadStatus(XV7_StatusReg *status)
+RAMFUNC XV7_Status XV7001bb_ReadStatus(XV7_Device *dev, XV7_StatusReg *status)
 {
     uint8_t data;
     XV7_Status ret;
@@ -106,11 +246,16 @@ XV7_Status XV7001bb_ReadStatus(XV7_StatusReg *status)
         return XV7_ERR_SPI;
     }
     
-    ret = XV7001bb_ReadReg(XV7_REG_STATUS, &data);
+    ret = XV7001bb_ReadReg(dev, XV7_REG_STATUS, &data);
     if (ret != XV7_OK)
     {
         return ret;
     }
+    if (data == 0xFF)
+    {
+        dev->fault = XV7_FAULT_ONES;
+        return XV7_ERR_DATA;
+    }
     
     status->raw = data;
     status->proc_ok = (data & XV7_STATUS_PROC_OK) ? true : false;
@@ -123,7 +268,7 @@ XV7_Status XV7001bb_ReadStatus(XV7_StatusReg *status)
  * @brief 读取温度数据
  * 12-bit模式: T = (raw / 16) - 6.0 + bias
  */
-XV7_Status XV7001bb_ReadTmp(XV7_TempData *temp)
+RAMFUNC XV7_Status XV7001bb_ReadTmp(XV7_Device *dev, XV7_TempData *temp)
 {
     uint8_t buf[2];
     XV7_Status ret;
@@ -134,19 +279,22 @@ XV7_Status XV7001bb_ReadTmp(XV7_TempData *temp)
     }
     
     /* 读取2字节温度数据 */
-    uint8_t cmd = XV7_REG_TEMP_READ | 0x80;
-    
-    SPI2_NSS_LOW();
-    SPI_TransferByte(cmd);
-    buf[0] = SPI_TransferByte(0xFF);
-    buf[1] = SPI_TransferByte(0xFF);
-    SPI2_NSS_HIGH();
+    ret = XV7001bb_Read(dev, XV7_REG_TEMP_READ, buf, 2);
+    if (ret != XV7_OK)
+    {
+        return ret;
+    }
+    if (XV7001bb_AllBytes(buf, 2, 0xFF))
+    {
+        dev->fault = XV7_FAULT_ONES;
+        return XV7_ERR_DATA;
+    }
     
     /* 提取12-bit值: buf[0]为高8位, buf[1]高2位为低2位 */
     temp->raw = ((uint16_t)buf[0] << 2) | ((buf[1] >> 6) & 0x03);
     
     /* 转换为摄氏度 */
-    temp->celsius = ((float)temp->raw / 16.0f) - 6.0f + g_temp_bias;
+    temp->celsius = ((float)temp->raw / 16.0f) - 6.0f + dev->temp_bias;
     
     return XV7_OK;
 }
@@ -154,36 +302,53 @@ XV7_Status XV7001bb_ReadTmp(XV7_TempData *temp)
 /**
  * @brief 读取角速度数据
  * 24-bit模式: dps = raw / 71680.0
+ * 16-bit模式: raw16 * 256换算为24-bit LSB (dps = raw16 / 280.0)
  */
-XV7_Status XV7001bb_ReadAngle(XV7_GyroData *gyro)
+RAMFUNC XV7_Status XV7001bb_ReadAngle(XV7_Device *dev, XV7_GyroData *gyro)
 {
     uint8_t buf[3];
     int32_t raw24;
+    XV7_Status ret;
     
     if (gyro == NULL)
     {
         return XV7_ERR_SPI;
     }
     
-    /* 读取3字节角速度数据 */
-    uint8_t cmd = XV7_REG_RATE_READ | 0x80;
-    
-    SPI2_NSS_LOW();
-    SPI_TransferByte(cmd);
-    buf[0] = SPI_TransferByte(0xFF);  /* 高字节 */
-    buf[1] = SPI_TransferByte(0xFF);  /* 中字节 */
-    buf[2] = SPI_TransferByte(0xFF);  /* 低字节 */
-    SPI2_NSS_HIGH();
-    
-    /* 拼接24-bit原始数据 (大端序) */
-    raw24 = ((int32_t)buf[0] << 16) | ((int32_t)buf[1] << 8) | buf[2];
+    /* 读取3字节 (16-bit模式2字节) 角速度数据, 高字节在前 */
+    ret = XV7001bb_Read(dev, XV7_REG_RATE_READ, buf, (dev->rate_bits == 24) ? 3 : 2);
+    if (ret != XV7_OK)
+    {
+        return ret;
+    }
     
-    /* 符号扩展 (24-bit转32-bit) */
-    if (raw24 & 0x800000)
+    if (dev->rate_bits == 24)
     {
-        raw24 |= 0xFF000000;
+        if (XV7001bb_AllBytes(buf, 3, 0xFF) || XV7001bb_AllBytes(buf, 3, 0x00))
+        {
+            dev->fault = (buf[0] == 0xFF) ? XV7_FAULT_ONES : XV7_FAULT_ZEROS;
+            return XV7_ERR_DATA;
+        }
+        
+        /* 拼接24-bit原始数据 (大端序) */
+        raw24 = ((int32_t)buf[0] << 16) | ((int32_t)buf[1] << 8) | buf[2];
+        
+        /* 符号扩展 (24-bit转32-bit) */
+        if (raw24 & 0x800000)
+        {
+            raw24 |= 0xFF000000;
+        }
+    }
+    else
+    {
+        raw24 = (int32_t)(int16_t)(((uint16_t)buf[0] << 8) | buf[1]) * (1 << XV7_RATE_16BIT_SHIFT);
     }
     
+    ret = XV7001bb_CheckRate(dev, raw24);
+    if (ret != XV7_OK)
+    {
+        return ret;
+    }
     gyro->raw = raw24;
     
     /* 转换为 °/s */
@@ -192,35 +357,119 @@ XV7_Status XV7001bb_ReadAngle(XV7_GyroData *gyro)
     return XV7_OK;
 }
 
+/**
+ * @brief 写入一个寄存器并回读校验
+ */
+static XV7_Status XV7001bb_WriteVerify(XV7_Device *dev, uint8_t reg, uint8_t data)
+{
+    uint8_t readback;
+    XV7_Status ret;
+    
+    XV7001bb_WriteData(dev, reg, data);
+    ret = XV7001bb_ReadReg(dev, reg, &readback);
+    if (ret != XV7_OK)
+    {
+        return ret;
+    }
+    return (readback == data) ? XV7_OK : XV7_ERR_VERIFY;
+}
+
+/**
+ * @brief 写入DSP与输出格式配置
+ * 顺序: 输出格式 -> DSP_CTL1~3 -> 复位滤波器; 出错时仍执行后续步骤, 返回第一个错误
+ */
+XV7_Status XV7001bb_Configure(XV7_Device *dev, const XV7_Config *cfg)
+{
+    XV7_Status ret, first = XV7_OK;
+    uint8_t rate_ctrl;
+    
+    if (cfg == NULL || (cfg->rate_bits != 16 && cfg->rate_bits != 24))
+    {
+        return XV7_ERR_PARAM;
+    }
+    
+    ret = XV7001bb_WriteVerify(dev, XV7_REG_RATE_CTRL,
+                               (cfg->rate_bits == 24) ? XV7_RATE_CTRL_24BIT : XV7_RATE_CTRL_16BIT);
+    first = ret;
+    
+    /* 按传感器实际输出格式解码 (回读失败时保持原值) */
+    if (XV7001bb_ReadReg(dev, XV7_REG_RATE_CTRL, &rate_ctrl) == XV7_OK)
+    {
+        dev->rate_bits = (rate_ctrl & XV7_RATE_CTRL_24BIT) ? 24 : 16;
+    }
+    
+    ret = XV7001bb_WriteVerify(dev, XV7_REG_DSP_CTL1, cfg->dsp_ctl1);
+    first = (first != XV7_OK) ? first : ret;
+    ret = XV7001bb_WriteVerify(dev, XV7_REG_DSP_CTL2, cfg->dsp_ctl2);
+    first = (first != XV7_OK) ? first : ret;
+    ret = XV7001bb_WriteVerify(dev, XV7_REG_DSP_CTL3, cfg->dsp_ctl3);
+    first = (first != XV7_OK) ? first : ret;
+    
+    /* 新的滤波参数从复位状态开始 */
+    XV7001bb_WriteData(dev, XV7_REG_FILTER_RST, 0x00);
+    
+    return first;
+}
+
+/**
+ * @brief 回读当前DSP与输出格式配置
+ */
+XV7_Status XV7001bb_ReadConfig(XV7_Device *dev, XV7_Config *cfg)
+{
+    uint8_t rate_ctrl;
+    
+    if (cfg == NULL)
+    {
+        return XV7_ERR_SPI;
+    }
+    if (XV7001bb_ReadReg(dev, XV7_REG_DSP_CTL1, &cfg->dsp_ctl1) != XV7_OK ||
+        XV7001bb_ReadReg(dev, XV7_REG_DSP_CTL2, &cfg->dsp_ctl2) != XV7_OK ||
+        XV7001bb_ReadReg(dev, XV7_REG_DSP_CTL3, &cfg->dsp_ctl3) != XV7_OK ||
+        XV7001bb_ReadReg(dev, XV7_REG_RATE_CTRL, &rate_ctrl) != XV7_OK)
+    {
+        return XV7_ERR_SPI;
+    }
+    cfg->rate_bits = (rate_ctrl & XV7_RATE_CTRL_24BIT) ? 24 : 16;
+    return XV7_OK;
+}
+
+uint8_t XV7001bb_GetRateBits(const XV7_Device *dev)
+{
+    return dev->rate_bits;
+}
+
 /**
  * @brief 执行硬件零点校准
  * 注意: 调用时设备必须静止!
  */
-XV7_Status XV7001bb_ZeroCalibrate(void)
+XV7_Status XV7001bb_ZeroCalibrate(XV7_Device *dev)
 {
-    return XV7001bb_WriteData(XV7_REG_ZERO_CAL, 0x01);
+    return XV7001bb_WriteData(dev, XV7_REG_ZERO_CAL, 0x01);
 }
 
 /**
- * @brief 软件复位
+ * @brief 软件复位 (寄存器恢复默认, 角速度按24-bit解码)
  */
-XV7_Status XV7001bb_SoftReset(void)
+XV7_Status XV7001bb_SoftReset(XV7_Device *dev)
 {
-    return XV7001bb_WriteData(XV7_REG_SOFT_RST, 0x01);
+    dev->rate_bits = 24;
+    dev->check = 0;
+    dev->repeats = 0;
+    return XV7001bb_WriteData(dev, XV7_REG_SOFT_RST, 0x01);
 }
 
 /**
  * @brief 设置温度偏置
  */
-void XV7001bb_SetTempBias(float bias)
+void XV7001bb_SetTempBias(XV7_Device *dev, float bias)
 {
-    g_temp_bias = bias;
+    dev->temp_bias = bias;
 }
 
 /**
  * @brief 获取温度偏置
  */
-float XV7001bb_GetTempBias(void)
+float XV7001bb_GetTempBias(const XV7_Device *dev)
 {
-    return g_temp_bias;
+    return dev->temp_bias;
 }
@@ -39,6 +39,39 @@ extern "C" {
 #define XV7_STATE_STANDBY       0x02        /* 待机模式 */
 #define XV7_STATE_AFTER_POR     0x04        /* 上电复位后 */
 
+/*============================================================================
+ * 角速度输出控制 (RATE_CTRL) 与DSP配置
+ *
+ * DSP_CTL1~3决定传感器内部低通滤波 (带宽越低噪声越小、群延迟越大), 位定义
+ * 以数据手册为准, 驱动按原值写入并回读校验. 驱动不在启动时写这些寄存器,
+ * 未配置前按传感器默认值工作 (24-bit输出).
+ *
+ * 16-bit输出每次读角速度少传1字节 (SPI事务4→3字节), 分辨率为1/280°/s;
+ * 驱动将16-bit值乘256 (71680/280) 换算为24-bit LSB, 流水线与采集记录不变.
+ *============================================================================*/
+#define XV7_RATE_CTRL_16BIT     0x00    /* 16-bit角速度输出 */
+#define XV7_RATE_CTRL_24BIT     0x01    /* 24-bit角速度输出 (默认) */
+#define XV7_RATE_16BIT_SHIFT    8       /* 16-bit值换算为24-bit LSB的左移位数 */
+
+/*============================================================================
+ * 唤醒就绪查询 (上电后约数十ms就绪, 按退避间隔查询代替固定延时)
+ *============================================================================*/
+#define XV7_READY_TIMEOUT_MS    1000    /* 唤醒就绪超时 */
+#define XV7_READY_POLL_MIN_MS   1       /* 首次查询间隔 */
+#define XV7_READY_POLL_MAX_MS   8       /* 查询间隔上限 (倍增至此) */
+
+/*============================================================================
+ * SPI传输超时: 每字节的HAL超时, 一次事务在第一个出错的字节处中止
+ * SPI2为36MHz/256≈140kHz, 一个字节约57µs, 正常的2~4字节事务约115~230µs.
+ * HAL按节拍计数 (HAL_GetTick()-tickstart >= Timeout), 超时1只等到下一次SysTick,
+ * 字节传输中遇到SysTick (约6%的字节) 就误判超时; 取2保证至少等满1ms,
+ * 失败的事务最多约XV7_SPI_TIMEOUT_MS.
+ * 中止后先等当前字节移位完成并清除RXNE/OVR (最多XV7_SPI_DRAIN_US), 再拉高片选,
+ * 不会截断传感器正在移出的字节, 下一次事务也不会读到残留字节
+ *============================================================================*/
+#define XV7_SPI_TIMEOUT_MS      2
+#define XV7_SPI_DRAIN_US        120     /* 约两个字节时间 */
+
 /*============================================================================
  * 数据转换常量
  *============================================================================*/
@@ -50,11 +83,46 @@ extern "C" {
  *============================================================================*/
 typedef enum {
     XV7_OK = 0,
-    XV7_ERR_SPI,
+    XV7_ERR_SPI,            /* HAL传输错误/超时 */
     XV7_ERR_TIMEOUT,
-    XV7_ERR_NOT_READY
+    XV7_ERR_NOT_READY,
+    XV7_ERR_VERIFY,         /* 写入后回读不一致 */
+    XV7_ERR_PARAM,
+    XV7_ERR_DATA            /* 读数不合理 (分类见XV7_Device.fault) */
 } XV7_Status;
 
+/*============================================================================
+ * 读数故障检测
+ *
+ * 每次读取检查HAL返回值, 并按读数判断 (不合理的读数不写入输出结构体):
+ *   ONES   全部字节为0xFF (MISO悬空, 传感器断开或未上电); 角速度、状态 (状态码7
+ *          未定义)、温度 (低6位恒为0) 均检查
+ *   ZEROS  角速度全部字节为0x00 (MISO短路到地, 或传感器未工作)
+ *   STUCK  角速度连续XV7_FAULT_STUCK_READS次完全相同 (输出冻结); 24-bit输出带
+ *          数千LSB噪声, 正常时不会重复; 满量程饱和值不计. 只在24-bit输出时检查:
+ *          16-bit的1 LSB为256个24-bit LSB, DSP带宽较低时静止的正常读数可连续相同
+ *   JUMP   角速度与上次接受的读数相差超过XV7_FAULT_JUMP_DPS (按与上次读取的间隔
+ *          每10ms计一份, 最多4份; 超过5000°/s²的角加速度不是真实运动, 如位错误、
+ *          叠加的偏移). 一两个读数的一致不能作为确认: 偏移型故障的后续读数同样一致.
+ *          只有跳变后的读数彼此接近并持续XV7_FAULT_JUMP_PERSIST_MS, 才视为参考值
+ *          本身过时而接受新水平 (期间调用者已把传感器标记为FAILED)
+ * 16-bit输出时零附近的正常读数就是0x0000/0xFFFF, 不做ONES/ZEROS/STUCK检查 (断开
+ * 或冻结的传感器由状态寄存器发现, 多传感器时还有融合的不一致检查).
+ * 驱动只分类, 重试与计数由调用者决定 (见gyro_fusion.h).
+ *============================================================================*/
+#define XV7_FAULT_NONE          0
+#define XV7_FAULT_SPI           1
+#define XV7_FAULT_ONES          2
+#define XV7_FAULT_ZEROS         3
+#define XV7_FAULT_STUCK         4
+#define XV7_FAULT_JUMP          5
+#define XV7_FAULT_CLASSES       6       /* 含NONE */
+
+#define XV7_FAULT_STUCK_READS   10      /* 相同读数连续次数 → STUCK */
+#define XV7_FAULT_JUMP_DPS      50.0f   /* 相邻读数差上限 (°/s) */
+#define XV7_FAULT_JUMP_PERIOD_MS  10    /* 跳变门限的时间单位 (采样周期) */
+#define XV7_FAULT_JUMP_PERSIST_MS 1000  /* 跳变后的新水平持续该时长才接受 */
+
 /*============================================================================
  * 数据结构体
  *============================================================================*/
@@ -68,86 +136,148 @@ typedef struct {
 
 /* 角速度数据结构体 */
 typedef struct {
-    int32_t raw;            /* 原始24-bit值 (符号扩展后) */
+    int32_t raw;            /* 24-bit LSB (符号扩展后, 16-bit输出时已乘256) */
     float dps;              /* 角速度 (°/s) */
 } XV7_GyroData;
 
+/* DSP与输出格式配置 */
+typedef struct {
+    uint8_t dsp_ctl1;
+    uint8_t dsp_ctl2;
+    uint8_t dsp_ctl3;
+    uint8_t rate_bits;      /* 角速度输出位数: 16或24 */
+} XV7_Config;
+
 /* 温度数据结构体 */
 typedef struct {
     uint16_t raw;           /* 原始12-bit值 */
     float celsius;          /* 温度 (°C) */
 } XV7_TempData;
 
+/*============================================================================
+ * 设备句柄
+ *
+ * SPI2总线上可挂多个传感器 (见gyro_fusion.h), 每个传感器一个句柄: 独立的片选
+ * 引脚与解码状态. 句柄由使用者静态分配, 驱动不保存全局状态.
+ *============================================================================*/
+typedef struct {
+    GPIO_TypeDef *cs_port;  /* 片选 (低电平有效) */
+    uint16_t cs_pin;
+    uint8_t rate_bits;      /* 角速度解码位数 (与RATE_CTRL一致) */
+    float temp_bias;        /* 温度偏置 (°C) */
+    
+    /* 读数检查 (驱动维护, 唤醒/软件复位时清除) */
+    uint8_t fault;          /* 最近一次读取的故障分类 XV7_FAULT_* */
+    uint8_t check;          /* bit0=last_raw有效 bit1=跳变后的新水平待定 */
+    uint8_t repeats;        /* 与last_raw相同的连续读数 */
+    int32_t last_raw;       /* 最近一次接受的角速度 */
+    int32_t jump_raw;       /* 跳变后的最近读数 */
+    uint32_t jump_tick;     /* 新水平开始的时刻 (HAL_GetTick) */
+    uint32_t read_tick;     /* 最近一次角速度读取的时刻 (HAL_GetTick) */
+} XV7_Device;
+
+#define XV7_DEVICE_INIT(port, pin)  { (port), (pin), 24, 0.0f }
+
 /*============================================================================
  * 函数声明
  *============================================================================*/
 
 /**
- * @brief 初始化XV7001BB传感器
+ * @brief 初始化XV7001BB传感器: 发送唤醒命令后以退避间隔查询就绪 (HAL_Delay阻塞)
+ * @return XV7_OK=成功, XV7_ERR_TIMEOUT=XV7_READY_TIMEOUT_MS内未就绪
+ */
+XV7_Status XV7001bb_Init(XV7_Device *dev);
+
+/**
+ * @brief 发送唤醒命令 (不等待), 之后用XV7001bb_PollReady查询
  * @return XV7_OK=成功
  */
-XV7_Status XV7001bb_Init(void);
+XV7_Status XV7001bb_Wake(XV7_Device *dev);
+
+/**
+ * @brief 查询一次唤醒状态 (不等待), 唤醒命令未生效时重发
+ * @return XV7_OK=已就绪, XV7_ERR_NOT_READY=未就绪, XV7_ERR_SPI=读取失败
+ */
+XV7_Status XV7001bb_PollReady(XV7_Device *dev);
 
 /**
  * @brief 写入寄存器数据
  * @param reg 寄存器地址
  * @param data 要写入的数据
- * @return XV7_OK=成功
+ * @return XV7_OK=成功, XV7_ERR_SPI=传输失败
  */
-XV7_Status XV7001bb_WriteData(uint8_t reg, uint8_t data);
+XV7_Status XV7001bb_WriteData(XV7_Device *dev, uint8_t reg, uint8_t data);
 
 /**
- * @brief 读取寄存器数据
+ * @brief 读取寄存器数据 (不检查读数)
  * @param reg 寄存器地址
  * @param data 读取的数据指针
- * @return XV7_OK=成功
+ * @return XV7_OK=成功, XV7_ERR_SPI=传输失败
  */
-XV7_Status XV7001bb_ReadReg(uint8_t reg, uint8_t *data);
+XV7_Status XV7001bb_ReadReg(XV7_Device *dev, uint8_t reg, uint8_t *data);
 
 /**
  * @brief 读取温度数据
  * @param temp 温度数据结构体指针
- * @return XV7_OK=成功
+ * @return XV7_OK=成功, XV7_ERR_SPI=传输失败, XV7_ERR_DATA=全1
  */
-XV7_Status XV7001bb_ReadTmp(XV7_TempData *temp);
+XV7_Status XV7001bb_ReadTmp(XV7_Device *dev, XV7_TempData *temp);
 
 /**
  * @brief 读取角速度数据
  * @param gyro 角速度数据结构体指针
- * @return XV7_OK=成功
+ * @return XV7_OK=成功, XV7_ERR_SPI=传输失败, XV7_ERR_DATA=读数不合理 (dev->fault为分类)
  */
-XV7_Status XV7001bb_ReadAngle(XV7_GyroData *gyro);
+XV7_Status XV7001bb_ReadAngle(XV7_Device *dev, XV7_GyroData *gyro);
 
 /**
  * @brief 读取状态寄存器
  * @param status 状态结构体指针
+ * @return XV7_OK=成功, XV7_ERR_SPI=传输失败, XV7_ERR_DATA=全1
+ */
+XV7_Status XV7001bb_ReadStatus(XV7_Device *dev, XV7_StatusReg *status);
+
+/**
+ * @brief 写入DSP与输出格式配置, 逐个回读校验, 随后复位内部滤波器
+ * 回读不一致时按RATE_CTRL的实际值解码角速度, 保证读数与传感器输出一致
+ * @return XV7_OK=成功, XV7_ERR_VERIFY=回读不一致, XV7_ERR_PARAM=rate_bits不是16/24
+ */
+XV7_Status XV7001bb_Configure(XV7_Device *dev, const XV7_Config *cfg);
+
+/**
+ * @brief 回读当前DSP与输出格式配置
  * @return XV7_OK=成功
  */
-XV7_Status XV7001bb_ReadStatus(XV7_StatusReg *status);
+XV7_Status XV7001bb_ReadConfig(XV7_Device *dev, XV7_Config *cfg);
+
+/**
+ * @brief 当前角速度解码位数 (16或24)
+ */
+uint8_t XV7001bb_GetRateBits(const XV7_Device *dev);
 
 /**
  * @brief 执行硬件零点校准
  * @return XV7_OK=成功
  */
-XV7_Status XV7001bb_ZeroCalibrate(void);
+XV7_Status XV7001bb_ZeroCalibrate(XV7_Device *dev);
 
 /**
  * @brief 软件复位
  * @return XV7_OK=成功
  */
-XV7_Status XV7001bb_SoftReset(void);
+XV7_Status XV7001bb_SoftReset(XV7_Device *dev);
 
 /**
  * @brief 设置温度偏置
  * @param bias 偏置值 (°C)
  */
-void XV7001bb_SetTempBias(float bias);
+void XV7001bb_SetTempBias(XV7_Device *dev, float bias);
 
 /**
  * @brief 获取温度偏置
  * @return 当前偏置值 (°C)
  */
-float XV7001bb_GetTempBias(void);
+float XV7001bb_GetTempBias(const XV7_Device *dev);
 
 #ifdef __cplusplus
 }
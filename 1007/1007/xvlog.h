@@ -0,0 +1,188 @@
+#ifndef __XVLOG_H
+#define __XVLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gyro_pipeline.h"
+#include <string.h>
+
+/*============================================================================
+ * 采集记录格式 (.xvl)
+ * 
+ * 记录Task_Main每个周期的传感器读数和生效的命令, 主机回放工具以
+ * GyroPipeline重新计算, 用于复现现场漂移问题.
+ * 
+ * 每条记录固定8字节, 与采集流CAN帧 (ID=CAN_ID_CAPTURE) 的数据域相同,
+ * 记录文件 = 16字节文件头 + 按接收顺序排列的帧数据.
+ * 
+ * [0] bit7:6 记录类型, bit5:0 序号 (每条记录递增, 用于发现丢帧)
+ * 
+ * 样本 (XVLOG_TYPE_SAMPLE):
+ *   [1]   标志 XVLOG_FLAG_*
+ *   [2]   状态寄存器原始值
+ *   [3-5] 角速度原始值 24-bit有符号, 小端
+ *   [6-7] 温度原始值 uint16, 小端
+ * 
+ * 命令 (XVLOG_TYPE_COMMAND), 在下一条样本之前生效:
+ *   [1]   命令码 (CAN命令data[0])
+ *   [2-5] 参数 uint32, 小端 (0x03为float零偏)
+ *   [6-7] 角度清零命令的等待时间 (μs), uint16, 小端
+ * 
+ * 状态 (XVLOG_TYPE_STATE), 采集开始时输出一组, 使运行中途开始的记录也能回放:
+ *   [1]   字序号 0~GYRO_PIPELINE_STATE_WORDS-1 (GyroPipeline_SaveState)
+ *   [2-5] 值 uint32, 小端
+ *   [6-7] 保留
+ *============================================================================*/
+#define XVLOG_RECORD_SIZE       8
+#define XVLOG_VERSION           2
+#define XVLOG_MAGIC             "XV7LOG"
+
+/* 记录类型 */
+#define XVLOG_TYPE_SAMPLE       0
+#define XVLOG_TYPE_COMMAND      1
+#define XVLOG_TYPE_STATE        2
+
+#define XVLOG_TYPE_SHIFT        6
+#define XVLOG_SEQ_MASK          0x3F
+
+/* 样本标志 */
+#define XVLOG_FLAG_STATUS_OK    (1 << 0)
+#define XVLOG_FLAG_GYRO_OK      (1 << 1)
+#define XVLOG_FLAG_TEMP_OK      (1 << 2)
+
+/* 文件头 (16字节, 小端) */
+typedef struct {
+    char magic[6];              /* "XV7LOG" */
+    uint8_t version;
+    uint8_t record_size;
+    uint16_t period_ms;         /* 采样周期 */
+    uint16_t reserved;
+    uint32_t start_ms;          /* 第一条记录的接收时刻 (记录端时间, 仅供参考) */
+} XvLog_FileHeader;
+
+/**
+ * @brief 记录类型
+ */
+static inline uint8_t XvLog_Type(const uint8_t *rec)
+{
+    return rec[0] >> XVLOG_TYPE_SHIFT;
+}
+
+/**
+ * @brief 记录序号
+ */
+static inline uint8_t XvLog_Seq(const uint8_t *rec)
+{
+    return rec[0] & XVLOG_SEQ_MASK;
+}
+
+/**
+ * @brief 编码样本记录 (序号由发送端填写)
+ */
+static inline void XvLog_EncodeSample(uint8_t *rec, const GyroPipeline_Sample *s)
+{
+    rec[0] = (uint8_t)(XVLOG_TYPE_SAMPLE << XVLOG_TYPE_SHIFT);
+    rec[1] = (uint8_t)((s->status_ok ? XVLOG_FLAG_STATUS_OK : 0) |
+                       (s->gyro_ok ? XVLOG_FLAG_GYRO_OK : 0) |
+                       (s->temp_ok ? XVLOG_FLAG_TEMP_OK : 0));
+    rec[2] = s->status_raw;
+    rec[3] = (uint8_t)(s->gyro_raw & 0xFF);
+    rec[4] = (uint8_t)((s->gyro_raw >> 8) & 0xFF);
+    rec[5] = (uint8_t)((s->gyro_raw >> 16) & 0xFF);
+    rec[6] = (uint8_t)(s->temp_raw & 0xFF);
+    rec[7] = (uint8_t)(s->temp_raw >> 8);
+}
+
+/**
+ * @brief 解码样本记录
+ */
+static inline void XvLog_DecodeSample(const uint8_t *rec, GyroPipeline_Sample *s)
+{
+    int32_t raw = (int32_t)((uint32_t)rec[3] | ((uint32_t)rec[4] << 8) | ((uint32_t)rec[5] << 16));
+    
+    s->status_ok = (rec[1] & XVLOG_FLAG_STATUS_OK) != 0;
+    s->gyro_ok = (rec[1] & XVLOG_FLAG_GYRO_OK) != 0;
+    s->temp_ok = (rec[1] & XVLOG_FLAG_TEMP_OK) != 0;
+    s->status_raw = rec[2];
+    s->gyro_raw = (raw & 0x800000) ? (raw | (int32_t)0xFF000000) : raw;  /* 符号扩展 */
+    s->temp_raw = (uint16_t)(rec[6] | (rec[7] << 8));
+}
+
+/**
+ * @brief 编码命令记录
+ */
+static inline void XvLog_EncodeCommand(uint8_t *rec, uint8_t cmd, uint32_t arg, uint16_t pending_us)
+{
+    rec[0] = (uint8_t)(XVLOG_TYPE_COMMAND << XVLOG_TYPE_SHIFT);
+    rec[1] = cmd;
+    rec[2] = (uint8_t)(arg & 0xFF);
+    rec[3] = (uint8_t)((arg >> 8) & 0xFF);
+    rec[4] = (uint8_t)((arg >> 16) & 0xFF);
+    rec[5] = (uint8_t)(arg >> 24);
+    rec[6] = (uint8_t)(pending_us & 0xFF);
+    rec[7] = (uint8_t)(pending_us >> 8);
+}
+
+/**
+ * @brief 命令记录参数
+ */
+static inline uint32_t XvLog_CommandArg(const uint8_t *rec)
+{
+    return (uint32_t)rec[2] | ((uint32_t)rec[3] << 8) | ((uint32_t)rec[4] << 16) | ((uint32_t)rec[5] << 24);
+}
+
+/**
+ * @brief 命令记录中的等待时间 (μs)
+ */
+static inline uint16_t XvLog_CommandPendingUs(const uint8_t *rec)
+{
+    return (uint16_t)(rec[6] | (rec[7] << 8));
+}
+
+/**
+ * @brief 编码一个状态字
+ * @param index 字序号
+ */
+static inline void XvLog_EncodeState(uint8_t *rec, uint8_t index, uint32_t value)
+{
+    XvLog_EncodeCommand(rec, index, value, 0);
+    rec[0] = (uint8_t)(XVLOG_TYPE_STATE << XVLOG_TYPE_SHIFT);
+}
+
+/**
+ * @brief 将一条命令记录作用于流水线 (与Task_Main的命令处理一致)
+ * @return false=不影响流水线的命令
+ */
+static inline bool XvLog_ApplyCommand(GyroPipeline *p, const uint8_t *rec)
+{
+    uint32_t arg = XvLog_CommandArg(rec);
+    float bias;
+    
+    switch (rec[1])
+    {
+    case 0x01:
+    case 0x7B:
+        GyroPipeline_ResetAngle(p, XvLog_CommandPendingUs(rec));
+        return true;
+        
+    case 0x03:
+        memcpy(&bias, &arg, sizeof(float));
+        GyroPipeline_SetBias(p, bias);
+        return true;
+        
+    case 0x04:
+        GyroPipeline_StartCalibration(p);
+        return true;
+        
+    default:
+        return false;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __XVLOG_H */